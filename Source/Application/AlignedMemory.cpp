@@ -0,0 +1,165 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/AlignedMemory.h>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+#if defined(__linux__)
+	#include <sys/mman.h>
+	#define ALIGNED_MEMORY_MMAP
+#endif
+
+#if defined(_MSC_VER)
+	#include <malloc.h>
+#endif
+
+namespace
+{
+	std::atomic<bool> hugePages_{false};
+
+	void* AllocateAligned(std::size_t bytes)
+	{
+#if defined(_MSC_VER)
+		return _aligned_malloc(bytes ? bytes : 1, AlignedMemory::alignment);
+#else
+		void* memory{nullptr};
+		return posix_memalign(&memory, AlignedMemory::alignment, bytes ? bytes : 1) ? nullptr : memory;
+#endif
+	}
+
+	void FreeAligned(void* memory)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+#if defined(ALIGNED_MEMORY_MMAP)
+	bool MappedDirectly(std::size_t bytes)
+	{
+		return bytes >= AlignedMemory::hugePageSize;
+	}
+
+	std::size_t GetMappedSize(std::size_t bytes)
+	{
+		return (bytes + AlignedMemory::hugePageSize - 1) / AlignedMemory::hugePageSize * AlignedMemory::hugePageSize;
+	}
+
+	// Maps a huge page more than needed and unmaps either side of the huge page aligned part
+	void* MapAligned(std::size_t bytes)
+	{
+		auto mappedSize{GetMappedSize(bytes)};
+		auto mapping{mmap(nullptr, mappedSize + AlignedMemory::hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+		if(mapping == MAP_FAILED)
+		{
+			return nullptr;
+		}
+
+		auto mappingStart{reinterpret_cast<std::uintptr_t>(mapping)};
+		auto alignedStart{(mappingStart + AlignedMemory::hugePageSize - 1) / AlignedMemory::hugePageSize * AlignedMemory::hugePageSize};
+		auto mappingEnd{mappingStart + mappedSize + AlignedMemory::hugePageSize};
+
+		if(alignedStart > mappingStart)
+		{
+			munmap(mapping, alignedStart - mappingStart);
+		}
+
+		if(mappingEnd > alignedStart + mappedSize)
+		{
+			munmap(reinterpret_cast<void*>(alignedStart + mappedSize), mappingEnd - (alignedStart + mappedSize));
+		}
+
+		auto memory{reinterpret_cast<void*>(alignedStart)};
+
+	#if defined(MADV_HUGEPAGE)
+		if(hugePages_.load(std::memory_order_relaxed))
+		{
+			madvise(memory, mappedSize, MADV_HUGEPAGE);  // Only advice, so a kernel without THP is fine
+		}
+	#endif
+
+		return memory;
+	}
+#endif
+}
+
+void AlignedMemory::SetHugePages(bool hugePages)
+{
+	hugePages_.store(hugePages, std::memory_order_relaxed);
+}
+
+bool AlignedMemory::HugePagesEnabled()
+{
+	return hugePages_.load(std::memory_order_relaxed);
+}
+
+bool AlignedMemory::HugePagesSupported()
+{
+#if defined(ALIGNED_MEMORY_MMAP) && defined(MADV_HUGEPAGE)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void* AlignedMemory::Allocate(std::size_t bytes)
+{
+#if defined(ALIGNED_MEMORY_MMAP)
+	auto memory{MappedDirectly(bytes) ? MapAligned(bytes) : AllocateAligned(bytes)};
+#else
+	auto memory{AllocateAligned(bytes)};
+#endif
+
+	if(!memory)
+	{
+		throw std::bad_alloc{};
+	}
+
+	return memory;
+}
+
+void AlignedMemory::Free(void* memory, std::size_t bytes)
+{
+	if(!memory)
+	{
+		return;
+	}
+
+#if defined(ALIGNED_MEMORY_MMAP)
+	if(MappedDirectly(bytes))
+	{
+		munmap(memory, GetMappedSize(bytes));
+		return;
+	}
+#endif
+
+	FreeAligned(memory);
+}
@@ -0,0 +1,72 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Memory for large sample buffers.  Every allocation starts on a cache line (64 byte) boundary so SIMD 
+// loads never split a line.  On Linux, allocations of a huge page (2MB) or more are mapped directly and 
+// huge page aligned, and when huge pages are turned on they're advised to be backed by transparent huge 
+// pages, which cuts TLB misses when walking writer queues hundreds of MB long.  Elsewhere huge pages 
+// aren't supported and turning them on does nothing.
+namespace AlignedMemory
+{
+	const std::size_t alignment{64};
+	const std::size_t hugePageSize{2 * 1024 * 1024};
+
+	// Affects allocations made from then on.  Off by default.
+	void SetHugePages(bool hugePages);
+	bool HugePagesEnabled();
+	bool HugePagesSupported();
+
+	// Throws std::bad_alloc when out of memory.  Free must be given the same size Allocate was.
+	void* Allocate(std::size_t bytes);
+	void Free(void* memory, std::size_t bytes);
+
+	template<typename T>
+	class Allocator
+	{
+		public:
+			using value_type = T;
+
+			Allocator() = default;
+			template<typename U> Allocator(const Allocator<U>&) { }
+
+			T* allocate(std::size_t count) { return static_cast<T*>(Allocate(count * sizeof(T))); }
+			void deallocate(T* memory, std::size_t count) { Free(memory, count * sizeof(T)); }
+	};
+
+	template<typename T, typename U>
+	bool operator==(const Allocator<T>&, const Allocator<U>&) { return true; }
+
+	template<typename T, typename U>
+	bool operator!=(const Allocator<T>&, const Allocator<U>&) { return false; }
+
+	template<typename T>
+	using Vector = std::vector<T, Allocator<T>>;
+}
@@ -0,0 +1,216 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/AudioInput.h>
+#include <ThreadSafeAudioFile/Reader.h>
+#include <Utilities/Exception.h>
+#include <algorithm>
+
+std::vector<AudioData> AudioInput::ReadAudio(std::size_t startSample, std::size_t sampleCount)
+{
+	std::vector<AudioData> audioData;
+	for(std::size_t streamID{0}; streamID < GetChannels(); ++streamID)
+	{
+		audioData.push_back(ReadAudioStream(streamID, startSample, sampleCount));
+	}
+
+	return audioData;
+}
+
+AudioFileInput::AudioFileInput(const std::string& filename) : audioFileReader_{new ThreadSafeAudioFile::Reader{filename}} { }
+
+AudioFileInput::~AudioFileInput() { }
+
+std::size_t AudioFileInput::GetSampleRate()
+{
+	return audioFileReader_->GetSampleRate();
+}
+
+std::size_t AudioFileInput::GetChannels()
+{
+	return audioFileReader_->GetChannels();
+}
+
+std::size_t AudioFileInput::GetBitsPerSample()
+{
+	return audioFileReader_->GetBitsPerSample();
+}
+
+std::size_t AudioFileInput::GetSampleCount()
+{
+	return audioFileReader_->GetSampleCount();
+}
+
+AudioData AudioFileInput::ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount)
+{
+	return audioFileReader_->ReadAudioStream(streamID, startSample, sampleCount);
+}
+
+WaveFileInput::WaveFileInput(const std::string& filename) : file_{filename, std::ios::binary}
+{
+	if(!file_)
+	{
+		Utilities::ThrowException("Unable to open wave file", filename);
+	}
+
+	waveFormat_ = WaveFormat::Read(file_);
+}
+
+WaveFileInput::~WaveFileInput() { }
+
+std::size_t WaveFileInput::GetSampleRate()
+{
+	return waveFormat_.sampleRate_;
+}
+
+std::size_t WaveFileInput::GetChannels()
+{
+	return waveFormat_.channels_;
+}
+
+std::size_t WaveFileInput::GetBitsPerSample()
+{
+	return waveFormat_.bitsPerSample_;
+}
+
+std::size_t WaveFileInput::GetSampleCount()
+{
+	return static_cast<std::size_t>(waveFormat_.GetFrameCount());
+}
+
+const WaveFormat& WaveFileInput::GetWaveFormat() const
+{
+	return waveFormat_;
+}
+
+std::size_t WaveFileInput::ReadFrames(std::size_t startSample, std::size_t sampleCount)
+{
+	auto frameCount{GetSampleCount()};
+	auto start{std::min(startSample, frameCount)};
+	auto framesToRead{std::min(sampleCount, frameCount - start)};
+
+	frameBuffer_.resize(framesToRead * waveFormat_.GetBytesPerFrame());
+	if(framesToRead == 0)
+	{
+		return 0;
+	}
+
+	file_.clear();
+	file_.seekg(static_cast<std::streamoff>(waveFormat_.dataOffset_ + static_cast<uint64_t>(start) * waveFormat_.GetBytesPerFrame()));
+	if(!file_.read(reinterpret_cast<char*>(frameBuffer_.data()), static_cast<std::streamsize>(frameBuffer_.size())))
+	{
+		Utilities::ThrowException("Failed reading wave file data", startSample, sampleCount);
+	}
+
+	return framesToRead;
+}
+
+AudioData WaveFileInput::ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount)
+{
+	if(streamID >= GetChannels())
+	{
+		Utilities::ThrowException("Invalid stream ID given to WaveFileInput", streamID);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto framesRead{ReadFrames(startSample, sampleCount)};
+	std::vector<double> samples(framesRead);
+	waveFormat_.DecodeSamples(frameBuffer_.data() + streamID * waveFormat_.GetBytesPerSample(), framesRead, waveFormat_.channels_, samples.data());
+
+	return AudioData{std::move(samples)};
+}
+
+// Every channel is decoded from a single read of the interleaved frames
+std::vector<AudioData> WaveFileInput::ReadAudio(std::size_t startSample, std::size_t sampleCount)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto framesRead{ReadFrames(startSample, sampleCount)};
+
+	std::vector<AudioData> audioData;
+	for(std::size_t streamID{0}; streamID < waveFormat_.channels_; ++streamID)
+	{
+		std::vector<double> samples(framesRead);
+		waveFormat_.DecodeSamples(frameBuffer_.data() + streamID * waveFormat_.GetBytesPerSample(), framesRead, waveFormat_.channels_, samples.data());
+		audioData.push_back(AudioData{std::move(samples)});
+	}
+
+	return audioData;
+}
+
+AudioBufferInput::AudioBufferInput(const std::vector<std::vector<double>>& channels, std::size_t sampleRate, std::size_t bitsPerSample) : 
+	channels_{channels}, sampleRate_{sampleRate}, bitsPerSample_{bitsPerSample}
+{
+	if(channels_.empty())
+	{
+		Utilities::ThrowException("AudioBufferInput needs at least one channel");
+	}
+
+	for(const auto& channel : channels_)
+	{
+		if(channel.size() != channels_[0].size())
+		{
+			Utilities::ThrowException("AudioBufferInput channels differ in length", channel.size(), channels_[0].size());
+		}
+	}
+}
+
+AudioBufferInput::~AudioBufferInput() { }
+
+std::size_t AudioBufferInput::GetSampleRate()
+{
+	return sampleRate_;
+}
+
+std::size_t AudioBufferInput::GetChannels()
+{
+	return channels_.size();
+}
+
+std::size_t AudioBufferInput::GetBitsPerSample()
+{
+	return bitsPerSample_;
+}
+
+std::size_t AudioBufferInput::GetSampleCount()
+{
+	return channels_[0].size();
+}
+
+AudioData AudioBufferInput::ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount)
+{
+	if(streamID >= channels_.size())
+	{
+		Utilities::ThrowException("Invalid stream ID given to AudioBufferInput", streamID);
+	}
+
+	const auto& channel{channels_[streamID]};
+	auto start{std::min(startSample, channel.size())};
+	auto end{std::min(start + sampleCount, channel.size())};
+
+	return AudioData{std::vector<double>(channel.begin() + start, channel.begin() + end)};
+}
@@ -0,0 +1,129 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <AudioData/AudioData.h>
+#include <Application/WaveFormat.h>
+#include <Application/AlignedMemory.h>
+
+namespace ThreadSafeAudioFile
+{
+	class Reader;
+}
+
+// The audio a PhaseVocoderProcessor reads from.  Streams are channels (0 = left, 1 = right) and must be 
+// safe to read from concurrently.
+class AudioInput
+{
+	public:
+		virtual ~AudioInput() { }
+
+		virtual std::size_t GetSampleRate() = 0;
+		virtual std::size_t GetChannels() = 0;
+		virtual std::size_t GetBitsPerSample() = 0;
+		virtual std::size_t GetSampleCount() = 0;  // Per channel
+
+		virtual AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) = 0;
+
+		// Reads every stream at once (one AudioData per channel).  By default each stream is read in turn.
+		virtual std::vector<AudioData> ReadAudio(std::size_t startSample, std::size_t sampleCount);
+
+		// Whether ReadAudio decodes every stream in one pass, so it costs about the same as ReadAudioStream
+		virtual bool ReadsAudioInOnePass() { return false; }
+};
+
+// Reads a wave file
+class AudioFileInput : public AudioInput
+{
+	public:
+		AudioFileInput(const std::string& filename);
+		virtual ~AudioFileInput();
+
+		std::size_t GetSampleRate() override;
+		std::size_t GetChannels() override;
+		std::size_t GetBitsPerSample() override;
+		std::size_t GetSampleCount() override;
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override;
+
+	private:
+		std::unique_ptr<ThreadSafeAudioFile::Reader> audioFileReader_;
+};
+
+// Reads the wave files AudioFileInput can't: 24 and 32 bit integer, floating point, RF64 and more than 
+// two channels.  Only the frames asked for are read from disk.
+class WaveFileInput : public AudioInput
+{
+	public:
+		WaveFileInput(const std::string& filename);
+		virtual ~WaveFileInput();
+
+		std::size_t GetSampleRate() override;
+		std::size_t GetChannels() override;
+		std::size_t GetBitsPerSample() override;
+		std::size_t GetSampleCount() override;
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override;
+		std::vector<AudioData> ReadAudio(std::size_t startSample, std::size_t sampleCount) override;
+		bool ReadsAudioInOnePass() override { return true; }
+
+		const WaveFormat& GetWaveFormat() const;
+
+	private:
+		// Reads whole frames into frameBuffer_, returning how many were read
+		std::size_t ReadFrames(std::size_t startSample, std::size_t sampleCount);
+
+		WaveFormat waveFormat_;
+		std::mutex mutex_;
+		std::ifstream file_;
+		AlignedMemory::Vector<uint8_t> frameBuffer_;
+};
+
+// Reads audio already in memory, given as one vector of samples per channel
+class AudioBufferInput : public AudioInput
+{
+	public:
+		AudioBufferInput(const std::vector<std::vector<double>>& channels, std::size_t sampleRate, std::size_t bitsPerSample);
+		virtual ~AudioBufferInput();
+
+		std::size_t GetSampleRate() override;
+		std::size_t GetChannels() override;
+		std::size_t GetBitsPerSample() override;
+		std::size_t GetSampleCount() override;
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override;
+
+	private:
+		std::vector<std::vector<double>> channels_;
+		std::size_t sampleRate_;
+		std::size_t bitsPerSample_;
+};
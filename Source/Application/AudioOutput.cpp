@@ -0,0 +1,379 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/AudioOutput.h>
+#include <Application/Trace.h>
+#include <ThreadSafeAudioFile/Writer.h>
+#include <Utilities/Exception.h>
+#include <algorithm>
+#include <limits>
+#include <iterator>
+
+AudioFileOutput::AudioFileOutput(const std::string& filename, uint16_t channels, uint32_t sampleRate, uint16_t bitsPerSample) : 
+	audioFileWriter_{new ThreadSafeAudioFile::Writer{filename, channels, sampleRate, bitsPerSample}} { }
+
+AudioFileOutput::~AudioFileOutput() { }
+
+void AudioFileOutput::WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData)
+{
+	audioFileWriter_->WriteAudioStream(streamID, audioData);
+}
+
+std::size_t AudioFileOutput::GetMaxBufferedSamples()
+{
+	return audioFileWriter_->GetMaxBufferedSamples();
+}
+
+namespace
+{
+	// Header layout: RIFF header, a JUNK chunk the size of a ds64 chunk (so the file can become RF64 in 
+	// place), the fmt chunk and the data chunk header
+	const std::size_t ds64ChunkSize{28};
+	const uint32_t maxRiffSize{std::numeric_limits<uint32_t>::max()};
+
+	void AppendUInt16(std::vector<uint8_t>& data, uint16_t value)
+	{
+		data.push_back(static_cast<uint8_t>(value));
+		data.push_back(static_cast<uint8_t>(value >> 8));
+	}
+
+	void AppendUInt32(std::vector<uint8_t>& data, uint32_t value)
+	{
+		AppendUInt16(data, static_cast<uint16_t>(value));
+		AppendUInt16(data, static_cast<uint16_t>(value >> 16));
+	}
+
+	void AppendUInt64(std::vector<uint8_t>& data, uint64_t value)
+	{
+		AppendUInt32(data, static_cast<uint32_t>(value));
+		AppendUInt32(data, static_cast<uint32_t>(value >> 32));
+	}
+
+	void AppendID(std::vector<uint8_t>& data, const char* id)
+	{
+		data.insert(data.end(), id, id + 4);
+	}
+}
+
+WaveFileOutput::WaveFileOutput(const std::string& filename, std::size_t channels, std::size_t sampleRate, std::size_t bitsPerSample, 
+								WaveFormat::SampleFormat sampleFormat, bool alwaysRF64) : 
+	alwaysRF64_{alwaysRF64}, file_{filename, std::ios::binary | std::ios::trunc}, pending_(channels), pendingStart_(channels, 0), streamFinished_(channels, false)
+{
+	WaveFormat::CheckSupported(sampleFormat, bitsPerSample);
+	if(channels == 0 || channels > std::numeric_limits<uint16_t>::max())
+	{
+		Utilities::ThrowException("Invalid channel count for wave file", channels);
+	}
+
+	if(!file_)
+	{
+		Utilities::ThrowException("Unable to create wave file", filename);
+	}
+
+	waveFormat_.sampleFormat_ = sampleFormat;
+	waveFormat_.channels_ = channels;
+	waveFormat_.sampleRate_ = sampleRate;
+	waveFormat_.bitsPerSample_ = bitsPerSample;
+
+	WriteHeader();
+}
+
+WaveFileOutput::~WaveFileOutput()
+{
+	try
+	{
+		FinishFile();
+	}
+	catch(...) { }
+}
+
+void WaveFileOutput::WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData)
+{
+	if(streamID >= pending_.size())
+	{
+		Utilities::ThrowException("Invalid stream ID given to WaveFileOutput", streamID);
+	}
+
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	pending_[streamID].insert(pending_[streamID].end(), audioData.begin(), audioData.end());
+	if(memoryAccounting_)
+	{
+		memoryAccounting_->Add(MemoryAccounting::Stage::WRITER, streamID, audioData.size() * sizeof(double));
+	}
+
+	auto framesReady{PendingFrames(0)};
+	for(std::size_t otherStreamID{1}; otherStreamID < pending_.size(); ++otherStreamID)
+	{
+		framesReady = std::min(framesReady, PendingFrames(otherStreamID));
+	}
+
+	if(framesReady)
+	{
+		WriteFrames(framesReady);
+		framesWritten_.notify_all();
+	}
+
+	std::size_t samplesBuffered{0};
+	for(std::size_t bufferedStreamID{0}; bufferedStreamID < pending_.size(); ++bufferedStreamID)
+	{
+		samplesBuffered += PendingFrames(bufferedStreamID);
+	}
+
+	maxBufferedSamples_ = std::max(maxBufferedSamples_, samplesBuffered);
+
+	if(WaitForOtherStreams(streamID))
+	{
+		TraceSpan span{"Writer Wait", "writer", streamID};
+		framesWritten_.wait(lock, [&]{ return !WaitForOtherStreams(streamID); });
+	}
+}
+
+// Anything this stream has pending is waiting on a stream with nothing pending
+bool WaveFileOutput::WaitForOtherStreams(std::size_t streamID) const
+{
+	if(bufferLimit_ == 0 || PendingFrames(streamID) <= bufferLimit_)
+	{
+		return false;
+	}
+
+	for(std::size_t otherStreamID{0}; otherStreamID < pending_.size(); ++otherStreamID)
+	{
+		if(otherStreamID != streamID && !streamFinished_[otherStreamID] && PendingFrames(otherStreamID) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+std::size_t WaveFileOutput::PendingFrames(std::size_t streamID) const
+{
+	return pending_[streamID].size() - pendingStart_[streamID];
+}
+
+void WaveFileOutput::FinishStream(std::size_t streamID)
+{
+	if(streamID >= pending_.size())
+	{
+		Utilities::ThrowException("Invalid stream ID given to WaveFileOutput", streamID);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	streamFinished_[streamID] = true;
+	framesWritten_.notify_all();
+}
+
+void WaveFileOutput::SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	memoryAccounting_ = memoryAccounting;
+}
+
+void WaveFileOutput::SetBufferLimit(std::size_t bufferLimit)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	bufferLimit_ = bufferLimit;
+}
+
+std::size_t WaveFileOutput::GetMaxBufferedSamples()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return maxBufferedSamples_;
+}
+
+void WaveFileOutput::WriteHeader()
+{
+	auto extensible{waveFormat_.channels_ > 2};
+	auto floatingPoint{waveFormat_.sampleFormat_ == WaveFormat::SampleFormat::FLOATING_POINT};
+	uint16_t formatTag{static_cast<uint16_t>(floatingPoint ? 3 : 1)};
+
+	std::vector<uint8_t> header;
+	AppendID(header, "RIFF");
+	AppendUInt32(header, 0);  // Filled in by FinishFile
+	AppendID(header, "WAVE");
+
+	AppendID(header, "JUNK");
+	AppendUInt32(header, ds64ChunkSize);
+	header.resize(header.size() + ds64ChunkSize, 0);
+
+	AppendID(header, "fmt ");
+	AppendUInt32(header, extensible ? 40 : (floatingPoint ? 18 : 16));
+	AppendUInt16(header, extensible ? 0xFFFE : formatTag);
+	AppendUInt16(header, static_cast<uint16_t>(waveFormat_.channels_));
+	AppendUInt32(header, static_cast<uint32_t>(waveFormat_.sampleRate_));
+	AppendUInt32(header, static_cast<uint32_t>(waveFormat_.sampleRate_ * waveFormat_.GetBytesPerFrame()));
+	AppendUInt16(header, static_cast<uint16_t>(waveFormat_.GetBytesPerFrame()));
+	AppendUInt16(header, static_cast<uint16_t>(waveFormat_.bitsPerSample_));
+	if(extensible)
+	{
+		AppendUInt16(header, 22);
+		AppendUInt16(header, static_cast<uint16_t>(waveFormat_.bitsPerSample_));
+		AppendUInt32(header, 0);  // No speaker positions given
+		AppendUInt16(header, formatTag);
+		const uint8_t guidTail[]{0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+		header.insert(header.end(), std::begin(guidTail), std::end(guidTail));
+	}
+	else if(floatingPoint)
+	{
+		AppendUInt16(header, 0);
+	}
+
+	AppendID(header, "data");
+	AppendUInt32(header, 0);  // Filled in by FinishFile
+
+	waveFormat_.dataOffset_ = header.size();
+	file_.write(reinterpret_cast<const char*>(header.data()), header.size());
+}
+
+void WaveFileOutput::WriteFrames(std::size_t frameCount)
+{
+	TraceSpan span{"Write Frames", "writer", Trace::noStream, "frames", frameCount};
+
+	frameBuffer_.resize(frameCount * waveFormat_.GetBytesPerFrame());
+	for(std::size_t streamID{0}; streamID < pending_.size(); ++streamID)
+	{
+		auto& stream{pending_[streamID]};
+		auto& streamStart{pendingStart_[streamID]};
+		waveFormat_.EncodeSamples(stream.data() + streamStart, frameCount, waveFormat_.channels_, 
+									frameBuffer_.data() + streamID * waveFormat_.GetBytesPerSample());
+
+		// The written audio is only removed once it's at least half the buffer, so a stream that runs well 
+		// ahead of the others isn't moved down on every write
+		streamStart += frameCount;
+		if(streamStart * 2 >= stream.size())
+		{
+			stream.erase(stream.begin(), stream.begin() + streamStart);
+			streamStart = 0;
+		}
+
+		if(memoryAccounting_)
+		{
+			memoryAccounting_->Remove(MemoryAccounting::Stage::WRITER, streamID, frameCount * sizeof(double));
+		}
+	}
+
+	file_.write(reinterpret_cast<const char*>(frameBuffer_.data()), frameBuffer_.size());
+	if(!file_)
+	{
+		Utilities::ThrowException("Failed writing wave file data");
+	}
+
+	waveFormat_.dataSize_ += frameBuffer_.size();
+}
+
+// Streams which came up short are padded with silence so no audio already given is lost
+void WaveFileOutput::FinishFile()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::size_t framesLeft{0};
+	for(std::size_t streamID{0}; streamID < pending_.size(); ++streamID)
+	{
+		framesLeft = std::max(framesLeft, PendingFrames(streamID));
+	}
+
+	if(framesLeft)
+	{
+		for(std::size_t streamID{0}; streamID < pending_.size(); ++streamID)
+		{
+			if(memoryAccounting_)
+			{
+				memoryAccounting_->Add(MemoryAccounting::Stage::WRITER, streamID, (framesLeft - PendingFrames(streamID)) * sizeof(double));
+			}
+
+			pending_[streamID].resize(pendingStart_[streamID] + framesLeft, 0.0);
+		}
+
+		WriteFrames(framesLeft);
+	}
+
+	if(waveFormat_.dataSize_ & 1)
+	{
+		file_.put(0);
+	}
+
+	auto riffSize{waveFormat_.dataOffset_ - 8 + waveFormat_.dataSize_ + (waveFormat_.dataSize_ & 1)};
+	auto rf64{alwaysRF64_ || riffSize > maxRiffSize};
+
+	std::vector<uint8_t> field;
+	if(rf64)
+	{
+		AppendID(field, "RF64");
+		AppendUInt32(field, maxRiffSize);
+		file_.seekp(0);
+		file_.write(reinterpret_cast<const char*>(field.data()), field.size());
+
+		field.clear();
+		AppendID(field, "ds64");
+		AppendUInt32(field, ds64ChunkSize);
+		AppendUInt64(field, riffSize);
+		AppendUInt64(field, waveFormat_.dataSize_);
+		AppendUInt64(field, waveFormat_.GetFrameCount());
+		AppendUInt32(field, 0);  // No table entries
+		file_.seekp(12);
+		file_.write(reinterpret_cast<const char*>(field.data()), field.size());
+	}
+	else
+	{
+		field.clear();
+		AppendUInt32(field, static_cast<uint32_t>(riffSize));
+		file_.seekp(4);
+		file_.write(reinterpret_cast<const char*>(field.data()), field.size());
+	}
+
+	field.clear();
+	AppendUInt32(field, rf64 ? maxRiffSize : static_cast<uint32_t>(waveFormat_.dataSize_));
+	file_.seekp(static_cast<std::streamoff>(waveFormat_.dataOffset_ - 4));
+	file_.write(reinterpret_cast<const char*>(field.data()), field.size());
+
+	file_.close();
+}
+
+AudioBufferOutput::AudioBufferOutput(std::size_t channels) : channels_(channels) { }
+
+AudioBufferOutput::~AudioBufferOutput() { }
+
+void AudioBufferOutput::WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData)
+{
+	if(streamID >= channels_.size())
+	{
+		Utilities::ThrowException("Invalid stream ID given to AudioBufferOutput", streamID);
+	}
+
+	channels_[streamID].insert(channels_[streamID].end(), audioData.begin(), audioData.end());
+}
+
+std::size_t AudioBufferOutput::GetMaxBufferedSamples()
+{
+	return 0;
+}
+
+const std::vector<std::vector<double>>& AudioBufferOutput::GetChannels() const
+{
+	return channels_;
+}
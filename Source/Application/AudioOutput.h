@@ -0,0 +1,138 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <Application/WaveFormat.h>
+#include <Application/MemoryAccounting.h>
+#include <Application/AlignedMemory.h>
+
+namespace ThreadSafeAudioFile
+{
+	class Writer;
+}
+
+// Where a PhaseVocoderProcessor writes its output.  Streams are channels (0 = left, 1 = right) and may be 
+// written to concurrently.
+class AudioOutput
+{
+	public:
+		virtual ~AudioOutput() { }
+
+		virtual void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) = 0;
+
+		virtual std::size_t GetMaxBufferedSamples() = 0;  // High water mark for stereo data buffered
+
+		// Called once a stream has written all of its audio
+		virtual void FinishStream(std::size_t /*streamID*/) { }
+};
+
+// Writes a wave file
+class AudioFileOutput : public AudioOutput
+{
+	public:
+		AudioFileOutput(const std::string& filename, uint16_t channels, uint32_t sampleRate, uint16_t bitsPerSample);
+		virtual ~AudioFileOutput();
+
+		void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) override;
+
+		std::size_t GetMaxBufferedSamples() override;
+
+	private:
+		std::unique_ptr<ThreadSafeAudioFile::Writer> audioFileWriter_;
+};
+
+// Writes the wave files AudioFileOutput can't: 24 and 32 bit integer, floating point and more than two 
+// channels.  Streams are interleaved and written out as soon as every stream has audio for a frame, so 
+// only the difference between the streams is buffered.  The file becomes RF64 once it passes 4GB (or 
+// always, if asked).  The header is finished when the object is destroyed.
+//
+// Optionally the buffering can be bounded: a stream more than the given number of samples ahead of 
+// another (unfinished) stream waits in WriteAudioStream until the other catches up.
+class WaveFileOutput : public AudioOutput
+{
+	public:
+		WaveFileOutput(const std::string& filename, std::size_t channels, std::size_t sampleRate, std::size_t bitsPerSample, 
+						WaveFormat::SampleFormat sampleFormat, bool alwaysRF64 = false);
+		virtual ~WaveFileOutput();
+
+		void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) override;
+
+		std::size_t GetMaxBufferedSamples() override;
+
+		void FinishStream(std::size_t streamID) override;
+
+		// Per stream.  Zero (the default) leaves the buffering unbounded.
+		void SetBufferLimit(std::size_t bufferLimit);
+
+		// Optional.  Buffered audio is recorded as writer memory.
+		void SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting);
+
+	private:
+		bool WaitForOtherStreams(std::size_t streamID) const;
+		std::size_t PendingFrames(std::size_t streamID) const;
+		void WriteHeader();
+		void WriteFrames(std::size_t frameCount);
+		void FinishFile();
+
+		WaveFormat waveFormat_;
+		bool alwaysRF64_;
+		std::mutex mutex_;
+		std::ofstream file_;
+		std::condition_variable framesWritten_;
+		std::vector<AlignedMemory::Vector<double>> pending_;  // Audio not yet written, per stream
+		std::vector<std::size_t> pendingStart_;  // Where the unwritten audio starts in pending_, per stream
+		std::vector<bool> streamFinished_;
+		std::size_t bufferLimit_{0};
+		std::shared_ptr<MemoryAccounting> memoryAccounting_;
+		AlignedMemory::Vector<uint8_t> frameBuffer_;
+		std::size_t maxBufferedSamples_{0};
+};
+
+// Collects the output in memory, one vector of samples per channel
+class AudioBufferOutput : public AudioOutput
+{
+	public:
+		AudioBufferOutput(std::size_t channels);
+		virtual ~AudioBufferOutput();
+
+		void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) override;
+
+		std::size_t GetMaxBufferedSamples() override;
+
+		// Channels may differ slightly in length.  Call once processing is finished.
+		const std::vector<std::vector<double>>& GetChannels() const;
+
+	private:
+		std::vector<std::vector<double>> channels_;  // Each stream only touches its own vector, so no locking is needed
+};
@@ -0,0 +1,181 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/CachingAudioInput.h>
+#include <Application/Trace.h>
+#include <Utilities/Exception.h>
+#include <algorithm>
+
+CachingAudioInput::CachingAudioInput(std::shared_ptr<AudioInput> audioInput, std::size_t maxBlocks, std::size_t blockSize) : 
+	audioInput_{audioInput}, maxBlocks_{std::max<std::size_t>(maxBlocks, 1)}, blockSize_{std::max<std::size_t>(blockSize, 1)} { }
+
+CachingAudioInput::~CachingAudioInput() { }
+
+std::size_t CachingAudioInput::GetSampleRate()
+{
+	return audioInput_->GetSampleRate();
+}
+
+std::size_t CachingAudioInput::GetChannels()
+{
+	return audioInput_->GetChannels();
+}
+
+std::size_t CachingAudioInput::GetBitsPerSample()
+{
+	return audioInput_->GetBitsPerSample();
+}
+
+std::size_t CachingAudioInput::GetSampleCount()
+{
+	return audioInput_->GetSampleCount();
+}
+
+std::size_t CachingAudioInput::GetBlocksRead()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return blocksRead_;
+}
+
+std::size_t CachingAudioInput::GetCacheHits()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return cacheHits_;
+}
+
+AudioData CachingAudioInput::ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount)
+{
+	if(streamID >= GetChannels())
+	{
+		Utilities::ThrowException("Invalid stream ID given to CachingAudioInput", streamID);
+	}
+
+	auto endSample{std::min(startSample + sampleCount, GetSampleCount())};
+
+	AudioData audioData;
+	for(auto position{startSample}; position < endSample; )
+	{
+		auto block{position / blockSize_};
+		auto blockData{GetBlock(block)};
+		const auto& samples{(*blockData)[streamID].GetData()};
+
+		auto offset{position - block * blockSize_};
+		auto samplesToCopy{std::min(endSample - position, samples.size() - offset)};
+		audioData.Append(std::vector<double>(samples.begin() + offset, samples.begin() + offset + samplesToCopy));
+
+		position += samplesToCopy;
+	}
+
+	return audioData;
+}
+
+// If another stream is already reading the block, we wait for it rather than reading it again
+std::shared_ptr<const CachingAudioInput::Block> CachingAudioInput::GetBlock(std::size_t block)
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		blockRead_.wait(lock, [&]{ return blocksInFlight_.count(block) == 0; });
+
+		auto element{blocks_.find(block)};
+		if(element != blocks_.end())
+		{
+			leastRecentlyUsed_.splice(leastRecentlyUsed_.begin(), leastRecentlyUsed_, element->second.second);
+			++cacheHits_;
+			return element->second.first;
+		}
+
+		blocksInFlight_.insert(block);
+	}
+
+	std::shared_ptr<const Block> blockData;
+	try
+	{
+		TraceSpan span{"Read Block", "reader", Trace::noStream, "block", block};
+		blockData = std::make_shared<const Block>(audioInput_->ReadAudio(block * blockSize_, blockSize_));
+	}
+	catch(...)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			blocksInFlight_.erase(block);
+		}
+
+		blockRead_.notify_all();
+		throw;
+	}
+
+	AddBlock(block, blockData);
+	blockRead_.notify_all();
+
+	return blockData;
+}
+
+void CachingAudioInput::AddBlock(std::size_t block, std::shared_ptr<const Block> blockData)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	blocksInFlight_.erase(block);
+	++blocksRead_;
+
+	if(blocks_.size() >= maxBlocks_)
+	{
+		RecordBlock(*blocks_[leastRecentlyUsed_.back()].first, false);
+		blocks_.erase(leastRecentlyUsed_.back());
+		leastRecentlyUsed_.pop_back();
+	}
+
+	leastRecentlyUsed_.push_front(block);
+	blocks_[block] = std::make_pair(blockData, leastRecentlyUsed_.begin());
+	RecordBlock(*blockData, true);
+}
+
+void CachingAudioInput::SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	memoryAccounting_ = memoryAccounting;
+}
+
+// Called with the mutex held
+void CachingAudioInput::RecordBlock(const Block& blockData, bool added)
+{
+	if(!memoryAccounting_)
+	{
+		return;
+	}
+
+	for(std::size_t streamID{0}; streamID < blockData.size(); ++streamID)
+	{
+		auto bytes{blockData[streamID].GetSize() * sizeof(double)};
+		if(added)
+		{
+			memoryAccounting_->Add(MemoryAccounting::Stage::READER, streamID, bytes);
+		}
+		else
+		{
+			memoryAccounting_->Remove(MemoryAccounting::Stage::READER, streamID, bytes);
+		}
+	}
+}
@@ -0,0 +1,87 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <list>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <Application/AudioInput.h>
+#include <Application/MemoryAccounting.h>
+
+// Wraps another AudioInput with a block cache shared by all streams.  A block missing from the cache is 
+// read for every channel at once, so when the channels are processed in parallel (and when transient 
+// detection and processing make their passes over a short input) each block is only read once.  This only 
+// pays off for inputs whose ReadAudio decodes every channel in one pass (see ReadsAudioInOnePass).
+//
+// The least recently used block is dropped once the cache is full.  Blocks are reference counted so a 
+// block being copied from stays valid even if it's dropped meanwhile.
+class CachingAudioInput : public AudioInput
+{
+	public:
+		CachingAudioInput(std::shared_ptr<AudioInput> audioInput, std::size_t maxBlocks, std::size_t blockSize = 8192);
+		virtual ~CachingAudioInput();
+
+		std::size_t GetSampleRate() override;
+		std::size_t GetChannels() override;
+		std::size_t GetBitsPerSample() override;
+		std::size_t GetSampleCount() override;
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override;
+
+		std::size_t GetBlocksRead();  // Blocks read from the wrapped input
+		std::size_t GetCacheHits();   // Block lookups served from the cache
+
+		// Optional.  Cached blocks are recorded as reader memory.
+		void SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting);
+
+	private:
+		using Block = std::vector<AudioData>;  // One AudioData per channel
+
+		std::shared_ptr<const Block> GetBlock(std::size_t block);
+		void AddBlock(std::size_t block, std::shared_ptr<const Block> blockData);
+		void RecordBlock(const Block& blockData, bool added);
+
+		std::shared_ptr<AudioInput> audioInput_;
+		std::size_t maxBlocks_;
+		std::size_t blockSize_;
+
+		std::map<std::size_t, std::pair<std::shared_ptr<const Block>, std::list<std::size_t>::iterator>> blocks_;
+		std::list<std::size_t> leastRecentlyUsed_;  // Most recently used at the front
+		std::set<std::size_t> blocksInFlight_;
+
+		std::size_t blocksRead_{0};
+		std::size_t cacheHits_{0};
+
+		std::shared_ptr<MemoryAccounting> memoryAccounting_;
+
+		std::mutex mutex_;
+		std::condition_variable blockRead_;
+};
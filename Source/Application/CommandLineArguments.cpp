@@ -26,9 +26,12 @@
 
 #include <string>
 #include <Application/CommandLineArguments.h>
+#include <Application/CpuTier.h>
+#include <Application/PhaseVocoderMediator.h>
 #include <Utilities/Stringify.h>
 #include <Utilities/Exception.h>
 #include <cstdlib>
+#include <set>
 
 CommandLineArguments::CommandLineArguments(int argc, char** argv)
 {
@@ -38,8 +41,24 @@ CommandLineArguments::CommandLineArguments(int argc, char** argv)
 	possibleArguments_["--stretch"] = ArgumentTraits{"-s", true, true};
 	possibleArguments_["--pitch"] = ArgumentTraits{"-p", true, true};
 	possibleArguments_["--resample"] = ArgumentTraits{"-r", true, true};
+	possibleArguments_["--incremental"] = ArgumentTraits{"-n", false, false};
 	possibleArguments_["--showtransients"] = ArgumentTraits{"-t", false, false};
 	possibleArguments_["--transientconfig"] = ArgumentTraits{"-c", true, true};
+	possibleArguments_["--start"] = ArgumentTraits{"-b", true, true};
+	possibleArguments_["--end"] = ArgumentTraits{"-e", true, true};
+	possibleArguments_["--quality"] = ArgumentTraits{"-q", true, true};
+	possibleArguments_["--transientcache"] = ArgumentTraits{"-d", true, true};
+	possibleArguments_["--prefetch"] = ArgumentTraits{"-f", true, true};
+	possibleArguments_["--maxmemory"] = ArgumentTraits{"-m", true, true};
+	possibleArguments_["--minsection"] = ArgumentTraits{"-y", true, true};
+	possibleArguments_["--memoryreport"] = ArgumentTraits{"-u", true, true};
+	possibleArguments_["--trace"] = ArgumentTraits{"-g", true, true};
+	possibleArguments_["--progress"] = ArgumentTraits{"-k", false, false};
+	possibleArguments_["--status"] = ArgumentTraits{"-z", true, true};
+	possibleArguments_["--cputier"] = ArgumentTraits{"-j", true, true};
+	possibleArguments_["--hugepages"] = ArgumentTraits{"-H", false, false};
+	possibleArguments_["--server"] = ArgumentTraits{"-x", true, true};
+	possibleArguments_["--workers"] = ArgumentTraits{"-w", true, true};
 	possibleArguments_["--valleypeakratio"] = ArgumentTraits{"-a", true, true};
 	possibleArguments_["--longhelp"] = ArgumentTraits{"-l", false, false};
 	possibleArguments_["--version"] = ArgumentTraits{"-v", false, false};
@@ -151,6 +170,161 @@ bool CommandLineArguments::ResampleSettingGiven() const
 	return true;
 }
 
+bool CommandLineArguments::QualityPresetGiven() const
+{
+	auto element = argumentsGiven_.find("--quality");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ReadAheadGiven() const
+{
+	auto element = argumentsGiven_.find("--prefetch");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+std::size_t CommandLineArguments::GetReadAheadBlocks() const
+{
+	auto element = argumentsGiven_.find("--prefetch");
+	if(element == argumentsGiven_.end())
+	{
+		return 0;
+	}
+
+	return atoi(element->second.c_str());
+}
+
+bool CommandLineArguments::MaxMemoryGiven() const
+{
+	auto element = argumentsGiven_.find("--maxmemory");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+std::size_t CommandLineArguments::GetMaxMemory() const
+{
+	auto element = argumentsGiven_.find("--maxmemory");
+	if(element == argumentsGiven_.end())
+	{
+		return 0;
+	}
+
+	return atoi(element->second.c_str());
+}
+
+bool CommandLineArguments::MinSectionLengthGiven() const
+{
+	auto element = argumentsGiven_.find("--minsection");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+std::size_t CommandLineArguments::GetMinSectionLength() const
+{
+	auto element = argumentsGiven_.find("--minsection");
+	if(element == argumentsGiven_.end())
+	{
+		return 0;
+	}
+
+	return atoi(element->second.c_str());
+}
+
+bool CommandLineArguments::RangeStartGiven() const
+{
+	auto element = argumentsGiven_.find("--start");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+double CommandLineArguments::GetRangeStart() const
+{
+	double position{0.0};
+	bool inSeconds{false};
+
+	auto element = argumentsGiven_.find("--start");
+	if(element == argumentsGiven_.end() || !ParsePosition(element->second, position, inSeconds))
+	{
+		return 0.0;
+	}
+
+	return position;
+}
+
+bool CommandLineArguments::RangeStartInSeconds() const
+{
+	double position{0.0};
+	bool inSeconds{false};
+
+	auto element = argumentsGiven_.find("--start");
+	if(element == argumentsGiven_.end() || !ParsePosition(element->second, position, inSeconds))
+	{
+		return false;
+	}
+
+	return inSeconds;
+}
+
+bool CommandLineArguments::RangeEndGiven() const
+{
+	auto element = argumentsGiven_.find("--end");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+double CommandLineArguments::GetRangeEnd() const
+{
+	double position{0.0};
+	bool inSeconds{false};
+
+	auto element = argumentsGiven_.find("--end");
+	if(element == argumentsGiven_.end() || !ParsePosition(element->second, position, inSeconds))
+	{
+		return 0.0;
+	}
+
+	return position;
+}
+
+bool CommandLineArguments::RangeEndInSeconds() const
+{
+	double position{0.0};
+	bool inSeconds{false};
+
+	auto element = argumentsGiven_.find("--end");
+	if(element == argumentsGiven_.end() || !ParsePosition(element->second, position, inSeconds))
+	{
+		return false;
+	}
+
+	return inSeconds;
+}
+
 bool CommandLineArguments::ValleyPeakRatioGiven() const
 {
 	auto element = argumentsGiven_.find("--valleypeakratio");
@@ -175,6 +349,16 @@ void CommandLineArguments::ValidateArguments()
 		return;
 	}
 
+	if(ServerSocketGiven())
+	{
+		if(!ValidateWorkerCount())
+		{
+			valid_ = false;
+		}
+
+		return;
+	}
+
 	if(!InputFilenameGiven())
 	{
 		valid_ = false;		
@@ -189,7 +373,7 @@ void CommandLineArguments::ValidateArguments()
 		return;
 	}
 
-	if(!ValidateStretchSetting() || !ValidatePitchSetting() || !ValidateResampleSetting())
+	if(!ValidateStretchSetting() || !ValidatePitchSetting() || !ValidateResampleSetting() || !ValidateValleyPeakRatio() || !ValidateQualityPreset() || !ValidateRenderRange() || !ValidateReadAhead() || !ValidateMaxMemory() || !ValidateMinSectionLength() || !ValidateStatusInterval() || !ValidateCpuTier())
 	{
 		valid_ = false;
 		return;
@@ -214,12 +398,38 @@ bool CommandLineArguments::ValidateStretchSetting()
 	}
 	else if(element != argumentsGiven_.end())
 	{
-		auto stretchFactor{atof(element->second.c_str())};
-		if(stretchFactor < minimumStretchFactor_ || stretchFactor > maximumStretchFactor_)
+		auto stretchFactors{GetStretchFactors()};
+		for(auto stretchFactor : stretchFactors)
+		{
+			auto error{PhaseVocoderSettings::ValidateStretchFactor(stretchFactor)};
+			if(!error.empty())
+			{
+				errorMessage_ = error;
+				return false;
+			}
+		}
+
+		if(stretchFactors.size() > 1 && GetOutputFilename().find("%s") == std::string::npos)
 		{
-			errorMessage_ = Utilities::CreateString(" ", "Given stretch factor out of range.  Min:", minimumStretchFactor_, " Max:", maximumStretchFactor_);
+			errorMessage_ = "Multiple stretch factors given, but output filename has no %s placeholder.";
 			return false;
 		}
+
+		// Factors like 1.1 and 1.10 name the same file, which two writers would then both write
+		std::set<std::string> outputFilenames;
+		for(auto stretchFactor : stretchFactors)
+		{
+			if(stretchFactors.size() == 1)
+			{
+				break;
+			}
+
+			if(!outputFilenames.insert(PhaseVocoderMediator::GetOutputFilenameForStretchFactor(GetOutputFilename(), stretchFactor)).second)
+			{
+				errorMessage_ = "The same stretch factor was given more than once.";
+				return false;
+			}
+		}
 	}
 
 	return true;
@@ -237,9 +447,10 @@ bool CommandLineArguments::ValidatePitchSetting()
 	else if(element != argumentsGiven_.end())
 	{
 		auto pitchSetting{atof(element->second.c_str())};
-		if(pitchSetting < minimumPitchShift_ || pitchSetting > maximumPitchShift_)
+		auto error{PhaseVocoderSettings::ValidatePitchShiftValue(pitchSetting)};
+		if(!error.empty())
 		{
-			errorMessage_ = Utilities::CreateString(" ", "Given pitch setting out of range.  Min:", minimumPitchShift_, " Max:", maximumPitchShift_);
+			errorMessage_ = error;
 			return false;
 		}
 	}
@@ -259,9 +470,123 @@ bool CommandLineArguments::ValidateResampleSetting()
 	else if(element != argumentsGiven_.end())
 	{
 		auto resampleSetting{atof(element->second.c_str())};
-		if(resampleSetting < minimumResampleFrequency_ || resampleSetting > maximumResampleFrequency_)
+		auto error{PhaseVocoderSettings::ValidateResampleValue(resampleSetting)};
+		if(!error.empty())
+		{
+			errorMessage_ = error;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateValleyPeakRatio()
+{
+	if(ValleyPeakRatioGiven())
+	{
+		auto error{PhaseVocoderSettings::ValidateValleyToPeakRatio(GetValleyPeakRatio())};
+		if(!error.empty())
+		{
+			errorMessage_ = error;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateMaxMemory()
+{
+	auto element = argumentsGiven_.find("--maxmemory");
+	if(element != argumentsGiven_.end())
+	{
+		auto maxMemory{atoi(element->second.c_str())};
+		if(maxMemory < static_cast<int>(minimumMaxMemory_) || maxMemory > static_cast<int>(maximumMaxMemory_))
+		{
+			errorMessage_ = Utilities::CreateString(" ", "Given max memory (in MB) out of range.  Min:", minimumMaxMemory_, " Max:", maximumMaxMemory_);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateMinSectionLength()
+{
+	auto element = argumentsGiven_.find("--minsection");
+	if(element != argumentsGiven_.end())
+	{
+		auto minSectionLength{atoi(element->second.c_str())};
+		if(minSectionLength < static_cast<int>(minimumMinSectionLength_) || minSectionLength > static_cast<int>(maximumMinSectionLength_))
+		{
+			errorMessage_ = Utilities::CreateString(" ", "Given minimum section length (in ms) out of range.  Min:", minimumMinSectionLength_, " Max:", maximumMinSectionLength_);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateStatusInterval()
+{
+	auto element = argumentsGiven_.find("--status");
+	if(element != argumentsGiven_.end())
+	{
+		auto statusInterval{atof(element->second.c_str())};
+		if(statusInterval < minimumStatusInterval_ || statusInterval > maximumStatusInterval_)
+		{
+			errorMessage_ = Utilities::CreateString(" ", "Given status interval (in seconds) out of range.  Min:", minimumStatusInterval_, " Max:", maximumStatusInterval_);
+			return false;
+		}
+
+		if(ShowProgress())
+		{
+			errorMessage_ = "Progress and status can't both be given.";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateCpuTier()
+{
+	CpuTier::Tier tier;
+	if(CpuTierGiven() && !CpuTier::ParseTierName(GetCpuTier(), tier))
+	{
+		errorMessage_ = "Given CPU tier not recognized.  Use baseline, avx2 or avx512.";
+		return false;
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateReadAhead()
+{
+	auto element = argumentsGiven_.find("--prefetch");
+	if(element != argumentsGiven_.end())
+	{
+		auto readAheadBlocks{atoi(element->second.c_str())};
+		if(readAheadBlocks < static_cast<int>(minimumReadAheadBlocks_) || readAheadBlocks > static_cast<int>(maximumReadAheadBlocks_))
+		{
+			errorMessage_ = Utilities::CreateString(" ", "Given prefetch block count out of range.  Min:", minimumReadAheadBlocks_, " Max:", maximumReadAheadBlocks_);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateWorkerCount()
+{
+	auto element = argumentsGiven_.find("--workers");
+	if(element != argumentsGiven_.end())
+	{
+		auto workerCount{atoi(element->second.c_str())};
+		if(workerCount < static_cast<int>(minimumWorkerCount_) || workerCount > static_cast<int>(maximumWorkerCount_))
 		{
-			errorMessage_ = Utilities::CreateString(" ", "Given resample setting out of range.  Min:", minimumResampleFrequency_, " Max:", maximumResampleFrequency_);
+			errorMessage_ = Utilities::CreateString(" ", "Given worker count out of range.  Min:", minimumWorkerCount_, " Max:", maximumWorkerCount_);
 			return false;
 		}
 	}
@@ -269,6 +594,79 @@ bool CommandLineArguments::ValidateResampleSetting()
 	return true;
 }
 
+bool CommandLineArguments::ValidateQualityPreset()
+{
+	if(!QualityPresetGiven())
+	{
+		return true;
+	}
+
+	auto qualityPreset{GetQualityPreset()};
+	if(qualityPreset != "high" && qualityPreset != "medium" && qualityPreset != "draft")
+	{
+		errorMessage_ = "Given quality setting is invalid.  Must be high, medium or draft.";
+		return false;
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::ValidateRenderRange()
+{
+	double position{0.0};
+	bool inSeconds{false};
+
+	auto start = argumentsGiven_.find("--start");
+	if(start != argumentsGiven_.end() && !ParsePosition(start->second, position, inSeconds))
+	{
+		errorMessage_ = "Given start position is invalid.";
+		return false;
+	}
+
+	auto end = argumentsGiven_.find("--end");
+	if(end != argumentsGiven_.end() && !ParsePosition(end->second, position, inSeconds))
+	{
+		errorMessage_ = "Given end position is invalid.";
+		return false;
+	}
+
+	if((start != argumentsGiven_.end() || end != argumentsGiven_.end()) && GetOutputFilename().size() == 0)
+	{
+		errorMessage_ = "Start or end position given, but no output file given.";
+		return false;
+	}
+
+	// Positions given in different units can only be compared once the sample rate is known
+	if(RangeStartGiven() && RangeEndGiven() && RangeStartInSeconds() == RangeEndInSeconds() && GetRangeEnd() <= GetRangeStart())
+	{
+		errorMessage_ = "Given end position must come after the start position.";
+		return false;
+	}
+
+	return true;
+}
+
+// Accepts a non-negative sample position (e.g. "441000") or time in seconds (e.g. "10.5s")
+bool CommandLineArguments::ParsePosition(const std::string& positionString, double& position, bool& inSeconds)
+{
+	if(positionString.size() == 0)
+	{
+		return false;
+	}
+
+	inSeconds = (positionString.back() == 's');
+	auto numberString{inSeconds ? positionString.substr(0, positionString.size() - 1) : positionString};
+
+	if(numberString.size() == 0 || numberString.find_first_not_of(inSeconds ? "0123456789." : "0123456789") != std::string::npos)
+	{
+		return false;
+	}
+
+	position = atof(numberString.c_str());
+
+	return true;
+}
+
 bool CommandLineArguments::IsValid() const
 {
 	return valid_;
@@ -307,6 +705,24 @@ double CommandLineArguments::GetStretchFactor() const
 	return atof(element->second.c_str());
 }
 
+std::vector<double> CommandLineArguments::GetStretchFactors() const
+{
+	std::vector<double> stretchFactors;
+
+	auto element = argumentsGiven_.find("--stretch");
+	if(element == argumentsGiven_.end())
+	{
+		return stretchFactors;
+	}
+
+	for(auto stretchFactor : Utilities::DelimitedStringToVectorOfStrings(element->second, ','))
+	{
+		stretchFactors.push_back(atof(stretchFactor.c_str()));
+	}
+
+	return stretchFactors;
+}
+
 double CommandLineArguments::GetPitchSetting() const
 {
 	auto element = argumentsGiven_.find("--pitch");
@@ -339,6 +755,58 @@ bool CommandLineArguments::ShowTransients() const
 	return true;
 }
 
+bool CommandLineArguments::ShowProgress() const
+{
+	if(argumentsGiven_.find("--progress") == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::HugePages() const
+{
+	if(argumentsGiven_.find("--hugepages") == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool CommandLineArguments::StatusIntervalGiven() const
+{
+	auto element = argumentsGiven_.find("--status");
+	if(element == argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+double CommandLineArguments::GetStatusInterval() const
+{
+	auto element = argumentsGiven_.find("--status");
+	if(element == argumentsGiven_.end())
+	{
+		return 0.0;
+	}
+
+	return atof(element->second.c_str());
+}
+
+bool CommandLineArguments::IncrementalRender() const
+{
+	if(argumentsGiven_.find("--incremental")== argumentsGiven_.end())
+	{
+		return false;
+	}
+
+	return true;
+}
+
 bool CommandLineArguments::TransientConfigFileGiven() const
 {
 	if(GetTransientConfigFilename().size())
@@ -360,6 +828,133 @@ const std::string CommandLineArguments::GetTransientConfigFilename() const
 	return element->second;
 }
 
+const std::string CommandLineArguments::GetQualityPreset() const
+{
+	auto element = argumentsGiven_.find("--quality");
+	if(element == argumentsGiven_.end())
+	{
+		return "high";
+	}
+
+	return element->second;
+}
+
+bool CommandLineArguments::TransientCacheDirectoryGiven() const
+{
+	if(GetTransientCacheDirectory().size())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+const std::string CommandLineArguments::GetTransientCacheDirectory() const
+{
+	auto element = argumentsGiven_.find("--transientcache");
+	if(element == argumentsGiven_.end())
+	{
+		return "";
+	}
+
+	return element->second;
+}
+
+bool CommandLineArguments::MemoryReportFilenameGiven() const
+{
+	if(GetMemoryReportFilename().size())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+const std::string CommandLineArguments::GetMemoryReportFilename() const
+{
+	auto element = argumentsGiven_.find("--memoryreport");
+	if(element == argumentsGiven_.end())
+	{
+		return "";
+	}
+
+	return element->second;
+}
+
+bool CommandLineArguments::CpuTierGiven() const
+{
+	if(GetCpuTier().size())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+const std::string CommandLineArguments::GetCpuTier() const
+{
+	auto element = argumentsGiven_.find("--cputier");
+	if(element == argumentsGiven_.end())
+	{
+		return "";
+	}
+
+	return element->second;
+}
+
+bool CommandLineArguments::TraceFilenameGiven() const
+{
+	if(GetTraceFilename().size())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+const std::string CommandLineArguments::GetTraceFilename() const
+{
+	auto element = argumentsGiven_.find("--trace");
+	if(element == argumentsGiven_.end())
+	{
+		return "";
+	}
+
+	return element->second;
+}
+
+bool CommandLineArguments::ServerSocketGiven() const
+{
+	if(GetServerSocket().size())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+const std::string CommandLineArguments::GetServerSocket() const
+{
+	auto element = argumentsGiven_.find("--server");
+	if(element == argumentsGiven_.end())
+	{
+		return "";
+	}
+
+	return element->second;
+}
+
+std::size_t CommandLineArguments::GetWorkerCount() const
+{
+	auto element = argumentsGiven_.find("--workers");
+	if(element == argumentsGiven_.end())
+	{
+		return defaultWorkerCount_;
+	}
+
+	return atoi(element->second.c_str());
+}
+
 double CommandLineArguments::GetValleyPeakRatio() const
 {
 	auto element = argumentsGiven_.find("--valleypeakratio");
@@ -405,3 +1000,102 @@ bool CommandLineArguments::Version() const
 
 	return true;
 }
+
+// Converts the given arguments to the settings used for processing
+PhaseVocoderSettings CommandLineArguments::GetPhaseVocoderSettings() const
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+
+	if(InputFilenameGiven())
+	{
+		phaseVocoderSettings.SetInputWaveFile(GetInputFilename());	
+	}
+
+	if(OutputFilenameGiven())
+	{
+		phaseVocoderSettings.SetOutputWaveFile(GetOutputFilename());	
+	}
+
+	if(StretchFactorGiven())
+	{
+		phaseVocoderSettings.SetStretchFactors(GetStretchFactors());
+	}
+
+	if(ResampleSettingGiven())
+	{
+		phaseVocoderSettings.SetResampleValue(GetResampleSetting());
+	}
+
+	if(PitchSettingGiven())
+	{
+		phaseVocoderSettings.SetPitchShiftValue(GetPitchSetting());
+	}
+
+	if(TransientConfigFileGiven())
+	{
+		phaseVocoderSettings.SetTransientConfigFilename(GetTransientConfigFilename());
+	}
+
+	if(RangeStartGiven())
+	{
+		phaseVocoderSettings.SetRangeStart(GetRangeStart(), RangeStartInSeconds());
+	}
+
+	if(RangeEndGiven())
+	{
+		phaseVocoderSettings.SetRangeEnd(GetRangeEnd(), RangeEndInSeconds());
+	}
+
+	if(QualityPresetGiven())
+	{
+		if(GetQualityPreset() == "draft")
+		{
+			phaseVocoderSettings.SetQualityPreset(PhaseVocoderSettings::QualityPreset::DRAFT);
+		}
+		else if(GetQualityPreset() == "medium")
+		{
+			phaseVocoderSettings.SetQualityPreset(PhaseVocoderSettings::QualityPreset::MEDIUM);
+		}
+		else
+		{
+			phaseVocoderSettings.SetQualityPreset(PhaseVocoderSettings::QualityPreset::HIGH);
+		}
+	}
+
+	if(ReadAheadGiven())
+	{
+		phaseVocoderSettings.SetReadAheadBlocks(GetReadAheadBlocks());
+	}
+
+	if(MaxMemoryGiven())
+	{
+		phaseVocoderSettings.SetMaxMemory(GetMaxMemory());
+	}
+
+	if(MinSectionLengthGiven())
+	{
+		phaseVocoderSettings.SetMinSectionLength(GetMinSectionLength());
+	}
+
+	if(TransientCacheDirectoryGiven())
+	{
+		phaseVocoderSettings.SetTransientCacheDirectory(GetTransientCacheDirectory());
+	}
+
+	if(ValleyPeakRatioGiven())
+	{
+		phaseVocoderSettings.SetValleyToPeakRatio(GetValleyPeakRatio());
+	}
+
+	if(ShowTransients())
+	{
+		phaseVocoderSettings.SetDisplayTransients();
+	}
+
+	if(IncrementalRender())
+	{
+		phaseVocoderSettings.SetIncrementalRender();
+	}
+
+	return phaseVocoderSettings;
+}
@@ -24,8 +24,12 @@
  * THE SOFTWARE.
  */
 
+#pragma once
+
 #include <string>
 #include <map>
+#include <vector>
+#include <Application/PhaseVocoderSettings.h>
 
 class CommandLineArguments
 {
@@ -34,6 +38,8 @@ class CommandLineArguments
 
 		bool IsValid() const;
 
+		PhaseVocoderSettings GetPhaseVocoderSettings() const;
+
 		const std::string& GetErrorMessage() const;
 
 		bool InputFilenameGiven() const;
@@ -44,6 +50,7 @@ class CommandLineArguments
 
 		bool StretchFactorGiven() const;
 		double GetStretchFactor() const;
+		std::vector<double> GetStretchFactors() const;  // A comma separated list (e.g. "-s 0.9,1.1") renders one output per factor
 
 		bool PitchSettingGiven() const;
 		double GetPitchSetting() const;
@@ -51,12 +58,49 @@ class CommandLineArguments
 		bool ResampleSettingGiven() const;
 		std::size_t GetResampleSetting() const;
 
+		bool QualityPresetGiven() const;
+		const std::string GetQualityPreset() const;  // "high", "medium" or "draft"
+
+		// Render range positions are sample positions (e.g. "441000") or, with an "s" suffix, seconds (e.g. "10.5s")
+		bool RangeStartGiven() const;
+		double GetRangeStart() const;
+		bool RangeStartInSeconds() const;
+
+		bool RangeEndGiven() const;
+		double GetRangeEnd() const;
+		bool RangeEndInSeconds() const;
+
+		bool ReadAheadGiven() const;
+		std::size_t GetReadAheadBlocks() const;
+
+		bool MaxMemoryGiven() const;
+		std::size_t GetMaxMemory() const;  // In megabytes
+
+		bool MinSectionLengthGiven() const;
+		std::size_t GetMinSectionLength() const;  // In milliseconds
+
 		bool ValleyPeakRatioGiven() const;
 		double GetValleyPeakRatio() const;
 
 		bool ShowTransients() const;
+		bool ShowProgress() const;
+		bool HugePages() const;
+		bool StatusIntervalGiven() const;
+		double GetStatusInterval() const;  // In seconds
+		bool IncrementalRender() const;
 		bool TransientConfigFileGiven() const;
 		const std::string GetTransientConfigFilename() const;
+		bool TransientCacheDirectoryGiven() const;
+		const std::string GetTransientCacheDirectory() const;
+		bool MemoryReportFilenameGiven() const;
+		const std::string GetMemoryReportFilename() const;  // Peak memory per stage and channel is written here as JSON
+		bool CpuTierGiven() const;
+		const std::string GetCpuTier() const;  // "baseline", "avx2" or "avx512", overriding the tier picked for the CPU
+		bool TraceFilenameGiven() const;
+		const std::string GetTraceFilename() const;  // A Chrome trace event timeline is written here
+		bool ServerSocketGiven() const;
+		const std::string GetServerSocket() const;  // Run as a job server listening on this Unix domain socket
+		std::size_t GetWorkerCount() const;
 		bool Help() const;
 		bool LongHelp() const;
 		bool Version() const;
@@ -67,23 +111,43 @@ class CommandLineArguments
 		bool ValidateStretchSetting();
 		bool ValidatePitchSetting();
 		bool ValidateResampleSetting();
+		bool ValidateValleyPeakRatio();
+		bool ValidateQualityPreset();
+		bool ValidateWorkerCount();
+		bool ValidateReadAhead();
+		bool ValidateMaxMemory();
+		bool ValidateMinSectionLength();
+		bool ValidateStatusInterval();
+		bool ValidateCpuTier();
+		bool ValidateRenderRange();
+
+		static bool ParsePosition(const std::string& positionString, double& position, bool& inSeconds);
 
 		bool valid_{true};
 		std::string errorMessage_;
 
 		std::map<std::string, std::string> argumentsGiven_;
 
-		// The stretch factor must be between 0.01 and 10.0
-		const double minimumStretchFactor_{0.01};
-		const double maximumStretchFactor_{10.0};
+		// Between 1 and 1024 blocks of 8192 samples can be read ahead per channel
+		const std::size_t minimumReadAheadBlocks_{1};
+		const std::size_t maximumReadAheadBlocks_{1024};
+
+		// The memory budget must be between 32MB and 1TB
+		const std::size_t minimumMaxMemory_{32};
+		const std::size_t maximumMaxMemory_{1048576};
+
+		// Sections can be made at least 1ms to 1s long
+		const std::size_t minimumMinSectionLength_{1};
+		const std::size_t maximumMinSectionLength_{1000};
 
-		// The pitch shift must be between -24.0 and +24.0 semitones
-		const double minimumPitchShift_{-24.0};
-		const double maximumPitchShift_{24.0};
+		// Status lines can be written between every tenth of a second and once an hour
+		const double minimumStatusInterval_{0.1};
+		const double maximumStatusInterval_{3600.0};
 
-		// The stretch factor must be between 0.01 and 10.0
-		const std::size_t minimumResampleFrequency_{1000};
-		const std::size_t maximumResampleFrequency_{192000};
+		// The job server runs between 1 and 64 worker threads
+		const std::size_t defaultWorkerCount_{2};
+		const std::size_t minimumWorkerCount_{1};
+		const std::size_t maximumWorkerCount_{64};
 
 		struct ArgumentTraits
 		{
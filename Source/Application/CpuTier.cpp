@@ -0,0 +1,172 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/CpuTier.h>
+#include <Utilities/Exception.h>
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	#include <intrin.h>
+	#include <immintrin.h>
+	#define CPU_TIER_X86_MSVC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#define CPU_TIER_X86_GCC
+#endif
+
+namespace
+{
+#if defined(CPU_TIER_X86_MSVC)
+	// CPUID gives what the CPU has and XGETBV whether the OS saves the wider registers on context switches
+	bool CpuSupports(CpuTier::Tier tier)
+	{
+		int registers[4];
+		__cpuid(registers, 0);
+		if(registers[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(registers, 1);
+		const int osxsave{1 << 27};
+		if(!(registers[2] & osxsave))
+		{
+			return false;
+		}
+
+		auto enabledState{_xgetbv(0)};
+		__cpuidex(registers, 7, 0);
+
+		const unsigned long long avxState{0x6};     // XMM and YMM
+		const unsigned long long avx512State{0xe6}; // Plus opmask and ZMM
+		const int avx2{1 << 5};
+		const int avx512f{1 << 16};
+
+		if(tier == CpuTier::Tier::AVX2)
+		{
+			return (enabledState & avxState) == avxState && (registers[1] & avx2);
+		}
+
+		return (enabledState & avx512State) == avx512State && (registers[1] & avx512f);
+	}
+#elif defined(CPU_TIER_X86_GCC)
+	// The compiler's CPU model takes the OS's register support into account
+	bool CpuSupports(CpuTier::Tier tier)
+	{
+		__builtin_cpu_init();
+
+		if(tier == CpuTier::Tier::AVX2)
+		{
+			return __builtin_cpu_supports("avx2");
+		}
+
+		return __builtin_cpu_supports("avx512f");
+	}
+#else
+	bool CpuSupports(CpuTier::Tier)
+	{
+		return false;
+	}
+#endif
+
+	std::atomic<CpuTier::Tier>& GetCurrentTier()
+	{
+		static std::atomic<CpuTier::Tier> currentTier{CpuTier::GetBestSupportedTier()};
+		return currentTier;
+	}
+}
+
+std::vector<CpuTier::Tier> CpuTier::GetTiers()
+{
+	return std::vector<Tier>{Tier::BASELINE, Tier::AVX2, Tier::AVX512};
+}
+
+std::string CpuTier::GetTierName(Tier tier)
+{
+	switch(tier)
+	{
+		case Tier::BASELINE:
+			return "baseline";
+		case Tier::AVX2:
+			return "avx2";
+		case Tier::AVX512:
+			return "avx512";
+	}
+
+	return "";
+}
+
+bool CpuTier::ParseTierName(const std::string& name, Tier& tier)
+{
+	for(auto possibleTier : GetTiers())
+	{
+		if(name == GetTierName(possibleTier))
+		{
+			tier = possibleTier;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CpuTier::IsSupported(Tier tier)
+{
+	if(tier == Tier::BASELINE)
+	{
+		return true;
+	}
+
+	return CpuSupports(tier);
+}
+
+CpuTier::Tier CpuTier::GetBestSupportedTier()
+{
+	auto bestTier{Tier::BASELINE};
+	for(auto tier : GetTiers())
+	{
+		if(IsSupported(tier))
+		{
+			bestTier = tier;
+		}
+	}
+
+	return bestTier;
+}
+
+CpuTier::Tier CpuTier::GetTier()
+{
+	return GetCurrentTier().load(std::memory_order_relaxed);
+}
+
+void CpuTier::SetTier(Tier tier)
+{
+	if(!IsSupported(tier))
+	{
+		Utilities::ThrowException("CPU tier not supported by this CPU", GetTierName(tier));
+	}
+
+	GetCurrentTier() = tier;
+}
@@ -0,0 +1,56 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The instruction set tiers the hot conversion kernels are built for.  Each tier's kernels are compiled 
+// in a translation unit of their own with that tier's compiler flags, so one binary runs everywhere and 
+// uses the widest vectors the CPU has.  The best tier the CPU supports is used unless another is set.
+namespace CpuTier
+{
+	enum class Tier
+	{
+		BASELINE,  // SSE2 on x86-64, scalar elsewhere
+		AVX2,
+		AVX512
+	};
+
+	std::vector<Tier> GetTiers();
+	std::string GetTierName(Tier tier);                        // "baseline", "avx2" or "avx512"
+	bool ParseTierName(const std::string& name, Tier& tier);   // Returns false for an unknown name
+
+	// Whether the CPU (and OS) support the tier
+	bool IsSupported(Tier tier);
+	Tier GetBestSupportedTier();
+
+	Tier GetTier();
+
+	// For benchmarking.  Throws if the CPU doesn't support the tier.
+	void SetTier(Tier tier);
+}
@@ -0,0 +1,120 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/JobClient.h>
+#include <Utilities/Exception.h>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+JobClient::JobClient(const std::string& socketPath) : socketPath_{socketPath} { }
+
+JobClient::~JobClient() { }
+
+JobProtocol::Fields JobClient::SendRequest(const JobProtocol::Fields& request)
+{
+#ifndef _WIN32
+	int connection{Connect()};
+
+	// A busy server responds without reading the request, so a failed write still leaves a response to read
+	std::string response;
+	JobProtocol::WriteFrame(connection, JobProtocol::FormatFields(request));
+	bool succeeded{JobProtocol::ReadFrame(connection, response)};
+	close(connection);
+
+	if(!succeeded)
+	{
+		Utilities::ThrowException("No response from job server", socketPath_);
+	}
+
+	return JobProtocol::ParseFields(response);
+#else
+	Utilities::ThrowException("The job client is not supported on this platform");
+#endif
+}
+
+JobProtocol::Fields JobClient::SendRequest(const JobProtocol::Fields& request, const std::string& inputPcm, std::string& outputPcm)
+{
+#ifndef _WIN32
+	int connection{Connect()};
+
+	// As above, a failed write still leaves a response to read
+	std::string response;
+	if(JobProtocol::WriteFrame(connection, JobProtocol::FormatFields(request)))
+	{
+		JobProtocol::WriteFrame(connection, inputPcm, JobProtocol::maxPcmFrameSize_);
+	}
+
+	bool succeeded{JobProtocol::ReadFrame(connection, response)};
+
+	auto responseFields{JobProtocol::ParseFields(response)};
+	if(succeeded && responseFields["status"] == "ok")
+	{
+		succeeded = JobProtocol::ReadFrame(connection, outputPcm, JobProtocol::maxPcmFrameSize_);
+	}
+
+	close(connection);
+
+	if(!succeeded)
+	{
+		Utilities::ThrowException("No response from job server", socketPath_);
+	}
+
+	return responseFields;
+#else
+	Utilities::ThrowException("The job client is not supported on this platform");
+#endif
+}
+
+int JobClient::Connect()
+{
+#ifndef _WIN32
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socketPath_.c_str(), sizeof(address.sun_path) - 1);
+
+	int connection{socket(AF_UNIX, SOCK_STREAM, 0)};
+	if(connection < 0 || connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		if(connection >= 0)
+		{
+			close(connection);
+		}
+
+		Utilities::ThrowException("Unable to connect to job server", socketPath_);
+	}
+
+	return connection;
+#else
+	Utilities::ThrowException("The job client is not supported on this platform");
+#endif
+}
@@ -0,0 +1,235 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/JobProtocol.h>
+#include <Application/PcmConversion.h>
+#include <Utilities/Exception.h>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace
+{
+#ifndef _WIN32
+	bool ReadAll(int fileDescriptor, char* buffer, std::size_t size)
+	{
+		while(size)
+		{
+			auto bytesRead{read(fileDescriptor, buffer, size)};
+			if(bytesRead < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			if(bytesRead <= 0)
+			{
+				return false;
+			}
+
+			buffer += bytesRead;
+			size -= static_cast<std::size_t>(bytesRead);
+		}
+
+		return true;
+	}
+
+	bool WriteAll(int fileDescriptor, const char* buffer, std::size_t size)
+	{
+		while(size)
+		{
+#ifdef MSG_NOSIGNAL
+			auto bytesWritten{send(fileDescriptor, buffer, size, MSG_NOSIGNAL)};  // Don't die by SIGPIPE if the peer went away
+#else
+			auto bytesWritten{write(fileDescriptor, buffer, size)};
+#endif
+			if(bytesWritten < 0 && errno == EINTR)
+			{
+				continue;
+			}
+
+			if(bytesWritten <= 0)
+			{
+				return false;
+			}
+
+			buffer += bytesWritten;
+			size -= static_cast<std::size_t>(bytesWritten);
+		}
+
+		return true;
+	}
+#endif
+}
+
+bool JobProtocol::ReadFrame(int fileDescriptor, std::string& payload, uint32_t maxFrameSize)
+{
+#ifndef _WIN32
+	unsigned char header[4];
+	if(!ReadAll(fileDescriptor, reinterpret_cast<char*>(header), sizeof(header)))
+	{
+		return false;
+	}
+
+	uint32_t size{(static_cast<uint32_t>(header[0]) << 24) | (static_cast<uint32_t>(header[1]) << 16) | 
+					(static_cast<uint32_t>(header[2]) << 8) | static_cast<uint32_t>(header[3])};
+	if(size > maxFrameSize)
+	{
+		return false;
+	}
+
+	payload.resize(size);
+	return size == 0 || ReadAll(fileDescriptor, &payload[0], size);
+#else
+	Utilities::ThrowException("The job protocol is not supported on this platform");
+#endif
+}
+
+bool JobProtocol::WriteFrame(int fileDescriptor, const std::string& payload, uint32_t maxFrameSize)
+{
+#ifndef _WIN32
+	if(payload.size() > maxFrameSize)
+	{
+		return false;
+	}
+
+	auto size{static_cast<uint32_t>(payload.size())};
+	unsigned char header[4]{static_cast<unsigned char>(size >> 24), static_cast<unsigned char>(size >> 16), 
+							static_cast<unsigned char>(size >> 8), static_cast<unsigned char>(size)};
+
+	return WriteAll(fileDescriptor, reinterpret_cast<const char*>(header), sizeof(header)) && 
+			WriteAll(fileDescriptor, payload.data(), payload.size());
+#else
+	Utilities::ThrowException("The job protocol is not supported on this platform");
+#endif
+}
+
+JobProtocol::Fields JobProtocol::ParseFields(const std::string& payload)
+{
+	Fields fields;
+
+	std::istringstream lines(payload);
+	std::string line;
+	while(std::getline(lines, line))
+	{
+		auto separator{line.find('=')};
+		if(separator == std::string::npos)
+		{
+			continue;
+		}
+
+		fields[line.substr(0, separator)] = line.substr(separator + 1);
+	}
+
+	return fields;
+}
+
+std::string JobProtocol::FormatFields(const Fields& fields)
+{
+	std::string payload;
+
+	for(const auto& field : fields)
+	{
+		payload.append(field.first).append("=").append(field.second).append("\n");
+	}
+
+	return payload;
+}
+
+CommandLineArguments JobProtocol::GetCommandLineArguments(const Fields& request)
+{
+	std::vector<std::string> arguments{"PhaseVocoder"};
+
+	for(const auto& field : request)
+	{
+		if(field.first == "command" || field.first == "pcm_channels" || field.first == "pcm_sample_rate")
+		{
+			continue;
+		}
+
+		arguments.push_back("--" + field.first);
+		if(field.second.size())
+		{
+			arguments.push_back(field.second);
+		}
+	}
+
+	std::vector<char*> argv;
+	for(auto& argument : arguments)
+	{
+		argv.push_back(&argument[0]);
+	}
+
+	return CommandLineArguments(static_cast<int>(argv.size()), argv.data());
+}
+
+bool JobProtocol::InlinePcmGiven(const Fields& request)
+{
+	auto input{request.find("input")};
+	auto output{request.find("output")};
+
+	return (input != request.end() && input->second == "-") || (output != request.end() && output->second == "-");
+}
+
+std::string JobProtocol::EncodePcm(const std::vector<std::vector<double>>& channels)
+{
+	std::size_t frameCount{0};
+	for(const auto& channel : channels)
+	{
+		frameCount = std::max(frameCount, channel.size());
+	}
+
+	std::vector<int16_t> samples(frameCount * channels.size());
+	PcmConversion::Interleave(channels, frameCount, samples.data());
+
+	return std::string(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(int16_t));
+}
+
+std::vector<std::vector<double>> JobProtocol::DecodePcm(const std::string& pcm, std::size_t channelCount)
+{
+	if(channelCount == 0 || pcm.size() % (channelCount * sizeof(int16_t)))
+	{
+		Utilities::ThrowException("Inline PCM isn't a whole number of frames", pcm.size(), channelCount);
+	}
+
+	std::vector<int16_t> samples(pcm.size() / sizeof(int16_t));
+	if(samples.size())
+	{
+		std::memcpy(samples.data(), pcm.data(), pcm.size());
+	}
+
+	std::vector<std::vector<double>> channels;
+	PcmConversion::Deinterleave(samples.data(), samples.size() / channelCount, channelCount, channels);
+
+	return channels;
+}
@@ -0,0 +1,69 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <vector>
+#include <Application/CommandLineArguments.h>
+
+// The protocol spoken between the job server and its clients over a Unix domain socket.  Each message 
+// is a frame consisting of a 4 byte big endian payload length followed by the payload.  A payload is a 
+// list of "key=value" lines.
+//
+// Every request has a "command" field: "process", "stats" or "shutdown".  A process request uses the 
+// long command line argument names (without the leading dashes) as keys, e.g. "input=in.wav", 
+// "output=out.wav", "stretch=1.25".  Arguments not taking a value (e.g. "incremental") are given with an 
+// empty value.  Every response has a "status" field of "ok", "error" (with an error "message") or "busy" 
+// (the server's queue is full and the request wasn't read, so it can be sent again later).
+//
+// A process request can carry its audio inline instead of naming files by giving "input=-" and 
+// "output=-" along with "pcm_channels" and "pcm_sample_rate".  The request is then followed by a frame of 
+// interleaved 16 bit little endian PCM, and an "ok" response by a frame holding the output the same way 
+// (its "pcm_channels" and "pcm_sample_rate" are in the response).
+class JobProtocol
+{
+	public:
+		using Fields = std::map<std::string, std::string>;
+
+		// These return false if the connection was closed, errored, timed out or the frame is too large
+		static bool ReadFrame(int fileDescriptor, std::string& payload, uint32_t maxFrameSize = maxFrameSize_);
+		static bool WriteFrame(int fileDescriptor, const std::string& payload, uint32_t maxFrameSize = maxFrameSize_);
+
+		static Fields ParseFields(const std::string& payload);
+		static std::string FormatFields(const Fields& fields);
+
+		// Validates a process request the same way command line arguments are validated
+		static CommandLineArguments GetCommandLineArguments(const Fields& request);
+
+		static bool InlinePcmGiven(const Fields& request);
+		static std::string EncodePcm(const std::vector<std::vector<double>>& channels);
+		static std::vector<std::vector<double>> DecodePcm(const std::string& pcm, std::size_t channelCount);
+
+		static const uint32_t maxFrameSize_{1024 * 1024};
+		static const uint32_t maxPcmFrameSize_{64 * 1024 * 1024};
+};
@@ -0,0 +1,510 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/JobServer.h>
+#include <Application/PhaseVocoderMediator.h>
+#include <Application/AudioInput.h>
+#include <Application/AudioOutput.h>
+#include <Utilities/Exception.h>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+JobServer::JobServer(const std::string& socketPath, std::size_t workerCount) : 
+	socketPath_{socketPath}, workerCount_{std::max<std::size_t>(workerCount, 1)}
+{
+	OpenSocket();
+}
+
+JobServer::~JobServer()
+{
+	StopWorkers();
+	CloseSocket();
+}
+
+void JobServer::SetConnectionTimeout(double connectionTimeout)
+{
+	connectionTimeout_ = connectionTimeout;
+}
+
+void JobServer::SetMaxQueuedJobs(std::size_t maxQueuedJobs)
+{
+	maxQueuedJobs_ = maxQueuedJobs;
+}
+
+void JobServer::OpenSocket()
+{
+#ifndef _WIN32
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if(socketPath_.size() >= sizeof(address.sun_path))
+	{
+		Utilities::ThrowException("Job server socket path is too long", socketPath_);
+	}
+
+	std::strncpy(address.sun_path, socketPath_.c_str(), sizeof(address.sun_path) - 1);
+
+	// A socket file left behind by a previous server would make bind fail.  Anything else at the path 
+	// isn't ours to remove, so bind fails on it instead.
+	struct stat fileStatus;
+	if(lstat(socketPath_.c_str(), &fileStatus) == 0 && S_ISSOCK(fileStatus.st_mode))
+	{
+		unlink(socketPath_.c_str());
+	}
+
+	socket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(socket_ < 0)
+	{
+		Utilities::ThrowException("Unable to create job server socket");
+	}
+
+	if(pipe(wakePipe_) != 0)
+	{
+		CloseSocket();
+		Utilities::ThrowException("Unable to create job server wake pipe");
+	}
+
+	// Whatever is at the path when bind fails isn't ours, so CloseSocket mustn't unlink it
+	if(bind(socket_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close(socket_);
+		socket_ = -1;
+		CloseSocket();
+		Utilities::ThrowException("Unable to listen on job server socket", socketPath_);
+	}
+
+	if(listen(socket_, 64) != 0)
+	{
+		CloseSocket();
+		Utilities::ThrowException("Unable to listen on job server socket", socketPath_);
+	}
+#else
+	Utilities::ThrowException("The job server is not supported on this platform");
+#endif
+}
+
+void JobServer::CloseSocket()
+{
+#ifndef _WIN32
+	if(socket_ >= 0)
+	{
+		close(socket_);
+		unlink(socketPath_.c_str());
+		socket_ = -1;
+	}
+
+	for(auto& fileDescriptor : wakePipe_)
+	{
+		if(fileDescriptor >= 0)
+		{
+			close(fileDescriptor);
+			fileDescriptor = -1;
+		}
+	}
+#endif
+}
+
+void JobServer::Run()
+{
+#ifndef _WIN32
+	StartWorkers();
+
+	while(true)
+	{
+		int connection{AcceptConnection()};
+		if(connection < 0)
+		{
+			if(ShutdownRequested())
+			{
+				break;
+			}
+
+			StopWorkers();
+			CloseSocket();
+			Utilities::ThrowException("Job server socket stopped accepting connections", socketPath_);
+		}
+
+		// Small enough to fit the socket's buffer, so this doesn't wait on the client
+		if(!QueueJob(connection))
+		{
+			JobProtocol::WriteFrame(connection, JobProtocol::FormatFields(JobProtocol::Fields{{"status", "busy"}, {"message", "Job queue is full"}}));
+			close(connection);
+		}
+	}
+
+	StopWorkers();
+	CloseSocket();
+#endif
+}
+
+// Running out of file descriptors or memory passes once jobs finish, so those are waited out rather 
+// than retried straight away.  Any other error means the socket itself is broken.
+int JobServer::AcceptConnection()
+{
+#ifndef _WIN32
+	while(true)
+	{
+		pollfd pollFileDescriptors[2];
+		pollFileDescriptors[0] = pollfd{socket_, POLLIN, 0};
+		pollFileDescriptors[1] = pollfd{wakePipe_[0], POLLIN, 0};
+		if(poll(pollFileDescriptors, 2, -1) < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+
+		if(pollFileDescriptors[1].revents)
+		{
+			return -1;
+		}
+
+		int connection{accept(socket_, nullptr, nullptr)};
+		if(connection >= 0)
+		{
+			timeval timeout;
+			timeout.tv_sec = static_cast<time_t>(connectionTimeout_);
+			timeout.tv_usec = static_cast<suseconds_t>((connectionTimeout_ - static_cast<double>(timeout.tv_sec)) * 1000000.0);
+			setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+			return connection;
+		}
+
+		if(errno == EINTR || errno == ECONNABORTED)
+		{
+			continue;
+		}
+
+		if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			continue;
+		}
+
+		return -1;
+	}
+#else
+	return -1;
+#endif
+}
+
+bool JobServer::QueueJob(int connection)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if(jobs_.size() >= maxQueuedJobs_)
+	{
+		++statistics_.jobsRejected_;
+		return false;
+	}
+
+	jobs_.push_back(Job{connection, JobProtocol::Fields{}, std::string{}, std::chrono::steady_clock::now()});
+
+	statistics_.queueDepth_ = jobs_.size();
+	statistics_.maxQueueDepth_ = std::max(statistics_.maxQueueDepth_, statistics_.queueDepth_);
+
+	jobQueued_.notify_one();
+
+	return true;
+}
+
+void JobServer::RequestShutdown()
+{
+#ifndef _WIN32
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		shutdownRequested_ = true;
+	}
+
+	char wake{0};
+	while(write(wakePipe_[1], &wake, 1) < 0 && errno == EINTR) { }
+#endif
+}
+
+bool JobServer::ShutdownRequested()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return shutdownRequested_;
+}
+
+void JobServer::StartWorkers()
+{
+	for(std::size_t i{0}; i < workerCount_; ++i)
+	{
+		workers_.push_back(std::thread([this]{ RunWorker(); }));
+	}
+}
+
+void JobServer::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+
+	jobQueued_.notify_all();
+
+	for(auto& worker : workers_)
+	{
+		worker.join();
+	}
+
+	workers_.clear();
+}
+
+// Workers keep going until told to stop and the queue is empty
+void JobServer::RunWorker()
+{
+#ifndef _WIN32
+	while(true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			jobQueued_.wait(lock, [this]{ return stopping_ || !jobs_.empty(); });
+
+			if(jobs_.empty())
+			{
+				return;
+			}
+
+			job = jobs_.front();
+			jobs_.pop_front();
+			statistics_.queueDepth_ = jobs_.size();
+		}
+
+		HandleConnection(job);
+		close(job.connection_);
+	}
+#endif
+}
+
+void JobServer::HandleConnection(Job& job)
+{
+#ifndef _WIN32
+	auto queueWait{std::chrono::duration<double>(std::chrono::steady_clock::now() - job.queuedTime_).count()};
+
+	std::string payload;
+	if(!JobProtocol::ReadFrame(job.connection_, payload))
+	{
+		return;
+	}
+
+	job.request_ = JobProtocol::ParseFields(payload);
+	auto command{job.request_["command"]};
+
+	if(command == "process")
+	{
+		RunJob(job, queueWait);
+		return;
+	}
+
+	JobProtocol::Fields response{{"status", "ok"}};
+	if(command == "stats")
+	{
+		response = GetStatisticsFields();
+	}
+	else if(command != "shutdown")
+	{
+		response = JobProtocol::Fields{{"status", "error"}, {"message", "Unknown command: " + command}};
+	}
+
+	JobProtocol::WriteFrame(job.connection_, JobProtocol::FormatFields(response));
+
+	if(command == "shutdown")
+	{
+		RequestShutdown();
+	}
+#endif
+}
+
+void JobServer::RunJob(Job& job, double queueWait)
+{
+#ifndef _WIN32
+	if(JobProtocol::InlinePcmGiven(job.request_) && !JobProtocol::ReadFrame(job.connection_, job.inputPcm_, JobProtocol::maxPcmFrameSize_))
+	{
+		JobProtocol::WriteFrame(job.connection_, JobProtocol::FormatFields(JobProtocol::Fields{{"status", "error"}, {"message", "No inline PCM received"}}));
+		return;
+	}
+
+	std::string outputPcm;
+	auto response{ProcessJob(job, outputPcm)};
+
+	// Recorded before responding so a client's following stats request includes this job
+	auto latency{std::chrono::duration<double>(std::chrono::steady_clock::now() - job.queuedTime_).count()};
+	RecordJob(response["status"] == "ok", queueWait, latency);
+
+	if(JobProtocol::WriteFrame(job.connection_, JobProtocol::FormatFields(response)) && response["status"] == "ok" && 
+		JobProtocol::InlinePcmGiven(job.request_))
+	{
+		JobProtocol::WriteFrame(job.connection_, outputPcm, JobProtocol::maxPcmFrameSize_);
+	}
+#endif
+}
+
+JobProtocol::Fields JobServer::ProcessJob(const Job& job, std::string& outputPcm)
+{
+	auto commandLineArguments{JobProtocol::GetCommandLineArguments(job.request_)};
+	if(!commandLineArguments.IsValid())
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", commandLineArguments.GetErrorMessage()}};
+	}
+
+	if(commandLineArguments.ServerSocketGiven())
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", "A job can't start a server"}};
+	}
+
+	try
+	{
+		if(JobProtocol::InlinePcmGiven(job.request_))
+		{
+			return ProcessInlinePcmJob(job, commandLineArguments, outputPcm);
+		}
+
+		PhaseVocoderMediator phaseVocoderMediator(commandLineArguments.GetPhaseVocoderSettings());
+		phaseVocoderMediator.Process();
+
+		std::ostringstream processingTime;
+		processingTime << phaseVocoderMediator.GetTotalProcessingTime();
+
+		return JobProtocol::Fields{{"status", "ok"}, {"processing_time", processingTime.str()}};
+	}
+	catch(Utilities::Exception& exception)
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", exception.what()}};
+	}
+	catch(std::exception& exception)
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", exception.what()}};
+	}
+}
+
+// The audio comes from and goes back to the client, so nothing touches the file system
+JobProtocol::Fields JobServer::ProcessInlinePcmJob(const Job& job, const CommandLineArguments& commandLineArguments, std::string& outputPcm)
+{
+	if(commandLineArguments.GetInputFilename() != "-" || commandLineArguments.GetOutputFilename() != "-")
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", "Inline PCM needs both input=- and output=-"}};
+	}
+
+	auto settings{commandLineArguments.GetPhaseVocoderSettings()};
+	if(settings.MultipleStretchFactorsGiven())
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", "Inline PCM takes a single stretch factor"}};
+	}
+
+	std::size_t channelCount{0};
+	std::size_t sampleRate{0};
+	std::istringstream(job.request_.count("pcm_channels") ? job.request_.at("pcm_channels") : "") >> channelCount;
+	std::istringstream(job.request_.count("pcm_sample_rate") ? job.request_.at("pcm_sample_rate") : "") >> sampleRate;
+	if(channelCount == 0 || sampleRate == 0)
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", "Inline PCM needs pcm_channels and pcm_sample_rate"}};
+	}
+
+	auto audioInput{std::make_shared<AudioBufferInput>(JobProtocol::DecodePcm(job.inputPcm_, channelCount), sampleRate, 16)};
+	auto audioOutput{std::make_shared<AudioBufferOutput>(channelCount)};
+
+	PhaseVocoderMediator phaseVocoderMediator(settings, audioInput, std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+	phaseVocoderMediator.Process();
+
+	outputPcm = JobProtocol::EncodePcm(audioOutput->GetChannels());
+	if(outputPcm.size() > JobProtocol::maxPcmFrameSize_)
+	{
+		return JobProtocol::Fields{{"status", "error"}, {"message", "Inline PCM output is too large"}};
+	}
+
+	std::ostringstream processingTime;
+	processingTime << phaseVocoderMediator.GetTotalProcessingTime();
+
+	auto outputSampleRate{settings.ResampleValueGiven() ? settings.GetResampleValue() : sampleRate};
+
+	return JobProtocol::Fields{{"status", "ok"}, {"processing_time", processingTime.str()}, 
+		{"pcm_channels", std::to_string(channelCount)}, {"pcm_sample_rate", std::to_string(outputSampleRate)}};
+}
+
+void JobServer::RecordJob(bool succeeded, double queueWait, double latency)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if(succeeded)
+	{
+		++statistics_.jobsCompleted_;
+	}
+	else
+	{
+		++statistics_.jobsFailed_;
+	}
+
+	statistics_.totalQueueWait_ += queueWait;
+	statistics_.totalLatency_ += latency;
+	statistics_.maxLatency_ = std::max(statistics_.maxLatency_, latency);
+}
+
+JobServer::Statistics JobServer::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return statistics_;
+}
+
+JobProtocol::Fields JobServer::GetStatisticsFields()
+{
+	auto statistics{GetStatistics()};
+
+	auto jobsFinished{statistics.jobsCompleted_ + statistics.jobsFailed_};
+	auto ToString{[](double value) { std::ostringstream valueString; valueString << value; return valueString.str(); }};
+
+	return JobProtocol::Fields{
+		{"status", "ok"},
+		{"workers", std::to_string(workerCount_)},
+		{"jobs_completed", std::to_string(statistics.jobsCompleted_)},
+		{"jobs_failed", std::to_string(statistics.jobsFailed_)},
+		{"jobs_rejected", std::to_string(statistics.jobsRejected_)},
+		{"queue_depth", std::to_string(statistics.queueDepth_)},
+		{"max_queue_depth", std::to_string(statistics.maxQueueDepth_)},
+		{"mean_queue_wait", ToString(jobsFinished ? statistics.totalQueueWait_ / jobsFinished : 0.0)},
+		{"mean_latency", ToString(jobsFinished ? statistics.totalLatency_ / jobsFinished : 0.0)},
+		{"max_latency", ToString(statistics.maxLatency_)}};
+}
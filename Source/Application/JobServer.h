@@ -0,0 +1,128 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <Application/JobProtocol.h>
+
+// Runs PhaseVocoder jobs for clients connecting over a Unix domain socket.  This saves short jobs the 
+// cost of starting a new process (and everything that comes with it) for each one.
+//
+// Each connection carries a single request and gets a single response (see JobProtocol).  Accepted 
+// connections are queued and a fixed pool of worker threads reads and answers them, so stats and 
+// shutdown requests wait for a free worker like process requests do.  Once the queue is full further 
+// connections get a "busy" response without being read.  Not supported on Windows.
+//
+// Each connection has a timeout for sending its request (and its inline PCM).  A client that connects 
+// and goes quiet is dropped when it runs out, holding up only the worker reading it.
+//
+// Nothing is kept warm between jobs beyond the process itself.  Each job gets its own mediator, and 
+// AudioLib's PhaseVocoder is created per transient section within a job anyway, so there's no engine 
+// state a following job could pick up.
+class JobServer
+{
+	public:
+		struct Statistics
+		{
+			std::size_t jobsCompleted_{0};
+			std::size_t jobsFailed_{0};
+			std::size_t jobsRejected_{0};  // Turned away as busy
+			std::size_t queueDepth_{0};
+			std::size_t maxQueueDepth_{0};
+			double totalQueueWait_{0.0};  // Seconds between a job being queued and a worker picking it up
+			double totalLatency_{0.0};    // Seconds between a job being queued and its response being ready
+			double maxLatency_{0.0};
+		};
+
+		JobServer(const std::string& socketPath, std::size_t workerCount);
+		virtual ~JobServer();
+
+		// Optional.  Seconds a connection has to send its request, and a client has to take its response.  
+		// Defaults to five seconds.
+		void SetConnectionTimeout(double connectionTimeout);
+
+		// Optional.  Connections waiting for a worker before further ones are turned away.  Defaults to 64.
+		void SetMaxQueuedJobs(std::size_t maxQueuedJobs);
+
+		// Accepts and runs jobs until a shutdown request is received.  Queued jobs are finished before 
+		// this returns.
+		void Run();
+
+		Statistics GetStatistics();
+
+	private:
+		// The request and inline PCM are read by the worker picking the job up
+		struct Job
+		{
+			int connection_;
+			JobProtocol::Fields request_;
+			std::string inputPcm_;  // Only for requests with inline PCM
+			std::chrono::steady_clock::time_point queuedTime_;
+		};
+
+		void OpenSocket();
+		void CloseSocket();
+
+		int AcceptConnection();  // Returns -1 once the socket can't accept any more, or on shutdown
+		bool QueueJob(int connection);  // Returns false if the queue is full
+		void RequestShutdown();
+		bool ShutdownRequested();
+
+		void StartWorkers();
+		void StopWorkers();
+		void RunWorker();
+		void HandleConnection(Job& job);
+		void RunJob(Job& job, double queueWait);
+		JobProtocol::Fields ProcessJob(const Job& job, std::string& outputPcm);
+		JobProtocol::Fields ProcessInlinePcmJob(const Job& job, const CommandLineArguments& commandLineArguments, std::string& outputPcm);
+		void RecordJob(bool succeeded, double queueWait, double latency);
+
+		JobProtocol::Fields GetStatisticsFields();
+
+		std::string socketPath_;
+		int socket_{-1};
+		int wakePipe_[2]{-1, -1};  // Written to on shutdown, so the accepting thread stops waiting
+		double connectionTimeout_{5.0};
+		std::size_t maxQueuedJobs_{64};
+
+		std::size_t workerCount_;
+		std::vector<std::thread> workers_;
+
+		std::mutex mutex_;
+		std::condition_variable jobQueued_;
+		std::deque<Job> jobs_;
+		bool stopping_{false};
+		bool shutdownRequested_{false};
+
+		Statistics statistics_;
+};
@@ -0,0 +1,179 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/MemoryAccounting.h>
+#include <algorithm>
+#include <limits>
+
+const std::size_t MemoryAccounting::allStreams{std::numeric_limits<std::size_t>::max()};
+
+void MemoryAccounting::Add(Stage stage, std::size_t streamID, std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Update(streamUsage_[std::make_pair(stage, streamID)], bytes, true);
+	Update(stageUsage_[stage], bytes, true);
+	Update(totalUsage_, bytes, true);
+}
+
+void MemoryAccounting::Remove(Stage stage, std::size_t streamID, std::size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	Update(streamUsage_[std::make_pair(stage, streamID)], bytes, false);
+	Update(stageUsage_[stage], bytes, false);
+	Update(totalUsage_, bytes, false);
+}
+
+// Never goes below zero, should a component remove more than it added
+void MemoryAccounting::Update(Usage& usage, std::size_t bytes, bool add)
+{
+	if(add)
+	{
+		usage.current_ += bytes;
+		usage.peak_ = std::max(usage.peak_, usage.current_);
+	}
+	else
+	{
+		usage.current_ -= std::min(usage.current_, bytes);
+	}
+}
+
+MemoryAccounting::Usage MemoryAccounting::GetUsage(Stage stage, std::size_t streamID) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto element{streamUsage_.find(std::make_pair(stage, streamID))};
+	return element == streamUsage_.end() ? Usage{} : element->second;
+}
+
+MemoryAccounting::Usage MemoryAccounting::GetStageUsage(Stage stage) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto element{stageUsage_.find(stage)};
+	return element == stageUsage_.end() ? Usage{} : element->second;
+}
+
+MemoryAccounting::Usage MemoryAccounting::GetTotalUsage() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return totalUsage_;
+}
+
+std::vector<std::size_t> MemoryAccounting::GetStreamIDs(Stage stage) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	std::vector<std::size_t> streamIDs;
+	for(const auto& element : streamUsage_)
+	{
+		if(element.first.first == stage)
+		{
+			streamIDs.push_back(element.first.second);
+		}
+	}
+
+	return streamIDs;
+}
+
+std::vector<MemoryAccounting::Stage> MemoryAccounting::GetStages()
+{
+	return std::vector<Stage>{Stage::READER, Stage::TRANSIENTS, Stage::PHASE_VOCODER, Stage::RESAMPLER, Stage::AUDIO_DATA, Stage::WRITER};
+}
+
+std::string MemoryAccounting::GetStageName(Stage stage)
+{
+	switch(stage)
+	{
+		case Stage::READER:
+			return "reader";
+		case Stage::TRANSIENTS:
+			return "transients";
+		case Stage::PHASE_VOCODER:
+			return "phaseVocoder";
+		case Stage::RESAMPLER:
+			return "resampler";
+		case Stage::AUDIO_DATA:
+			return "audioData";
+		default:
+			return "writer";
+	}
+}
+
+// Streams are numbered from zero, with memory shared by all streams given as "all"
+void MemoryAccounting::WriteReport(std::ostream& stream) const
+{
+	auto totalUsage{GetTotalUsage()};
+
+	stream << "{" << std::endl;
+	stream << "\t\"currentBytes\": " << totalUsage.current_ << "," << std::endl;
+	stream << "\t\"peakBytes\": " << totalUsage.peak_ << "," << std::endl;
+	stream << "\t\"stages\": [" << std::endl;
+
+	auto stages{GetStages()};
+	for(std::size_t i{0}; i < stages.size(); ++i)
+	{
+		auto stageUsage{GetStageUsage(stages[i])};
+		stream << "\t\t{\"stage\": \"" << GetStageName(stages[i]) << "\", \"currentBytes\": " << stageUsage.current_ << ", \"peakBytes\": " << stageUsage.peak_ << ", \"streams\": [";
+
+		auto streamIDs{GetStreamIDs(stages[i])};
+		for(std::size_t j{0}; j < streamIDs.size(); ++j)
+		{
+			auto streamUsage{GetUsage(stages[i], streamIDs[j])};
+
+			stream << (j ? ", " : "") << "{\"stream\": ";
+			if(streamIDs[j] == allStreams)
+			{
+				stream << "\"all\"";
+			}
+			else
+			{
+				stream << streamIDs[j];
+			}
+
+			stream << ", \"currentBytes\": " << streamUsage.current_ << ", \"peakBytes\": " << streamUsage.peak_ << "}";
+		}
+
+		stream << "]}" << (i + 1 < stages.size() ? "," : "") << std::endl;
+	}
+
+	stream << "\t]" << std::endl;
+	stream << "}" << std::endl;
+}
+
+MemoryAccounting::ScopedAllocation::ScopedAllocation(MemoryAccounting* memoryAccounting, Stage stage, std::size_t streamID, std::size_t bytes) : 
+	memoryAccounting_{memoryAccounting}, stage_{stage}, streamID_{streamID}, bytes_{bytes}
+{
+	if(memoryAccounting_)
+	{
+		memoryAccounting_->Add(stage_, streamID_, bytes_);
+	}
+}
+
+MemoryAccounting::ScopedAllocation::~ScopedAllocation()
+{
+	if(memoryAccounting_)
+	{
+		memoryAccounting_->Remove(stage_, streamID_, bytes_);
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <cstddef>
+
+// Tracks the current and peak bytes held by each stage of processing, per stream (channel).  Components 
+// record their allocations as they make and free them.  Memory shared by all streams (e.g. the input 
+// cache) is recorded against allStreams.
+//
+// Some figures are estimates: the PhaseVocoder and Resampler live in AudioLib, so the PhaseVocoder is 
+// sized from its section and the Resampler from the audio passing through it.
+class MemoryAccounting
+{
+	public:
+		enum class Stage { READER, TRANSIENTS, PHASE_VOCODER, RESAMPLER, AUDIO_DATA, WRITER };
+
+		static const std::size_t allStreams;
+
+		struct Usage
+		{
+			std::size_t current_{0};
+			std::size_t peak_{0};
+		};
+
+		void Add(Stage stage, std::size_t streamID, std::size_t bytes);
+		void Remove(Stage stage, std::size_t streamID, std::size_t bytes);
+
+		Usage GetUsage(Stage stage, std::size_t streamID) const;
+		Usage GetStageUsage(Stage stage) const;  // Across all streams
+		Usage GetTotalUsage() const;
+
+		std::vector<std::size_t> GetStreamIDs(Stage stage) const;  // Streams which recorded something for the stage
+
+		static std::vector<Stage> GetStages();
+		static std::string GetStageName(Stage stage);
+
+		// JSON
+		void WriteReport(std::ostream& stream) const;
+
+		// Records an allocation for as long as it's in scope.  Does nothing without a MemoryAccounting.
+		class ScopedAllocation
+		{
+			public:
+				ScopedAllocation(MemoryAccounting* memoryAccounting, Stage stage, std::size_t streamID, std::size_t bytes);
+				~ScopedAllocation();
+
+				ScopedAllocation(const ScopedAllocation&) = delete;
+				ScopedAllocation& operator=(const ScopedAllocation&) = delete;
+
+			private:
+				MemoryAccounting* memoryAccounting_;
+				Stage stage_;
+				std::size_t streamID_;
+				std::size_t bytes_;
+		};
+
+	private:
+		static void Update(Usage& usage, std::size_t bytes, bool add);
+
+		mutable std::mutex mutex_;
+		std::map<std::pair<Stage, std::size_t>, Usage> streamUsage_;
+		std::map<Stage, Usage> stageUsage_;
+		Usage totalUsage_;
+};
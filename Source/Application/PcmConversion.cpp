@@ -0,0 +1,186 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/PcmConversion.h>
+#include <Application/PcmConversionKernels.h>
+#include <Application/CpuTier.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const double minimumSample{-32768.0};
+	const double maximumSample{32767.0};
+
+	int16_t ToPcm(double sample)
+	{
+		return static_cast<int16_t>(std::max(minimumSample, std::min(maximumSample, std::round(sample))));
+	}
+
+	double GetSample(const std::vector<double>& channel, std::size_t frame)
+	{
+		return frame < channel.size() ? channel[frame] : 0.0;
+	}
+
+	// The frames every channel has samples for
+	std::size_t GetCommonFrameCount(const std::vector<std::vector<double>>& channels, std::size_t frameCount)
+	{
+		for(const auto& channel : channels)
+		{
+			frameCount = std::min(frameCount, channel.size());
+		}
+
+		return frameCount;
+	}
+
+	void ResizeChannels(std::vector<std::vector<double>>& channels, std::size_t frameCount, std::size_t channelCount)
+	{
+		channels.resize(channelCount);
+		for(auto& channel : channels)
+		{
+			channel.resize(frameCount);
+		}
+	}
+
+	// The kernels for the tier in use, falling back to a lower tier's when the build has none for it
+	const PcmConversion::Kernels::KernelTable* GetKernels()
+	{
+		auto tier{CpuTier::GetTier()};
+
+		if(tier >= CpuTier::Tier::AVX512 && PcmConversion::Kernels::GetAvx512Kernels())
+		{
+			return PcmConversion::Kernels::GetAvx512Kernels();
+		}
+
+		if(tier >= CpuTier::Tier::AVX2 && PcmConversion::Kernels::GetAvx2Kernels())
+		{
+			return PcmConversion::Kernels::GetAvx2Kernels();
+		}
+
+		return PcmConversion::Kernels::GetBaselineKernels();
+	}
+
+	// xorshift32 giving a uniform value in [-0.5, 0.5)
+	double GetUniformRandom(uint32_t& randomState)
+	{
+		randomState ^= randomState << 13;
+		randomState ^= randomState >> 17;
+		randomState ^= randomState << 5;
+
+		return static_cast<double>(randomState) / 4294967296.0 - 0.5;
+	}
+}
+
+void PcmConversion::Deinterleave(const int16_t* input, std::size_t frameCount, std::size_t channelCount, std::vector<std::vector<double>>& channels)
+{
+	ResizeChannels(channels, frameCount, channelCount);
+
+	auto kernels{GetKernels()};
+
+	std::size_t framesConverted{0};
+	if(kernels && channelCount == 1)
+	{
+		framesConverted = kernels->deinterleaveMono_(input, frameCount, channels[0].data());
+	}
+	else if(kernels && channelCount == 2)
+	{
+		framesConverted = kernels->deinterleaveStereo_(input, frameCount, channels[0].data(), channels[1].data());
+	}
+
+	for(auto frame{framesConverted}; frame < frameCount; ++frame)
+	{
+		for(std::size_t channel{0}; channel < channelCount; ++channel)
+		{
+			channels[channel][frame] = input[frame * channelCount + channel];
+		}
+	}
+}
+
+void PcmConversion::Interleave(const std::vector<std::vector<double>>& channels, std::size_t frameCount, int16_t* output)
+{
+	auto commonFrameCount{GetCommonFrameCount(channels, frameCount)};
+
+	auto kernels{GetKernels()};
+
+	std::size_t framesConverted{0};
+	if(kernels && channels.size() == 1)
+	{
+		framesConverted = kernels->interleaveMono_(channels[0].data(), commonFrameCount, output);
+	}
+	else if(kernels && channels.size() == 2)
+	{
+		framesConverted = kernels->interleaveStereo_(channels[0].data(), channels[1].data(), commonFrameCount, output);
+	}
+
+	for(auto frame{framesConverted}; frame < frameCount; ++frame)
+	{
+		for(std::size_t channel{0}; channel < channels.size(); ++channel)
+		{
+			output[frame * channels.size() + channel] = ToPcm(GetSample(channels[channel], frame));
+		}
+	}
+}
+
+void PcmConversion::InterleaveWithDither(const std::vector<std::vector<double>>& channels, std::size_t frameCount, int16_t* output, uint32_t& randomState)
+{
+	if(randomState == 0)
+	{
+		randomState = 1;  // xorshift never leaves zero
+	}
+
+	for(std::size_t frame{0}; frame < frameCount; ++frame)
+	{
+		for(std::size_t channel{0}; channel < channels.size(); ++channel)
+		{
+			auto dither{GetUniformRandom(randomState) + GetUniformRandom(randomState)};
+			output[frame * channels.size() + channel] = ToPcm(GetSample(channels[channel], frame) + dither);
+		}
+	}
+}
+
+void PcmConversion::DeinterleaveScalar(const int16_t* input, std::size_t frameCount, std::size_t channelCount, std::vector<std::vector<double>>& channels)
+{
+	ResizeChannels(channels, frameCount, channelCount);
+
+	for(std::size_t frame{0}; frame < frameCount; ++frame)
+	{
+		for(std::size_t channel{0}; channel < channelCount; ++channel)
+		{
+			channels[channel][frame] = input[frame * channelCount + channel];
+		}
+	}
+}
+
+void PcmConversion::InterleaveScalar(const std::vector<std::vector<double>>& channels, std::size_t frameCount, int16_t* output)
+{
+	for(std::size_t frame{0}; frame < frameCount; ++frame)
+	{
+		for(std::size_t channel{0}; channel < channels.size(); ++channel)
+		{
+			output[frame * channels.size() + channel] = ToPcm(GetSample(channels[channel], frame));
+		}
+	}
+}
@@ -0,0 +1,52 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Conversion between interleaved 16 bit PCM and the per-channel double samples the engine processes.  
+// The conversions are vectorized for the CPU tier in use (SSE2, AVX2 or AVX-512, see CpuTier.h) with a 
+// scalar fallback.  The vectorized conversions give bit-exact results with the scalar ones.
+namespace PcmConversion
+{
+	// Converts interleaved PCM to one vector of samples per channel
+	void Deinterleave(const int16_t* input, std::size_t frameCount, std::size_t channelCount, std::vector<std::vector<double>>& channels);
+
+	// Rounds (halfway cases away from zero), clamps and interleaves the channels into frameCount frames.  
+	// Channels shorter than frameCount are padded with silence.
+	void Interleave(const std::vector<std::vector<double>>& channels, std::size_t frameCount, int16_t* output);
+
+	// As above, but adds triangular (TPDF) dither of +/-1 LSB before rounding.  The dither is generated 
+	// from (and advances) the given non-zero random state.
+	void InterleaveWithDither(const std::vector<std::vector<double>>& channels, std::size_t frameCount, int16_t* output, uint32_t& randomState);
+
+	// The scalar reference implementations
+	void DeinterleaveScalar(const int16_t* input, std::size_t frameCount, std::size_t channelCount, std::vector<std::vector<double>>& channels);
+	void InterleaveScalar(const std::vector<std::vector<double>>& channels, std::size_t frameCount, int16_t* output);
+}
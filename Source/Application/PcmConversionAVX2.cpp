@@ -0,0 +1,122 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/PcmConversionKernels.h>
+
+// Built with AVX2 enabled (-mavx2 or /arch:AVX2) and only called when the CPU has it
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define PCM_CONVERSION_AVX2
+#endif
+
+#if defined(PCM_CONVERSION_AVX2)
+namespace
+{
+	const double minimumSample{-32768.0};
+	const double maximumSample{32767.0};
+
+	__m128i RoundAndClamp(__m256d samples)
+	{
+		samples = _mm256_max_pd(_mm256_min_pd(samples, _mm256_set1_pd(maximumSample)), _mm256_set1_pd(minimumSample));
+
+		auto truncated{_mm256_cvtepi32_pd(_mm256_cvttpd_epi32(samples))};
+		auto fraction{_mm256_sub_pd(samples, truncated)};
+		auto roundUp{_mm256_and_pd(_mm256_cmp_pd(fraction, _mm256_set1_pd(0.5), _CMP_GE_OQ), _mm256_set1_pd(1.0))};
+		auto roundDown{_mm256_and_pd(_mm256_cmp_pd(fraction, _mm256_set1_pd(-0.5), _CMP_LE_OQ), _mm256_set1_pd(1.0))};
+
+		return _mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_add_pd(truncated, roundUp), roundDown));
+	}
+
+	std::size_t InterleaveMonoVectorized(const double* input, std::size_t frameCount, int16_t* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 8 <= frameCount; frame += 8)
+		{
+			auto first{RoundAndClamp(_mm256_loadu_pd(input + frame))};
+			auto second{RoundAndClamp(_mm256_loadu_pd(input + frame + 4))};
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame), _mm_packs_epi32(first, second));
+		}
+
+		return frame;
+	}
+
+	std::size_t InterleaveStereoVectorized(const double* left, const double* right, std::size_t frameCount, int16_t* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 4 <= frameCount; frame += 4)
+		{
+			auto leftSamples{RoundAndClamp(_mm256_loadu_pd(left + frame))};
+			auto rightSamples{RoundAndClamp(_mm256_loadu_pd(right + frame))};
+			auto frames{_mm_packs_epi32(_mm_unpacklo_epi32(leftSamples, rightSamples), _mm_unpackhi_epi32(leftSamples, rightSamples))};
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame * 2), frames);
+		}
+
+		return frame;
+	}
+
+	std::size_t DeinterleaveMonoVectorized(const int16_t* input, std::size_t frameCount, double* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 8 <= frameCount; frame += 8)
+		{
+			auto samples{_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + frame)))};
+			_mm256_storeu_pd(output + frame, _mm256_cvtepi32_pd(_mm256_castsi256_si128(samples)));
+			_mm256_storeu_pd(output + frame + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(samples, 1)));
+		}
+
+		return frame;
+	}
+
+	std::size_t DeinterleaveStereoVectorized(const int16_t* input, std::size_t frameCount, double* left, double* right)
+	{
+		std::size_t frame{0};
+		for(; frame + 4 <= frameCount; frame += 4)
+		{
+			// [L0 R0 L1 R1 L2 R2 L3 R3] grouped as [L0 L1 L2 L3 R0 R1 R2 R3]
+			auto samples{_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + frame * 2)))};
+			samples = _mm256_permutevar8x32_epi32(samples, _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7));
+
+			_mm256_storeu_pd(left + frame, _mm256_cvtepi32_pd(_mm256_castsi256_si128(samples)));
+			_mm256_storeu_pd(right + frame, _mm256_cvtepi32_pd(_mm256_extracti128_si256(samples, 1)));
+		}
+
+		return frame;
+	}
+
+	const PcmConversion::Kernels::KernelTable kernels{InterleaveMonoVectorized, InterleaveStereoVectorized, 
+														DeinterleaveMonoVectorized, DeinterleaveStereoVectorized};
+}
+
+const PcmConversion::Kernels::KernelTable* PcmConversion::Kernels::GetAvx2Kernels()
+{
+	return &kernels;
+}
+#else
+const PcmConversion::Kernels::KernelTable* PcmConversion::Kernels::GetAvx2Kernels()
+{
+	return nullptr;
+}
+#endif
@@ -0,0 +1,137 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/PcmConversionKernels.h>
+
+// Built with AVX-512 enabled (-mavx512f or /arch:AVX512) and only called when the CPU has it
+#if defined(__AVX512F__)
+	#include <immintrin.h>
+	#define PCM_CONVERSION_AVX512
+#endif
+
+#if defined(PCM_CONVERSION_AVX512)
+namespace
+{
+	const double minimumSample{-32768.0};
+	const double maximumSample{32767.0};
+
+	__m256i RoundAndClamp(__m512d samples)
+	{
+		samples = _mm512_max_pd(_mm512_min_pd(samples, _mm512_set1_pd(maximumSample)), _mm512_set1_pd(minimumSample));
+
+		auto truncated{_mm512_cvtepi32_pd(_mm512_cvttpd_epi32(samples))};
+		auto fraction{_mm512_sub_pd(samples, truncated)};
+		auto roundUp{_mm512_cmp_pd_mask(fraction, _mm512_set1_pd(0.5), _CMP_GE_OQ)};
+		auto roundDown{_mm512_cmp_pd_mask(fraction, _mm512_set1_pd(-0.5), _CMP_LE_OQ)};
+
+		truncated = _mm512_mask_add_pd(truncated, roundUp, truncated, _mm512_set1_pd(1.0));
+		truncated = _mm512_mask_sub_pd(truncated, roundDown, truncated, _mm512_set1_pd(1.0));
+
+		return _mm512_cvttpd_epi32(truncated);
+	}
+
+	// The values are already clamped to 16 bits, so saturating just narrows them
+	__m256i PackTo16Bits(__m256i low, __m256i high)
+	{
+		return _mm512_cvtsepi32_epi16(_mm512_inserti64x4(_mm512_castsi256_si512(low), high, 1));
+	}
+
+	std::size_t InterleaveMonoVectorized(const double* input, std::size_t frameCount, int16_t* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 16 <= frameCount; frame += 16)
+		{
+			auto first{RoundAndClamp(_mm512_loadu_pd(input + frame))};
+			auto second{RoundAndClamp(_mm512_loadu_pd(input + frame + 8))};
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + frame), PackTo16Bits(first, second));
+		}
+
+		return frame;
+	}
+
+	std::size_t InterleaveStereoVectorized(const double* left, const double* right, std::size_t frameCount, int16_t* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 8 <= frameCount; frame += 8)
+		{
+			auto leftSamples{RoundAndClamp(_mm512_loadu_pd(left + frame))};
+			auto rightSamples{RoundAndClamp(_mm512_loadu_pd(right + frame))};
+
+			// Unpacking works within 128 bit lanes, giving [L0 R0 L1 R1 | L4 R4 L5 R5] and [L2 R2 L3 R3 | L6 R6 L7 R7]
+			auto unpackedLow{_mm256_unpacklo_epi32(leftSamples, rightSamples)};
+			auto unpackedHigh{_mm256_unpackhi_epi32(leftSamples, rightSamples)};
+			auto frames03{_mm256_permute2x128_si256(unpackedLow, unpackedHigh, 0x20)};
+			auto frames47{_mm256_permute2x128_si256(unpackedLow, unpackedHigh, 0x31)};
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + frame * 2), PackTo16Bits(frames03, frames47));
+		}
+
+		return frame;
+	}
+
+	std::size_t DeinterleaveMonoVectorized(const int16_t* input, std::size_t frameCount, double* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 16 <= frameCount; frame += 16)
+		{
+			auto samples{_mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + frame)))};
+			_mm512_storeu_pd(output + frame, _mm512_cvtepi32_pd(_mm512_castsi512_si256(samples)));
+			_mm512_storeu_pd(output + frame + 8, _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(samples, 1)));
+		}
+
+		return frame;
+	}
+
+	std::size_t DeinterleaveStereoVectorized(const int16_t* input, std::size_t frameCount, double* left, double* right)
+	{
+		std::size_t frame{0};
+		for(; frame + 8 <= frameCount; frame += 8)
+		{
+			// [L0 R0 ... L7 R7] grouped as [L0 ... L7 R0 ... R7]
+			auto samples{_mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + frame * 2)))};
+			samples = _mm512_permutexvar_epi32(_mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15), samples);
+
+			_mm512_storeu_pd(left + frame, _mm512_cvtepi32_pd(_mm512_castsi512_si256(samples)));
+			_mm512_storeu_pd(right + frame, _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(samples, 1)));
+		}
+
+		return frame;
+	}
+
+	const PcmConversion::Kernels::KernelTable kernels{InterleaveMonoVectorized, InterleaveStereoVectorized, 
+														DeinterleaveMonoVectorized, DeinterleaveStereoVectorized};
+}
+
+const PcmConversion::Kernels::KernelTable* PcmConversion::Kernels::GetAvx512Kernels()
+{
+	return &kernels;
+}
+#else
+const PcmConversion::Kernels::KernelTable* PcmConversion::Kernels::GetAvx512Kernels()
+{
+	return nullptr;
+}
+#endif
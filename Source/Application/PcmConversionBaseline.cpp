@@ -0,0 +1,137 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/PcmConversionKernels.h>
+
+// SSE2 is part of x86-64, so the baseline kernels need no extra compiler flags there
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define PCM_CONVERSION_SSE2
+#endif
+
+#if defined(PCM_CONVERSION_SSE2)
+namespace
+{
+	const double minimumSample{-32768.0};
+	const double maximumSample{32767.0};
+
+	// Rounds halfway cases away from zero like std::round.  Clamping first keeps the values within int32 
+	// range so truncation is exact, and the fraction left after truncation is exact too.
+	__m128i RoundAndClamp(__m128d samples)
+	{
+		samples = _mm_max_pd(_mm_min_pd(samples, _mm_set1_pd(maximumSample)), _mm_set1_pd(minimumSample));
+
+		auto truncated{_mm_cvtepi32_pd(_mm_cvttpd_epi32(samples))};
+		auto fraction{_mm_sub_pd(samples, truncated)};
+		auto roundUp{_mm_and_pd(_mm_cmpge_pd(fraction, _mm_set1_pd(0.5)), _mm_set1_pd(1.0))};
+		auto roundDown{_mm_and_pd(_mm_cmple_pd(fraction, _mm_set1_pd(-0.5)), _mm_set1_pd(1.0))};
+
+		return _mm_cvttpd_epi32(_mm_sub_pd(_mm_add_pd(truncated, roundUp), roundDown));
+	}
+
+	std::size_t InterleaveMonoVectorized(const double* input, std::size_t frameCount, int16_t* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 8 <= frameCount; frame += 8)
+		{
+			auto first{_mm_unpacklo_epi64(RoundAndClamp(_mm_loadu_pd(input + frame)), RoundAndClamp(_mm_loadu_pd(input + frame + 2)))};
+			auto second{_mm_unpacklo_epi64(RoundAndClamp(_mm_loadu_pd(input + frame + 4)), RoundAndClamp(_mm_loadu_pd(input + frame + 6)))};
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame), _mm_packs_epi32(first, second));
+		}
+
+		return frame;
+	}
+
+	std::size_t InterleaveStereoVectorized(const double* left, const double* right, std::size_t frameCount, int16_t* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 4 <= frameCount; frame += 4)
+		{
+			auto left01{_mm_loadu_pd(left + frame)};
+			auto left23{_mm_loadu_pd(left + frame + 2)};
+			auto right01{_mm_loadu_pd(right + frame)};
+			auto right23{_mm_loadu_pd(right + frame + 2)};
+
+			auto frames01{_mm_unpacklo_epi64(RoundAndClamp(_mm_unpacklo_pd(left01, right01)), RoundAndClamp(_mm_unpackhi_pd(left01, right01)))};
+			auto frames23{_mm_unpacklo_epi64(RoundAndClamp(_mm_unpacklo_pd(left23, right23)), RoundAndClamp(_mm_unpackhi_pd(left23, right23)))};
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + frame * 2), _mm_packs_epi32(frames01, frames23));
+		}
+
+		return frame;
+	}
+
+	std::size_t DeinterleaveMonoVectorized(const int16_t* input, std::size_t frameCount, double* output)
+	{
+		std::size_t frame{0};
+		for(; frame + 8 <= frameCount; frame += 8)
+		{
+			auto samples{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + frame))};
+			auto low{_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)};
+			auto high{_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16)};
+
+			_mm_storeu_pd(output + frame, _mm_cvtepi32_pd(low));
+			_mm_storeu_pd(output + frame + 2, _mm_cvtepi32_pd(_mm_srli_si128(low, 8)));
+			_mm_storeu_pd(output + frame + 4, _mm_cvtepi32_pd(high));
+			_mm_storeu_pd(output + frame + 6, _mm_cvtepi32_pd(_mm_srli_si128(high, 8)));
+		}
+
+		return frame;
+	}
+
+	std::size_t DeinterleaveStereoVectorized(const int16_t* input, std::size_t frameCount, double* left, double* right)
+	{
+		std::size_t frame{0};
+		for(; frame + 4 <= frameCount; frame += 4)
+		{
+			auto samples{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + frame * 2))};
+
+			// Sign extend to [L0 R0 L1 R1] and [L2 R2 L3 R3], then group each as [L L R R]
+			auto frames01{_mm_shuffle_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16), _MM_SHUFFLE(3, 1, 2, 0))};
+			auto frames23{_mm_shuffle_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16), _MM_SHUFFLE(3, 1, 2, 0))};
+
+			_mm_storeu_pd(left + frame, _mm_cvtepi32_pd(frames01));
+			_mm_storeu_pd(right + frame, _mm_cvtepi32_pd(_mm_srli_si128(frames01, 8)));
+			_mm_storeu_pd(left + frame + 2, _mm_cvtepi32_pd(frames23));
+			_mm_storeu_pd(right + frame + 2, _mm_cvtepi32_pd(_mm_srli_si128(frames23, 8)));
+		}
+
+		return frame;
+	}
+
+	const PcmConversion::Kernels::KernelTable kernels{InterleaveMonoVectorized, InterleaveStereoVectorized, 
+														DeinterleaveMonoVectorized, DeinterleaveStereoVectorized};
+}
+
+const PcmConversion::Kernels::KernelTable* PcmConversion::Kernels::GetBaselineKernels()
+{
+	return &kernels;
+}
+#else
+const PcmConversion::Kernels::KernelTable* PcmConversion::Kernels::GetBaselineKernels()
+{
+	return nullptr;
+}
+#endif
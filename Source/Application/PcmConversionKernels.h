@@ -0,0 +1,55 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// The vectorized PCM conversion kernels, built once per CPU tier (see CpuTier.h).  Each kernel handles as 
+// many frames as it can in full vectors and returns how many it handled, leaving the rest to the scalar code.
+//
+// The tier translation units are compiled with wider instruction sets than the rest of the build, so they 
+// must only use intrinsics and their own internal functions.  An inline function from a shared header 
+// (std::min, say) instantiated in one of them could be the copy the linker keeps for the whole program.
+namespace PcmConversion
+{
+	namespace Kernels
+	{
+		struct KernelTable
+		{
+			std::size_t (*interleaveMono_)(const double* input, std::size_t frameCount, int16_t* output);
+			std::size_t (*interleaveStereo_)(const double* left, const double* right, std::size_t frameCount, int16_t* output);
+			std::size_t (*deinterleaveMono_)(const int16_t* input, std::size_t frameCount, double* output);
+			std::size_t (*deinterleaveStereo_)(const int16_t* input, std::size_t frameCount, double* left, double* right);
+		};
+
+		// Null when the build has no kernels for the tier (e.g. on other architectures)
+		const KernelTable* GetBaselineKernels();
+		const KernelTable* GetAvx2Kernels();
+		const KernelTable* GetAvx512Kernels();
+	}
+}
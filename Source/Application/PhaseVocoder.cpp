@@ -30,17 +30,30 @@
 #include <iomanip>
 #include <locale>
 #include <sstream>
+#include <fstream>
 #include <Utilities/Exception.h>
 #include <Application/PhaseVocoderMediator.h>
 #include <Application/CommandLineArguments.h>
+#include <Application/JobServer.h>
+#include <Application/Trace.h>
+#include <Application/CpuTier.h>
+#include <Application/AlignedMemory.h>
 #include <Application/Usage.h>
 
 const uint32_t SUCCESS{0};
 const uint32_t FAILURE{1};
 
+const double progressInterval{0.5};  // Seconds between updates of the progress line
+
 void CheckCommandLineArguments(CommandLineArguments& commandLineArguments);
+bool SelectCpuTier(const CommandLineArguments& commandLineArguments);
+void SelectHugePages(const CommandLineArguments& commandLineArguments);
 std::unique_ptr<PhaseVocoderMediator> GetPhaseVocoderMediator(const CommandLineArguments& commandLineArguments);
 int PerformPhaseVocoding(CommandLineArguments& commandLineArguments);
+int RunJobServer(CommandLineArguments& commandLineArguments);
+void DisplayProgress(const Progress& progress);
+void DisplayMemoryUsage(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoderMediator);
+void WriteMemoryReport(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoderMediator, const std::string& filename);
 void DisplayTransients(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoderMediator);
 void DisplayAllTransientsOnChannel(const std::vector<std::size_t>& transients);
 
@@ -49,6 +62,19 @@ int main(int argc, char* argv[])
 	CommandLineArguments commandLineArguments(argc, argv);
 
 	CheckCommandLineArguments(commandLineArguments);
+
+	if(!SelectCpuTier(commandLineArguments))
+	{
+		return FAILURE;
+	}
+
+	SelectHugePages(commandLineArguments);
+
+	if(commandLineArguments.ServerSocketGiven())
+	{
+		return RunJobServer(commandLineArguments);
+	}
+
 	return PerformPhaseVocoding(commandLineArguments);
 }
 
@@ -81,49 +107,49 @@ void CheckCommandLineArguments(CommandLineArguments& commandLineArguments)
 	}
 }
 
-std::unique_ptr<PhaseVocoderMediator> GetPhaseVocoderMediator(const CommandLineArguments& commandLineArguments)
+// The best tier the CPU supports is used unless one is given
+bool SelectCpuTier(const CommandLineArguments& commandLineArguments)
 {
-	PhaseVocoderSettings phaseVocoderSettings;
-
-	if(commandLineArguments.InputFilenameGiven())
+	try
 	{
-		phaseVocoderSettings.SetInputWaveFile(commandLineArguments.GetInputFilename());	
+		CpuTier::Tier tier;
+		if(commandLineArguments.CpuTierGiven() && CpuTier::ParseTierName(commandLineArguments.GetCpuTier(), tier))
+		{
+			CpuTier::SetTier(tier);
+		}
 	}
-
-	if(commandLineArguments.OutputFilenameGiven())
+	catch(Utilities::Exception& exception)
 	{
-		phaseVocoderSettings.SetOutputWaveFile(commandLineArguments.GetOutputFilename());	
+		std::cerr << "Error: " << exception.what() << std::endl;
+		return false;
 	}
 
-	if(commandLineArguments.StretchFactorGiven())
-	{
-		phaseVocoderSettings.SetStretchFactor(commandLineArguments.GetStretchFactor());
-	}
+	std::cout << "CPU Tier: " << CpuTier::GetTierName(CpuTier::GetTier()) << std::endl;
 
-	if(commandLineArguments.ResampleSettingGiven())
-	{
-		phaseVocoderSettings.SetResampleValue(commandLineArguments.GetResampleSetting());
-	}
+	return true;
+}
 
-	if(commandLineArguments.PitchSettingGiven())
+// Huge pages are only advice to the kernel, so where they aren't supported processing goes on without them
+void SelectHugePages(const CommandLineArguments& commandLineArguments)
+{
+	if(!commandLineArguments.HugePages())
 	{
-		phaseVocoderSettings.SetPitchShiftValue(commandLineArguments.GetPitchSetting());
+		return;
 	}
 
-	if(commandLineArguments.TransientConfigFileGiven())
+	if(!AlignedMemory::HugePagesSupported())
 	{
-		phaseVocoderSettings.SetTransientConfigFilename(commandLineArguments.GetTransientConfigFilename());
+		std::cout << "Huge pages aren't supported on this platform" << std::endl;
+		return;
 	}
 
-	if(commandLineArguments.ValleyPeakRatioGiven())
-	{
-		phaseVocoderSettings.SetValleyToPeakRatio(commandLineArguments.GetValleyPeakRatio());
-	}
+	AlignedMemory::SetHugePages(true);
+	std::cout << "Huge Pages: On" << std::endl;
+}
 
-	if(commandLineArguments.ShowTransients())
-	{
-		phaseVocoderSettings.SetDisplayTransients();
-	}
+std::unique_ptr<PhaseVocoderMediator> GetPhaseVocoderMediator(const CommandLineArguments& commandLineArguments)
+{
+	auto phaseVocoderSettings{commandLineArguments.GetPhaseVocoderSettings()};
 
 	return std::unique_ptr<PhaseVocoderMediator>{new PhaseVocoderMediator(phaseVocoderSettings)};
 }
@@ -132,15 +158,58 @@ int PerformPhaseVocoding(CommandLineArguments& commandLineArguments)
 {
 	try
 	{
+		if(commandLineArguments.TraceFilenameGiven())
+		{
+			Trace::SetThreadName("Main");
+			Trace::Start();
+		}
+
 		auto phaseVocoderMediator{GetPhaseVocoderMediator(commandLineArguments)};
+
+		if(commandLineArguments.ShowProgress())
+		{
+			phaseVocoderMediator->SetProgressCallback(DisplayProgress, progressInterval);
+		}
+		else if(commandLineArguments.StatusIntervalGiven())
+		{
+			// On stderr so the status lines don't mix with the rest of the output
+			phaseVocoderMediator->SetProgressCallback([](const Progress& progress) { progress.WriteStatus(std::cerr); }, 
+														commandLineArguments.GetStatusInterval());
+		}
+
 		phaseVocoderMediator->Process();
 
+		if(commandLineArguments.TraceFilenameGiven())
+		{
+			Trace::Stop();
+			Trace::Write(commandLineArguments.GetTraceFilename());
+		}
+
 		std::cout << "Total Processing Time: " << phaseVocoderMediator->GetTotalProcessingTime() << std::endl;
-		if(phaseVocoderMediator->GetChannelCount() == 2)
+		if(phaseVocoderMediator->GetChannelCount() >= 2)
 		{
 			std::cout << "Write Buffer Highwater Mark: " << phaseVocoderMediator->GetMaxBufferedSamples() << std::endl;
 		}
 
+		DisplayMemoryUsage(phaseVocoderMediator);
+
+		if(commandLineArguments.MemoryReportFilenameGiven())
+		{
+			WriteMemoryReport(phaseVocoderMediator, commandLineArguments.GetMemoryReportFilename());
+		}
+
+		if(commandLineArguments.IncrementalRender())
+		{
+			auto totalSections{phaseVocoderMediator->GetSectionsRendered() + phaseVocoderMediator->GetSectionsReused()};
+			std::cout << "Sections Reused: " << phaseVocoderMediator->GetSectionsReused() << " of " << totalSections << std::endl;
+		}
+
+		if(commandLineArguments.MinSectionLengthGiven())
+		{
+			std::cout << "Sections Merged: " << phaseVocoderMediator->GetSectionsMerged();
+			std::cout << " (Estimated Time Saved: " << phaseVocoderMediator->GetMergeTimeSaved() << " seconds)" << std::endl;
+		}
+
 		if(commandLineArguments.ShowTransients())
 		{
 			DisplayTransients(phaseVocoderMediator);
@@ -157,6 +226,104 @@ int PerformPhaseVocoding(CommandLineArguments& commandLineArguments)
 	return SUCCESS;
 }
 
+int RunJobServer(CommandLineArguments& commandLineArguments)
+{
+	try
+	{
+		JobServer jobServer(commandLineArguments.GetServerSocket(), commandLineArguments.GetWorkerCount());
+
+		std::cout << "Listening on " << commandLineArguments.GetServerSocket() << " with " << commandLineArguments.GetWorkerCount() << " workers" << std::endl;
+		jobServer.Run();
+
+		auto statistics{jobServer.GetStatistics()};
+		std::cout << "Jobs Completed: " << statistics.jobsCompleted_ << "  Failed: " << statistics.jobsFailed_ << "  Rejected: " << statistics.jobsRejected_ << std::endl;
+	}
+	catch(Utilities::Exception& exception)
+	{
+		std::cerr << "Error: " << exception.what() << std::endl;
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+// Rewrites a single line in place.  The section shown is that of the channel furthest behind.
+void DisplayProgress(const Progress& progress)
+{
+	std::size_t currentSection{progress.streams_.size() ? progress.streams_[0].currentSection_ : 0};
+	std::size_t sectionCount{0};
+	for(const auto& stream : progress.streams_)
+	{
+		currentSection = std::min(currentSection, stream.currentSection_);
+		sectionCount = std::max(sectionCount, stream.sectionCount_);
+	}
+
+	std::ostringstream progressLine;
+	progressLine << std::fixed << std::setprecision(1) << "Progress: " << progress.GetFractionComplete() * 100.0 << "%";
+	progressLine << "  Section " << currentSection << " of " << sectionCount;
+	progressLine << "  Realtime: " << progress.realtimeFactor_ << "x";
+	progressLine << "  Remaining: " << static_cast<std::size_t>(progress.GetEstimatedSecondsRemaining() + 0.5) << "s";
+
+	std::cout << "\r" << std::left << std::setw(80) << progressLine.str() << std::flush;
+	if(progress.finished_)
+	{
+		std::cout << std::endl;
+	}
+}
+
+// Peaks in KB for each stage that used any memory, broken down by channel when there's more than one
+void DisplayMemoryUsage(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoderMediator)
+{
+	auto memoryAccounting{phaseVocoderMediator->GetMemoryAccounting()};
+	const std::size_t kilobyte{1024};
+
+	std::cout << "Peak Memory (KB): " << (memoryAccounting->GetTotalUsage().peak_ + kilobyte - 1) / kilobyte << std::endl;
+
+	for(auto stage : MemoryAccounting::GetStages())
+	{
+		auto streamIDs{memoryAccounting->GetStreamIDs(stage)};
+		if(streamIDs.empty())
+		{
+			continue;
+		}
+
+		std::cout << "   " << MemoryAccounting::GetStageName(stage) << ": " << (memoryAccounting->GetStageUsage(stage).peak_ + kilobyte - 1) / kilobyte;
+		if(streamIDs.size() > 1)
+		{
+			std::cout << " (";
+			for(std::size_t i{0}; i < streamIDs.size(); ++i)
+			{
+				std::cout << (i ? ", " : "");
+				if(streamIDs[i] == MemoryAccounting::allStreams)
+				{
+					std::cout << "shared ";
+				}
+				else
+				{
+					std::cout << "channel " << (streamIDs[i] + 1) << " ";
+				}
+
+				std::cout << (memoryAccounting->GetUsage(stage, streamIDs[i]).peak_ + kilobyte - 1) / kilobyte;
+			}
+
+			std::cout << ")";
+		}
+
+		std::cout << std::endl;
+	}
+}
+
+void WriteMemoryReport(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoderMediator, const std::string& filename)
+{
+	std::ofstream reportFile{filename};
+	if(!reportFile)
+	{
+		Utilities::ThrowException("Unable to write memory report", filename);
+	}
+
+	phaseVocoderMediator->GetMemoryAccounting()->WriteReport(reportFile);
+}
+
 void DisplayTransients(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoderMediator)
 {
 
@@ -197,6 +364,23 @@ void DisplayTransients(const std::unique_ptr<PhaseVocoderMediator>& phaseVocoder
 			DisplayAllTransientsOnChannel(rightTransients);
 		}
 	}
+	else
+	{
+		for(std::size_t streamID{0}; streamID < phaseVocoderMediator->GetChannelCount(); ++streamID)
+		{
+			auto transients{phaseVocoderMediator->GetTransients(streamID)};
+			std::cout << "Channel " << (streamID + 1) << " transient sample positions:";
+			if(transients.size() == 0)
+			{
+				std::cout << " None" << std::endl;
+			}
+			else
+			{
+				DisplayAllTransientsOnChannel(transients);
+				std::cout << std::endl;
+			}
+		}
+	}
 }
 
 void DisplayAllTransientsOnChannel(const std::vector<std::size_t>& transients)
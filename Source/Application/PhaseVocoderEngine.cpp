@@ -0,0 +1,253 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/PhaseVocoderEngine.h>
+#include <Application/PhaseVocoderMediator.h>
+#include <Application/AudioInput.h>
+#include <Application/AudioOutput.h>
+#include <Application/PcmConversion.h>
+#include <Utilities/Exception.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace
+{
+	thread_local std::string lastError;
+
+	int Fail(int status, const std::string& error)
+	{
+		lastError = error;
+		return status;
+	}
+
+	PhaseVocoderSettings GetPhaseVocoderSettings(const PhaseVocoderEngineOptions& options)
+	{
+		PhaseVocoderSettings settings;
+
+		if(options.stretchFactor != 0.0)
+		{
+			settings.SetStretchFactor(options.stretchFactor);
+		}
+
+		if(options.pitchShift != 0.0)
+		{
+			settings.SetPitchShiftValue(options.pitchShift);
+		}
+
+		if(options.resampleRate)
+		{
+			settings.SetResampleValue(options.resampleRate);
+		}
+
+		if(options.valleyToPeakRatio != 0.0)
+		{
+			settings.SetValleyToPeakRatio(options.valleyToPeakRatio);
+		}
+
+		if(options.quality == PHASEVOCODER_ENGINE_QUALITY_MEDIUM)
+		{
+			settings.SetQualityPreset(PhaseVocoderSettings::QualityPreset::MEDIUM);
+		}
+		else if(options.quality == PHASEVOCODER_ENGINE_QUALITY_DRAFT)
+		{
+			settings.SetQualityPreset(PhaseVocoderSettings::QualityPreset::DRAFT);
+		}
+
+		return settings;
+	}
+
+	std::string ValidateArguments(const PhaseVocoderEngineOptions* options, const PhaseVocoderEngineBuffer* input, PhaseVocoderEngineBuffer* output)
+	{
+		if(!options || !input || !output)
+		{
+			return "Null options, input or output given";
+		}
+
+		if(options->apiVersion == 0 || options->apiVersion > PHASEVOCODER_ENGINE_API_VERSION)
+		{
+			return "Options weren't initialized with PhaseVocoderEngine_InitOptions";
+		}
+
+		if(options->stretchFactor == 0.0 && options->pitchShift == 0.0 && options->resampleRate == 0)
+		{
+			return "Nothing to do.  No stretch, pitch or resample setting given.";
+		}
+
+		// Zero means the setting isn't given, otherwise the values the command line accepts are required
+		std::string error;
+		if(options->stretchFactor != 0.0)
+		{
+			error = PhaseVocoderSettings::ValidateStretchFactor(options->stretchFactor);
+		}
+
+		if(error.empty() && options->pitchShift != 0.0)
+		{
+			error = PhaseVocoderSettings::ValidatePitchShiftValue(options->pitchShift);
+		}
+
+		if(error.empty() && options->resampleRate != 0)
+		{
+			error = PhaseVocoderSettings::ValidateResampleValue(options->resampleRate);
+		}
+
+		if(error.empty() && options->valleyToPeakRatio != 0.0)
+		{
+			error = PhaseVocoderSettings::ValidateValleyToPeakRatio(options->valleyToPeakRatio);
+		}
+
+		if(!error.empty())
+		{
+			return error;
+		}
+
+		if(options->quality < PHASEVOCODER_ENGINE_QUALITY_HIGH || options->quality > PHASEVOCODER_ENGINE_QUALITY_DRAFT)
+		{
+			return "Unknown quality preset";
+		}
+
+		if(input->channelCount != 1 && input->channelCount != 2)
+		{
+			return "Only mono or stereo audio is supported";
+		}
+
+		if(!input->sampleRate || (input->frameCount && !input->samples))
+		{
+			return "Input has no sample rate or no samples";
+		}
+
+		return "";
+	}
+
+	std::vector<std::vector<double>> Deinterleave(const PhaseVocoderEngineBuffer& buffer)
+	{
+		std::vector<std::vector<double>> channels;
+		PcmConversion::Deinterleave(buffer.samples, buffer.frameCount, buffer.channelCount, channels);
+
+		return channels;
+	}
+
+	// The channels may differ slightly in length, the shorter one is padded with silence
+	void Interleave(const std::vector<std::vector<double>>& channels, bool dither, PhaseVocoderEngineBuffer& buffer)
+	{
+		std::size_t frameCount{0};
+		for(const auto& channel : channels)
+		{
+			frameCount = std::max(frameCount, channel.size());
+		}
+
+		buffer.samples = new int16_t[std::max<std::size_t>(frameCount * channels.size(), 1)];
+		buffer.frameCount = frameCount;
+		buffer.channelCount = static_cast<unsigned int>(channels.size());
+
+		if(dither)
+		{
+			uint32_t randomState{0x9E3779B9};
+			PcmConversion::InterleaveWithDither(channels, frameCount, buffer.samples, randomState);
+		}
+		else
+		{
+			PcmConversion::Interleave(channels, frameCount, buffer.samples);
+		}
+	}
+}
+
+void PhaseVocoderEngine_InitOptionsVersion(PhaseVocoderEngineOptions* options, unsigned int apiVersion)
+{
+	if(!options || apiVersion == 0)
+	{
+		return;
+	}
+
+	options->apiVersion = std::min<unsigned int>(apiVersion, PHASEVOCODER_ENGINE_API_VERSION);
+	options->stretchFactor = 0.0;
+	options->pitchShift = 0.0;
+	options->resampleRate = 0;
+	options->valleyToPeakRatio = 0.0;
+	options->quality = PHASEVOCODER_ENGINE_QUALITY_HIGH;
+
+	if(apiVersion >= 2)
+	{
+		options->dither = 0;
+	}
+}
+
+int PhaseVocoderEngine_Process(const PhaseVocoderEngineOptions* options, const PhaseVocoderEngineBuffer* input, PhaseVocoderEngineBuffer* output)
+{
+	auto error{ValidateArguments(options, input, output)};
+	if(!error.empty())
+	{
+		return Fail(PHASEVOCODER_ENGINE_INVALID_ARGUMENT, error);
+	}
+
+	*output = PhaseVocoderEngineBuffer{nullptr, 0, 0, 0};
+
+	try
+	{
+		auto settings{GetPhaseVocoderSettings(*options)};
+		auto audioInput{std::make_shared<AudioBufferInput>(Deinterleave(*input), input->sampleRate, 16)};
+		auto audioOutput{std::make_shared<AudioBufferOutput>(input->channelCount)};
+
+		PhaseVocoderMediator phaseVocoderMediator(settings, audioInput, std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+		phaseVocoderMediator.Process();
+
+		bool dither{options->apiVersion >= 2 && options->dither};
+		Interleave(audioOutput->GetChannels(), dither, *output);
+		output->sampleRate = options->resampleRate ? options->resampleRate : input->sampleRate;
+	}
+	catch(Utilities::Exception& exception)
+	{
+		return Fail(PHASEVOCODER_ENGINE_PROCESSING_ERROR, exception.what());
+	}
+	catch(std::exception& exception)
+	{
+		return Fail(PHASEVOCODER_ENGINE_PROCESSING_ERROR, exception.what());
+	}
+	catch(...)
+	{
+		return Fail(PHASEVOCODER_ENGINE_PROCESSING_ERROR, "Unknown error");
+	}
+
+	lastError.clear();
+	return PHASEVOCODER_ENGINE_OK;
+}
+
+void PhaseVocoderEngine_FreeBuffer(PhaseVocoderEngineBuffer* buffer)
+{
+	if(!buffer)
+	{
+		return;
+	}
+
+	delete[] buffer->samples;
+	*buffer = PhaseVocoderEngineBuffer{nullptr, 0, 0, 0};
+}
+
+const char* PhaseVocoderEngine_GetLastError(void)
+{
+	return lastError.c_str();
+}
@@ -0,0 +1,101 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+// A C API for processing audio in memory with the PhaseVocoder engine, for applications embedding it 
+// rather than running the PhaseVocoder executable.
+//
+// Audio is given and returned as interleaved 16 bit PCM (mono or stereo).  Every call is independent 
+// of every other, so calls may be made from multiple threads at once.
+//
+// Typical use:
+//     PhaseVocoderEngineOptions options;
+//     PhaseVocoderEngine_InitOptions(&options);
+//     options.stretchFactor = 1.25;
+//
+//     PhaseVocoderEngineBuffer output;
+//     if(PhaseVocoderEngine_Process(&options, &input, &output) != PHASEVOCODER_ENGINE_OK)
+//     {
+//         printf("%s\n", PhaseVocoderEngine_GetLastError());
+//     }
+//     ...
+//     PhaseVocoderEngine_FreeBuffer(&output);
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever the options struct gains fields, so an engine can tell which fields a caller knows of
+#define PHASEVOCODER_ENGINE_API_VERSION 2
+
+#define PHASEVOCODER_ENGINE_OK 0
+#define PHASEVOCODER_ENGINE_INVALID_ARGUMENT 1
+#define PHASEVOCODER_ENGINE_PROCESSING_ERROR 2
+
+#define PHASEVOCODER_ENGINE_QUALITY_HIGH 0
+#define PHASEVOCODER_ENGINE_QUALITY_MEDIUM 1
+#define PHASEVOCODER_ENGINE_QUALITY_DRAFT 2
+
+typedef struct PhaseVocoderEngineOptions
+{
+	unsigned int apiVersion;       // Set by PhaseVocoderEngine_InitOptions
+	double stretchFactor;          // 0.0 for no stretching
+	double pitchShift;             // In semitones.  0.0 for no pitch shift.
+	unsigned int resampleRate;     // Output sample rate.  0 to keep the input's sample rate.
+	double valleyToPeakRatio;      // Transient detection sensitivity.  0.0 for the default.
+	int quality;                   // One of the PHASEVOCODER_ENGINE_QUALITY values
+	int dither;                    // Since version 2.  Non-zero adds TPDF dither when converting the output to PCM.
+} PhaseVocoderEngineOptions;
+
+typedef struct PhaseVocoderEngineBuffer
+{
+	int16_t* samples;              // Interleaved
+	size_t frameCount;             // Samples per channel
+	unsigned int channelCount;     // 1 or 2
+	unsigned int sampleRate;
+} PhaseVocoderEngineBuffer;
+
+// Sets every option known to the given API version to its default (no processing).  Callers use the 
+// PhaseVocoderEngine_InitOptions macro so only the fields their options struct has are written.
+void PhaseVocoderEngine_InitOptionsVersion(PhaseVocoderEngineOptions* options, unsigned int apiVersion);
+#define PhaseVocoderEngine_InitOptions(options) PhaseVocoderEngine_InitOptionsVersion((options), PHASEVOCODER_ENGINE_API_VERSION)
+
+// On success the output buffer's samples are allocated by the engine and must be released with 
+// PhaseVocoderEngine_FreeBuffer.  On failure the output buffer is left empty.
+int PhaseVocoderEngine_Process(const PhaseVocoderEngineOptions* options, const PhaseVocoderEngineBuffer* input, PhaseVocoderEngineBuffer* output);
+
+void PhaseVocoderEngine_FreeBuffer(PhaseVocoderEngineBuffer* buffer);
+
+// Describes the last failure on the calling thread
+const char* PhaseVocoderEngine_GetLastError(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -27,17 +27,51 @@
 #include <Application/PhaseVocoderMediator.h>
 #include <Application/PhaseVocoderProcessor.h>
 #include <Application/Transients.h>
+#include <Application/CachingAudioInput.h>
+#include <Application/Trace.h>
+#include <Application/PrefetchingAudioInput.h>
 #include <Signal/PhaseVocoder.h>
 #include <Utilities/Exception.h>
 #include <Utilities/Timer.h>
 #include <thread>
+#include <exception>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
 
 PhaseVocoderMediator::PhaseVocoderMediator(const PhaseVocoderSettings& settings) : settings_{settings}
 {
 	InstantiateAudioFileObjects();
 }
 
-PhaseVocoderMediator::~PhaseVocoderMediator() { }
+PhaseVocoderMediator::PhaseVocoderMediator(const PhaseVocoderSettings& settings, std::shared_ptr<AudioInput> audioInput, 
+											const std::vector<std::shared_ptr<AudioOutput>>& audioOutputs) : 
+	audioInput_{audioInput}, audioOutputs_{audioOutputs}, settings_{settings}
+{
+	if(settings_.TransientCacheDirectoryGiven() || settings_.IncrementalRender())
+	{
+		Utilities::ThrowException("The transient cache and incremental rendering need a wave file input and output");
+	}
+
+	// Bounding the buffering of the given outputs is left to the caller
+	if(settings_.MaxMemoryGiven())
+	{
+		ApplyMemoryBudget(0);
+	}
+}
+
+// An incremental render that didn't finish leaves the previous output as it was.  Only its partial output 
+// is removed.
+PhaseVocoderMediator::~PhaseVocoderMediator()
+{
+	if(!partialOutputFilename_.empty())
+	{
+		CloseOutputs();
+		std::remove(partialOutputFilename_.c_str());
+	}
+}
 
 void PhaseVocoderMediator::InstantiateAudioFileObjects()
 {
@@ -46,54 +80,462 @@ void PhaseVocoderMediator::InstantiateAudioFileObjects()
 		Utilities::ThrowException("No input wave file given to PhaseVocoderProcessor");
 	}
 
-	audioFileReader_.reset(new ThreadSafeAudioFile::Reader{settings_.GetInputWaveFile()});
+	// AudioLib's reader handles plain 16 bit mono and stereo files.  Anything else goes through our own.
+	inputWaveFormat_ = WaveFormat::Read(settings_.GetInputWaveFile());
+	if(inputWaveFormat_.IsPlain16Bit())
+	{
+		audioInput_.reset(new AudioFileInput{settings_.GetInputWaveFile()});
+	}
+	else
+	{
+		audioInput_.reset(new WaveFileInput{settings_.GetInputWaveFile()});
+	}
+
+	// A cache miss reads every channel through ReadAudio, which only saves work when that's a single pass.  
+	// AudioFileInput reads each channel separately, so it isn't cached.
+	auto inputCached{audioInput_->ReadsAudioInOnePass()};
+	if(inputCached)
+	{
+		auto cachingAudioInput{std::make_shared<CachingAudioInput>(audioInput_, inputCacheBlocks_, inputBlockSize_)};
+		cachingAudioInput->SetMemoryAccounting(memoryAccounting_);
+		audioInput_ = cachingAudioInput;
+	}
+
+	if(settings_.ReadAheadGiven())
+	{
+		auto prefetchingAudioInput{std::make_shared<PrefetchingAudioInput>(audioInput_, settings_.GetReadAheadBlocks(), inputBlockSize_)};
+		prefetchingAudioInput->SetMemoryAccounting(memoryAccounting_);
+		audioInput_ = prefetchingAudioInput;
+	}
+
+	if(settings_.MaxMemoryGiven())
+	{
+		auto inputBlocks{(inputCached ? inputCacheBlocks_ : 0) + (settings_.ReadAheadGiven() ? settings_.GetReadAheadBlocks() : 0)};
+		ApplyMemoryBudget(inputBlocks * inputBlockSize_ * audioInput_->GetChannels() * sizeof(double));
+	}
+
+	if(settings_.TransientCacheDirectoryGiven() || settings_.IncrementalRender())
+	{
+		inputHash_ = TransientCache::HashFile(settings_.GetInputWaveFile());
+	}
+
+	if(settings_.TransientCacheDirectoryGiven())
+	{
+		transientCache_ = std::make_shared<TransientCache>(settings_.GetTransientCacheDirectory(), inputHash_);
+	}
+
+	if(settings_.IncrementalRender())
+	{
+		InstantiateIncrementalRender();
+	}
 
 	if(settings_.OutputWaveFileGiven())
 	{
-		std::size_t outputSampleRate{audioFileReader_->GetSampleRate()};
+		std::size_t outputSampleRate{audioInput_->GetSampleRate()};
 		if(settings_.ResampleValueGiven())
 		{
 			outputSampleRate = settings_.GetResampleValue();
 		}
 	
-		audioFileWriter_.reset(new ThreadSafeAudioFile::Writer(settings_.GetOutputWaveFile(), 
-																static_cast<uint16_t>(audioFileReader_->GetChannels()), 
-																static_cast<uint32_t>(outputSampleRate), 
-																static_cast<uint16_t>(audioFileReader_->GetBitsPerSample())));
+		std::vector<std::string> outputFilenames{partialOutputFilename_.empty() ? settings_.GetOutputWaveFile() : partialOutputFilename_};
+		if(settings_.MultipleStretchFactorsGiven())
+		{
+			outputFilenames.clear();
+			for(auto stretchFactor : settings_.GetStretchFactors())
+			{
+				outputFilenames.push_back(GetOutputFilenameForStretchFactor(settings_.GetOutputWaveFile(), stretchFactor));
+				if(std::count(outputFilenames.begin(), outputFilenames.end(), outputFilenames.back()) > 1)
+				{
+					Utilities::ThrowException("Stretch factor given more than once", stretchFactor);
+				}
+			}
+		}
+
+		// Output is written in the same sample format as the input.  Only our own writer can bound its 
+		// buffering, so it's used for every format when there's a memory budget.
+		auto stretchFactors{GetStretchFactors()};
+		for(std::size_t i{0}; i < outputFilenames.size(); ++i)
+		{
+			const auto& outputFilename{outputFilenames[i]};
+			if(settings_.MaxMemoryGiven() || !inputWaveFormat_.IsPlain16Bit())
+			{
+				auto waveFileOutput{std::make_shared<WaveFileOutput>(outputFilename, audioInput_->GetChannels(), outputSampleRate, 
+																audioInput_->GetBitsPerSample(), inputWaveFormat_.sampleFormat_)};
+				waveFileOutput->SetMemoryAccounting(memoryAccounting_);
+				if(settings_.MaxMemoryGiven())
+				{
+					waveFileOutput->SetBufferLimit(GetOutputBufferLimit(stretchFactors[i]));
+				}
+
+				audioOutputs_.push_back(waveFileOutput);
+			}
+			else
+			{
+				audioOutputs_.push_back(std::make_shared<AudioFileOutput>(outputFilename, 
+																	static_cast<uint16_t>(audioInput_->GetChannels()), 
+																	static_cast<uint32_t>(outputSampleRate), 
+																	static_cast<uint16_t>(audioInput_->GetBitsPerSample())));
+				audioLibOutputs_ = true;
+			}
+		}
+	}
+	else
+	{
+		// Only displaying transients.  The processors still expect a (null) writer per stretch factor.
+		audioOutputs_.resize(std::max<std::size_t>(settings_.GetStretchFactors().size(), 1));
 	}
 }
+
+// Splits the memory budget left after the input buffering between the channels and their outputs.  Each 
+// output has a PhaseVocoder sized by its section, and a writer which may buffer a couple of sections of 
+// one channel's output ahead of the other channels.  
+// A writer allowed to buffer more than a section can't deadlock the processors' per section hand-offs.
+void PhaseVocoderMediator::ApplyMemoryBudget(std::size_t inputBufferBytes)
+{
+	auto budget{static_cast<double>(settings_.GetMaxMemory()) * 1024.0 * 1024.0 - static_cast<double>(inputBufferBytes)};
+
+	auto pitchShiftRatio{settings_.PitchShiftValueGiven() ? std::pow(2.0, std::abs(settings_.GetPitchShiftValue()) / 12.0) : 1.0};
+
+	double bytesPerSectionSample{0.0};
+	for(auto stretchFactor : GetStretchFactors())
+	{
+		bytesPerSectionSample += PhaseVocoderProcessor::EstimatePhaseVocoderBytes(1.0, stretchFactor * pitchShiftRatio) + 
+									sizeof(double) * outputSectionsBuffered_ * stretchFactor * GetOutputRateRatio();
+	}
+
+	auto maxSectionLength{budget / (bytesPerSectionSample * static_cast<double>(audioInput_->GetChannels()))};
+	if(maxSectionLength < static_cast<double>(minimumSectionLength_))
+	{
+		Utilities::ThrowException("Memory budget (in MB) too small for the input and outputs given", settings_.GetMaxMemory());
+	}
+
+	maxSectionLength_ = static_cast<std::size_t>(maxSectionLength);
+}
+
+std::size_t PhaseVocoderMediator::GetOutputBufferLimit(double stretchFactor)
+{
+	return static_cast<std::size_t>(outputSectionsBuffered_ * static_cast<double>(maxSectionLength_) * stretchFactor * GetOutputRateRatio());
+}
+
+double PhaseVocoderMediator::GetOutputRateRatio()
+{
+	if(!settings_.ResampleValueGiven())
+	{
+		return 1.0;
+	}
+
+	return static_cast<double>(settings_.GetResampleValue()) / static_cast<double>(audioInput_->GetSampleRate());
+}
+
+std::vector<double> PhaseVocoderMediator::GetStretchFactors() const
+{
+	if(!settings_.StretchFactorGiven())
+	{
+		return std::vector<double>{1.0};
+	}
+
+	return settings_.GetStretchFactors();
+}
+
+std::shared_ptr<const MemoryAccounting> PhaseVocoderMediator::GetMemoryAccounting() const
+{
+	return memoryAccounting_;
+}
+
+std::size_t PhaseVocoderMediator::GetMaxSectionLength() const
+{
+	return maxSectionLength_;
+}
+
+// The new output is rendered next to the previous one, which (if it and its manifest exist and were made 
+// with the same settings) its unchanged sections are copied from.  It replaces the previous output once 
+// it's complete.
+void PhaseVocoderMediator::InstantiateIncrementalRender()
+{
+	if(!settings_.OutputWaveFileGiven() || !settings_.StretchFactorGiven() || settings_.MultipleStretchFactorsGiven() || 
+		settings_.PitchShiftValueGiven() || settings_.ResampleValueGiven() || settings_.RenderRangeGiven() || 
+		settings_.GetQualityPreset() != PhaseVocoderSettings::QualityPreset::HIGH)
+	{
+		Utilities::ThrowException("Incremental rendering only supports stretching the whole input to a single output");
+	}
+
+	auto settingsHash{GetSettingsHash()};
+	renderManifest_ = std::make_shared<RenderManifest>(audioInput_->GetChannels(), settingsHash);
+	partialOutputFilename_ = settings_.GetOutputWaveFile() + ".partial";
+
+	auto manifestFilename{GetRenderManifestFilename(settings_.GetOutputWaveFile())};
+	if(!std::ifstream(manifestFilename) || !std::ifstream(settings_.GetOutputWaveFile()))
+	{
+		return;
+	}
+
+	auto previousRenderManifest{std::make_shared<RenderManifest>(manifestFilename)};
+	if(previousRenderManifest->GetSettingsHash() != settingsHash || previousRenderManifest->GetStreamCount() != audioInput_->GetChannels())
+	{
+		return;
+	}
+
+	previousRenderManifest_ = previousRenderManifest;
+	if(inputWaveFormat_.IsPlain16Bit())
+	{
+		previousOutput_.reset(new AudioFileInput{settings_.GetOutputWaveFile()});
+	}
+	else
+	{
+		previousOutput_.reset(new WaveFileInput{settings_.GetOutputWaveFile()});
+	}
+}
+
+// Anything that changes the output of every section (as opposed to the section bounds) goes in here
+std::string PhaseVocoderMediator::GetSettingsHash()
+{
+	std::ostringstream settingsString;
+	settingsString << "version:1";
+	settingsString << " input:" << std::hex << inputHash_ << std::dec;
+	settingsString << " stretch:" << std::hexfloat << settings_.GetStretchFactor() << std::defaultfloat;
+	settingsString << " sampleRate:" << audioInput_->GetSampleRate();
+	settingsString << " bitsPerSample:" << audioInput_->GetBitsPerSample();
+	if(inputWaveFormat_.sampleFormat_ == WaveFormat::SampleFormat::FLOATING_POINT)
+	{
+		settingsString << " floatingPoint";
+	}
+
+	return RenderManifest::HashString(settingsString.str());
+}
+
+std::string PhaseVocoderMediator::GetRenderManifestFilename(const std::string& outputFilename)
+{
+	return outputFilename + ".manifest";
+}
+
+// The processors check the range too, but by then they're running on the channel threads
+void PhaseVocoderMediator::ValidateRenderRange()
+{
+	std::size_t rangeStart{0};
+	if(settings_.RangeStartGiven())
+	{
+		rangeStart = settings_.GetRangeStartSample(audioInput_->GetSampleRate());
+	}
+
+	std::size_t rangeEnd{audioInput_->GetSampleCount()};
+	if(settings_.RangeEndGiven())
+	{
+		rangeEnd = std::min(rangeEnd, settings_.GetRangeEndSample(audioInput_->GetSampleRate()));
+	}
+
+	if(rangeStart >= rangeEnd)
+	{
+		Utilities::ThrowException("Render range start must come before the range end and the end of input", rangeStart, rangeEnd);
+	}
+}
+
+void PhaseVocoderMediator::ConfigureProcessor(PhaseVocoderProcessor& processor)
+{
+	processor.SetTransientCache(transientCache_);
+	processor.SetMaxSectionLength(maxSectionLength_);
+	processor.SetMemoryAccounting(memoryAccounting_);
+	processor.SetProgressTracker(progressTracker_);
+
+	if(renderManifest_)
+	{
+		processor.SetIncrementalRender(renderManifest_, previousRenderManifest_, previousOutput_);
+	}
+}
+
+// The previous manifest goes first so a failure part way through can't leave a manifest describing the 
+// wrong output.  Without one the next render is a full one.
+void PhaseVocoderMediator::FinishIncrementalRender()
+{
+	CloseOutputs();
+	previousOutput_.reset();
+
+	auto manifestFilename{GetRenderManifestFilename(settings_.GetOutputWaveFile())};
+	std::remove(manifestFilename.c_str());
+
+	// Renaming over an existing file fails on Windows
+	const auto& outputFilename{settings_.GetOutputWaveFile()};
+	if(std::rename(partialOutputFilename_.c_str(), outputFilename.c_str()) != 0)
+	{
+		std::remove(outputFilename.c_str());
+		if(std::rename(partialOutputFilename_.c_str(), outputFilename.c_str()) != 0)
+		{
+			Utilities::ThrowException("Unable to replace the output with the incremental render", outputFilename);
+		}
+	}
+
+	partialOutputFilename_.clear();
+	renderManifest_->Save(manifestFilename);
+}
+
+// The wave file outputs finish their files when they're destroyed
+void PhaseVocoderMediator::CloseOutputs()
+{
+	maxBufferedSamples_ = GetMaxBufferedSamples();
+	for(auto& audioOutput : audioOutputs_)
+	{
+		audioOutput.reset();
+	}
+}
+
+std::string PhaseVocoderMediator::GetOutputFilenameForStretchFactor(const std::string& outputFilenamePattern, double stretchFactor)
+{
+	const std::string placeholder{"%s"};
+
+	auto position{outputFilenamePattern.find(placeholder)};
+	if(position == std::string::npos)
+	{
+		Utilities::ThrowException("Output filename has no %s placeholder for the stretch factor", outputFilenamePattern);
+	}
+
+	std::ostringstream stretchFactorString;
+	stretchFactorString << stretchFactor;
+
+	std::string outputFilename{outputFilenamePattern};
+	outputFilename.replace(position, placeholder.size(), stretchFactorString.str());
+
+	return outputFilename;
+}
+void PhaseVocoderMediator::SetProgressCallback(ProgressCallback progressCallback, double reportInterval)
+{
+	progressCallback_ = progressCallback;
+	progressReportInterval_ = reportInterval;
+}
+
 void PhaseVocoderMediator::Process()
 {
 	Utilities::Timer timer(Utilities::Timer::Action::START_NOW);
 
-	if(audioFileReader_->GetChannels() == 1)
+	if(settings_.RenderRangeGiven())
+	{
+		ValidateRenderRange();
+	}
+
+	if(progressCallback_)
 	{
-		PhaseVocoderProcessor processor(0, settings_, audioFileReader_, audioFileWriter_);
+		progressTracker_ = std::make_shared<ProgressTracker>(audioInput_->GetChannels(), audioInput_->GetSampleRate(), progressCallback_, progressReportInterval_);
+	}
+
+	if(audioInput_->GetChannels() == 1)
+	{
+		PhaseVocoderProcessor processor(0, settings_, audioInput_, audioOutputs_);
+		ConfigureProcessor(processor);
 		processor.Process();
 		transients_.push_back(processor.GetTransients());
+
+		sectionsRendered_ = processor.GetSectionsRendered();
+		sectionsReused_ = processor.GetSectionsReused();
+		sectionsMerged_ = processor.GetSectionsMerged();
+		sectionOverheadTime_ = processor.GetSectionOverheadTime();
 	}
-	else if(audioFileReader_->GetChannels() == 2)
+	else
 	{
-		PhaseVocoderProcessor leftChannelProcessor(0, settings_, audioFileReader_, audioFileWriter_);
-		PhaseVocoderProcessor rightChannelProcessor(1, settings_, audioFileReader_, audioFileWriter_);
-	
-		auto leftChannelThread{std::thread([&]{leftChannelProcessor.Process();})};
-		auto rightChannelThread{std::thread([&]{rightChannelProcessor.Process();})};
+		// One processor and thread per channel
+		std::vector<std::unique_ptr<PhaseVocoderProcessor>> channelProcessors;
+		for(std::size_t streamID{0}; streamID < audioInput_->GetChannels(); ++streamID)
+		{
+			channelProcessors.emplace_back(new PhaseVocoderProcessor(streamID, settings_, audioInput_, audioOutputs_));
+			ConfigureProcessor(*channelProcessors.back());
+		}
 
-		leftChannelThread.join();
-		rightChannelThread.join();
+		// An exception escaping a thread would terminate the process, so each channel's is kept and 
+		// rethrown here once all the threads are done
+		std::vector<std::thread> channelThreads;
+		std::vector<std::exception_ptr> channelExceptions(channelProcessors.size());
+		for(auto& channelProcessor : channelProcessors)
+		{
+			auto processor{channelProcessor.get()};
+			auto channelException{&channelExceptions[channelThreads.size()]};
+			auto channelName{"Channel " + std::to_string(channelThreads.size() + 1)};
+			channelThreads.push_back(std::thread([processor, channelException, channelName]
+			{
+				try
+				{
+					if(Trace::IsRecording())
+					{
+						Trace::SetThreadName(channelName);
+					}
+
+					processor->Process();
+				}
+				catch(...)
+				{
+					*channelException = std::current_exception();
+				}
+			}));
+		}
 
-		transients_.push_back(leftChannelProcessor.GetTransients());
-		transients_.push_back(rightChannelProcessor.GetTransients());
+		for(auto& channelThread : channelThreads)
+		{
+			channelThread.join();
+		}
+
+		for(const auto& channelException : channelExceptions)
+		{
+			if(channelException)
+			{
+				std::rethrow_exception(channelException);
+			}
+		}
+
+		for(auto& channelProcessor : channelProcessors)
+		{
+			transients_.push_back(channelProcessor->GetTransients());
+			sectionsRendered_ += channelProcessor->GetSectionsRendered();
+			sectionsReused_ += channelProcessor->GetSectionsReused();
+			sectionsMerged_ += channelProcessor->GetSectionsMerged();
+			sectionOverheadTime_ += channelProcessor->GetSectionOverheadTime();
+		}
 	}
-	else
+
+	// AudioLib's writer only reports its high water mark, so that's recorded as its peak once it's done
+	if(audioLibOutputs_)
 	{
-		Utilities::ThrowException("PhaseVocoder only handles mono or stereo audio data");	
+		for(const auto& audioOutput : audioOutputs_)
+		{
+			auto bufferedBytes{audioOutput->GetMaxBufferedSamples() * sizeof(double)};
+			memoryAccounting_->Add(MemoryAccounting::Stage::WRITER, MemoryAccounting::allStreams, bufferedBytes);
+			memoryAccounting_->Remove(MemoryAccounting::Stage::WRITER, MemoryAccounting::allStreams, bufferedBytes);
+		}
+	}
+
+	if(renderManifest_)
+	{
+		FinishIncrementalRender();
+	}
+
+	if(progressTracker_)
+	{
+		progressTracker_->Finish();
 	}
 
 	totalProcessingTime_ = timer.Stop();
 }
 
+std::size_t PhaseVocoderMediator::GetSectionsRendered() const
+{
+	return sectionsRendered_;
+}
+
+std::size_t PhaseVocoderMediator::GetSectionsReused() const
+{
+	return sectionsReused_;
+}
+
+std::size_t PhaseVocoderMediator::GetSectionsMerged() const
+{
+	return sectionsMerged_;
+}
+
+double PhaseVocoderMediator::GetMergeTimeSaved() const
+{
+	if(sectionsRendered_ == 0)
+	{
+		return 0.0;
+	}
+
+	return sectionOverheadTime_ / static_cast<double>(sectionsRendered_) * static_cast<double>(sectionsMerged_);
+}
+
 double PhaseVocoderMediator::GetTotalProcessingTime()
 {
 	return totalProcessingTime_;
@@ -101,13 +543,18 @@ double PhaseVocoderMediator::GetTotalProcessingTime()
 
 std::size_t PhaseVocoderMediator::GetChannelCount() const
 {
-	return audioFileReader_->GetChannels();	
+	return audioInput_->GetChannels();	
 }
 
 std::size_t PhaseVocoderMediator::GetMaxBufferedSamples()
 {
-	if(audioFileWriter_) return audioFileWriter_->GetMaxBufferedSamples();
-	else return 0;
+	std::size_t maxBufferedSamples{maxBufferedSamples_};
+	for(const auto& audioOutput : audioOutputs_)
+	{
+		if(audioOutput) maxBufferedSamples = std::max(maxBufferedSamples, audioOutput->GetMaxBufferedSamples());
+	}
+
+	return maxBufferedSamples;
 }
 
 const std::vector<std::size_t>& PhaseVocoderMediator::GetTransients(std::size_t streamID)
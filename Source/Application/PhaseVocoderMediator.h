@@ -25,36 +25,118 @@
  */
 
 #include <Application/PhaseVocoderSettings.h>
-#include <ThreadSafeAudioFile/Reader.h>
-#include <ThreadSafeAudioFile/Writer.h>
+#include <Application/TransientCache.h>
+#include <Application/RenderManifest.h>
+#include <Application/AudioInput.h>
+#include <Application/AudioOutput.h>
+#include <Application/MemoryAccounting.h>
+#include <Application/Progress.h>
+
+class PhaseVocoderProcessor;
 
 class PhaseVocoderMediator
 {
 	public:
 		PhaseVocoderMediator(const PhaseVocoderSettings& settings);
+
+		// Processes audio given in memory rather than wave files.  One output is needed per stretch factor.  
+		// The transient cache and incremental rendering aren't available as they're file based.
+		PhaseVocoderMediator(const PhaseVocoderSettings& settings, std::shared_ptr<AudioInput> audioInput, 
+								const std::vector<std::shared_ptr<AudioOutput>>& audioOutputs);
 		virtual ~PhaseVocoderMediator();
 
 		void InstantiateAudioFileObjects();
+
+		// Optional.  While processing, the callback is given the progress of each channel at most once 
+		// per report interval (in seconds), and once more when the render is done.
+		void SetProgressCallback(ProgressCallback progressCallback, double reportInterval);
+
 		void Process();
 
+		// When multiple stretch factors are given, the output filename is treated as a pattern.  The 
+		// "%s" placeholder within it is replaced by each stretch factor.
+		static std::string GetOutputFilenameForStretchFactor(const std::string& outputFilenamePattern, double stretchFactor);
+
 		std::size_t GetChannelCount() const;
 
-		std::size_t GetMaxBufferedSamples();  // High water mark for stereo data buffered
+		std::size_t GetMaxBufferedSamples();  // High water mark for stereo data buffered (max across all outputs)
 
 		const std::vector<std::size_t>& GetTransients(std::size_t streamID);
 
+		// Current and peak memory held by each stage of processing
+		std::shared_ptr<const MemoryAccounting> GetMemoryAccounting() const;
+
+		// Only set when a memory budget is given.  In input samples.
+		std::size_t GetMaxSectionLength() const;
+
+		// Only meaningful for incremental renders.  Sections are counted across all channels.
+		std::size_t GetSectionsRendered() const;
+		std::size_t GetSectionsReused() const;
+
+		// Only non-zero when a minimum section length is given.  Counted across all channels.
+		std::size_t GetSectionsMerged() const;
+
+		// An estimate, in seconds of processing summed across channels, taking each merged section to have 
+		// cost what the rendered ones did on average to set up and flush
+		double GetMergeTimeSaved() const;
+
+		static std::string GetRenderManifestFilename(const std::string& outputFilename);
+
 		double GetTotalProcessingTime();
 		double GetTransientProcessingTime();
 		double GetPhaseVocoderProcessingTime();
 		double GetResamplerProcessingTime();
 
 	private:
-		std::shared_ptr<ThreadSafeAudioFile::Reader> audioFileReader_;
-		std::shared_ptr<ThreadSafeAudioFile::Writer> audioFileWriter_;
+		void InstantiateIncrementalRender();
+		void ApplyMemoryBudget(std::size_t inputBufferBytes);
+		std::size_t GetOutputBufferLimit(double stretchFactor);
+		double GetOutputRateRatio();
+		std::vector<double> GetStretchFactors() const;
+		void ValidateRenderRange();
+		void ConfigureProcessor(PhaseVocoderProcessor& processor);
+		void FinishIncrementalRender();
+		void CloseOutputs();
+		std::string GetSettingsHash();
+
+		WaveFormat inputWaveFormat_;  // Only set when reading from a wave file
+		std::shared_ptr<AudioInput> audioInput_;
+		std::vector<std::shared_ptr<AudioOutput>> audioOutputs_;  // One per stretch factor
+		bool audioLibOutputs_{false};
+
+		std::shared_ptr<MemoryAccounting> memoryAccounting_{std::make_shared<MemoryAccounting>()};
+
+		ProgressCallback progressCallback_;
+		double progressReportInterval_{1.0};
+		std::shared_ptr<ProgressTracker> progressTracker_;
 
 		std::vector<std::vector<std::size_t>> transients_;
 
+		std::shared_ptr<TransientCache> transientCache_;
+		uint64_t inputHash_{0};  // Of the input file's content, taken once for the transient cache and incremental render
+
+		std::shared_ptr<RenderManifest> renderManifest_;
+		std::shared_ptr<const RenderManifest> previousRenderManifest_;
+		std::shared_ptr<AudioInput> previousOutput_;
+		std::string partialOutputFilename_;  // Set while an incremental render is under way
+		std::size_t maxBufferedSamples_{0};  // For outputs already closed
+		std::size_t sectionsRendered_{0};
+		std::size_t sectionsReused_{0};
+		std::size_t sectionsMerged_{0};
+		double sectionOverheadTime_{0.0};
+
 		PhaseVocoderSettings settings_;
 
+		// Input blocks (of 8192 samples) cached for all channels, when the input reads them in one pass.  This 
+		// holds about 12 seconds of 44.1kHz audio, so short inputs are only read once for both transient 
+		// detection and processing.
+		const std::size_t inputCacheBlocks_{64};
+		const std::size_t inputBlockSize_{8192};
+
+		// Memory budget estimates (see ApplyMemoryBudget)
+		std::size_t maxSectionLength_{0};
+		const double outputSectionsBuffered_{2.0};
+		const std::size_t minimumSectionLength_{32768};
+
 		double totalProcessingTime_{0.0};
 };
\ No newline at end of file
@@ -26,27 +26,38 @@
 
 #include <Application/PhaseVocoderProcessor.h>
 #include <Application/Transients.h>
+#include <Application/Trace.h>
 #include <WaveFile/WaveFileReader.h>
 #include <WaveFile/WaveFileWriter.h>
 #include <Signal/PhaseVocoder.h>
 #include <Signal/Resampler.h>
-#include <ThreadSafeAudioFile/Reader.h>
-#include <ThreadSafeAudioFile/Writer.h>
 #include <Utilities/Exception.h>
+#include <Utilities/Stringify.h>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 PhaseVocoderProcessor::PhaseVocoderProcessor(std::size_t streamID, 
 	const PhaseVocoderSettings& settings, 
-	std::shared_ptr<ThreadSafeAudioFile::Reader> audioFileReader, 
-	std::shared_ptr<ThreadSafeAudioFile::Writer> audioFileWriter) :
+	std::shared_ptr<AudioInput> audioFileReader, 
+	std::shared_ptr<AudioOutput> audioOutput) :
 		streamID_{streamID}, 
 		settings_{settings}, 
-		audioFileReader_{audioFileReader}, 
-		audioFileWriter_{audioFileWriter}
+		audioInput_{audioFileReader}
 {
+	InstantiateOutputs(std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+}
 
+PhaseVocoderProcessor::PhaseVocoderProcessor(std::size_t streamID, 
+	const PhaseVocoderSettings& settings, 
+	std::shared_ptr<AudioInput> audioFileReader, 
+	const std::vector<std::shared_ptr<AudioOutput>>& audioOutputs) :
+		streamID_{streamID}, 
+		settings_{settings}, 
+		audioInput_{audioFileReader}
+{
+	InstantiateOutputs(audioOutputs);
 }
 
 PhaseVocoderProcessor::~PhaseVocoderProcessor()
@@ -54,9 +65,127 @@ PhaseVocoderProcessor::~PhaseVocoderProcessor()
 
 }
 
+void PhaseVocoderProcessor::InstantiateOutputs(const std::vector<std::shared_ptr<AudioOutput>>& audioOutputs)
+{
+	std::vector<double> stretchFactors{1.0};
+	if(settings_.StretchFactorGiven())
+	{
+		stretchFactors = settings_.GetStretchFactors();
+	}
+
+	if(audioOutputs.size() != stretchFactors.size())
+	{
+		Utilities::ThrowException("PhaseVocoderProcessor needs one writer per stretch factor", audioOutputs.size(), stretchFactors.size());
+	}
+
+	outputs_.resize(stretchFactors.size());
+	for(std::size_t i{0}; i < outputs_.size(); ++i)
+	{
+		outputs_[i].stretchFactor_ = stretchFactors[i];
+		outputs_[i].audioOutput_ = audioOutputs[i];
+	}
+}
+
+void PhaseVocoderProcessor::SetTransientCache(std::shared_ptr<TransientCache> transientCache)
+{
+	transientCache_ = transientCache;
+}
+
+void PhaseVocoderProcessor::SetIncrementalRender(std::shared_ptr<RenderManifest> renderManifest, 
+													std::shared_ptr<const RenderManifest> previousRenderManifest, 
+													std::shared_ptr<AudioInput> previousOutput)
+{
+	if(outputs_.size() != 1)
+	{
+		Utilities::ThrowException("Incremental rendering only supports a single output");
+	}
+
+	renderManifest_ = renderManifest;
+	previousRenderManifest_ = previousRenderManifest;
+	previousOutput_ = previousOutput;
+}
+
+void PhaseVocoderProcessor::SetMaxSectionLength(std::size_t maxSectionLength)
+{
+	maxSectionLength_ = maxSectionLength;
+}
+
+void PhaseVocoderProcessor::SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting)
+{
+	memoryAccounting_ = memoryAccounting;
+}
+
+void PhaseVocoderProcessor::SetProgressTracker(std::shared_ptr<ProgressTracker> progressTracker)
+{
+	progressTracker_ = progressTracker;
+}
+
+double PhaseVocoderProcessor::EstimatePhaseVocoderBytes(double sectionLength, double stretchFactor)
+{
+	const double copies{2.0};
+	return copies * sectionLength * (1.0 + stretchFactor) * sizeof(double);
+}
+
+std::size_t PhaseVocoderProcessor::GetSectionsRendered() const
+{
+	return sectionsRendered_;
+}
+
+std::size_t PhaseVocoderProcessor::GetSectionsReused() const
+{
+	return sectionsReused_;
+}
+
+std::size_t PhaseVocoderProcessor::GetSectionsMerged() const
+{
+	return sectionsMerged_;
+}
+
+double PhaseVocoderProcessor::GetSectionOverheadTime() const
+{
+	return sectionOverheadTime_;
+}
+
 void PhaseVocoderProcessor::Process()
 {
-	InstantiateResampler();
+	try
+	{
+		StartOutputWorkers();
+		ProcessAudio();
+	}
+	catch(...)
+	{
+		StopOutputWorkers();
+		FinishOutputStreams();
+		throw;
+	}
+
+	StopOutputWorkers();
+
+	FinishOutputStreams();
+
+	if(progressTracker_)
+	{
+		progressTracker_->StreamFinished(streamID_);
+	}
+}
+
+// Lets the outputs know this stream is done so they stop holding back other streams waiting for it
+void PhaseVocoderProcessor::FinishOutputStreams()
+{
+	for(auto& output : outputs_)
+	{
+		if(output.audioOutput_)
+		{
+			output.audioOutput_->FinishStream(streamID_);
+		}
+	}
+}
+
+void PhaseVocoderProcessor::ProcessAudio()
+{
+	InstantiateInputResampler();
+	ForEachOutput([&](Output& output) { InstantiateResampler(output); });
 
 	if(settings_.StretchFactorGiven() || settings_.PitchShiftValueGiven() || settings_.DisplayTransients())
 	{
@@ -77,44 +206,473 @@ void PhaseVocoderProcessor::Process()
 	// resampling), we just treat the audio as one single transient section.
 	if(settings_.StretchFactorGiven() || settings_.PitchShiftValueGiven() || settings_.DisplayTransients())
 	{
-		// This handles any leading silence given in the input.
-		HandleLeadingSilence();
+		auto transientSections{GetTransientSections()};
+		MemoryAccounting::ScopedAllocation transientSectionsMemory{memoryAccounting_.get(), MemoryAccounting::Stage::TRANSIENTS, streamID_, 
+																	transientSections.size() * sizeof(transientSections[0])};
+
+		// When rendering a range, only the transient sections overlapping the range are processed
+		bool leadingSilenceInRange{true};
+		if(settings_.RenderRangeGiven())
+		{
+			leadingSilenceInRange = LimitToRenderRange(transientSections);
+		}
+
+		std::size_t samplesToConsume{leadingSilenceInRange ? GetLeadingSilenceLength() : 0};
+		for(const auto& transientSection : transientSections)
+		{
+			samplesToConsume += transientSection.second - transientSection.first;
+		}
 
-		std::size_t transientStartIndex{0};
-		auto transientPositions{transients_->GetTransients()};
-		while(transientStartIndex < (transientPositions.size() - 1))
+		SetSamplesToConsume(samplesToConsume, transientSections.size());
+
+		// This handles any leading silence given in the input.
+		if(leadingSilenceInRange)
 		{
-			ProcessAudioSection(transientPositions[transientStartIndex], transientPositions[transientStartIndex + 1]);	
-			++transientStartIndex;
+			HandleLeadingSilence();
 		}
 
-		// Handle the last transient section to the end of input
-		ProcessAudioSection(transientPositions[transientStartIndex], audioFileReader_->GetSampleCount());
+		for(std::size_t sectionIndex{0}; sectionIndex < transientSections.size(); ++sectionIndex)
+		{
+			ProcessTransientSection(transientSections, sectionIndex);
+		}
+	}
+	else if(settings_.RenderRangeGiven())
+	{
+		// Just resampling.  The Resampler doesn't care about transients so we can process exactly the range.
+		SetSamplesToConsume(GetRenderRangeEnd() - GetRenderRangeStart(), 1);
+		ReportSectionStarted(0);
+		ProcessAudioSection(GetRenderRangeStart(), GetRenderRangeEnd());
 	}
 	else
 	{
 		// If we're here, we are just resampling the audio.  No transients, no stretching.
-		ProcessAudioSection(0, audioFileReader_->GetSampleCount());
+		SetSamplesToConsume(audioInput_->GetSampleCount(), 1);
+		ReportSectionStarted(0);
+		ProcessAudioSection(0, audioInput_->GetSampleCount());
 	}
 
 	// Flush the Resampler (if we're using it)
-	if(settings_.ResampleValueGiven() || settings_.PitchShiftValueGiven())
+	if(ResamplerNeeded())
+	{
+		ForEachOutput([&](Output& output) { FlushResampler(output); });
+	}
+}
+
+void PhaseVocoderProcessor::ProcessTransientSection(const std::vector<std::pair<std::size_t, std::size_t>>& transientSections, std::size_t sectionIndex)
+{
+	const auto& transientSection{transientSections[sectionIndex]};
+
+	ReportSectionStarted(sectionIndex);
+
+	if(!renderManifest_)
+	{
+		ProcessAudioSection(transientSection.first, transientSection.second);
+		++sectionsRendered_;
+		return;
+	}
+
+	auto& output{outputs_[0]};
+
+	RenderManifest::Section section;
+	section.start_ = transientSection.first;
+	section.end_ = transientSection.second;
+	section.outputOffset_ = output.samplesWritten_;
+
+	const RenderManifest::Section* previousSection{nullptr};
+	if(previousRenderManifest_ && previousOutput_)
+	{
+		bool hasPredecessor{sectionIndex > 0};
+		std::size_t predecessorStart{hasPredecessor ? transientSections[sectionIndex - 1].first : 0};
+		previousSection = previousRenderManifest_->FindReusableSection(streamID_, section.start_, section.end_, hasPredecessor, predecessorStart);
+	}
+
+	if(previousSection)
+	{
+		ReuseAudioSection(*previousSection);
+		++sectionsReused_;
+
+		if(progressTracker_)
+		{
+			progressTracker_->SamplesConsumed(streamID_, section.end_ - section.start_);
+		}
+	}
+	else
+	{
+		ProcessAudioSection(section.start_, section.end_);
+		++sectionsRendered_;
+	}
+
+	section.outputLength_ = output.samplesWritten_ - section.outputOffset_;
+	section.crossfadeTail_ = output.transientSectionOverlap_.GetData();
+	renderManifest_->AddSection(streamID_, section);
+}
+
+// Copies a section's output from the previous render and restores the crossfade tail it left behind
+void PhaseVocoderProcessor::ReuseAudioSection(const RenderManifest::Section& previousSection)
+{
+	auto& output{outputs_[0]};
+
+	std::size_t currentSamplePosition{0};
+	while(currentSamplePosition < previousSection.outputLength_)
+	{
+		std::size_t samplesToRead{std::min(bufferSize_, previousSection.outputLength_ - currentSamplePosition)};
+		auto audioData{previousOutput_->ReadAudioStream(streamID_, previousSection.outputOffset_ + currentSamplePosition, samplesToRead)};
+		WriteOutput(output, audioData);
+		currentSamplePosition += samplesToRead;
+	}
+
+	output.transientSectionOverlap_ = AudioData{previousSection.crossfadeTail_};
+}
+
+// Each transient section runs from one transient to the next, the last one running to the end of input
+std::vector<std::pair<std::size_t, std::size_t>> PhaseVocoderProcessor::GetTransientSections()
+{
+	std::vector<std::pair<std::size_t, std::size_t>> transientSections;
+
+	auto transientPositions{transients_->GetTransients()};
+	for(std::size_t i{0}; i < transientPositions.size(); ++i)
+	{
+		auto sectionEnd{(i + 1 < transientPositions.size()) ? transientPositions[i + 1] : audioInput_->GetSampleCount()};
+		transientSections.push_back(std::make_pair(transientPositions[i], sectionEnd));
+	}
+
+	if(settings_.MinSectionLengthGiven())
+	{
+		MergeShortSections(transientSections);
+	}
+
+	if(maxSectionLength_)
+	{
+		SplitLongSections(transientSections);
+	}
+
+	return transientSections;
+}
+
+// Every section carries the fixed cost of a new PhaseVocoder, a flush and a crossfade, which outweighs 
+// the processing of sections only a few hundred samples long.  A section shorter than the minimum takes 
+// in the one following it (dropping the transient between them), and a short last section is taken in 
+// by the one before it.
+void PhaseVocoderProcessor::MergeShortSections(std::vector<std::pair<std::size_t, std::size_t>>& transientSections)
+{
+	auto minSectionLength{settings_.GetMinSectionLength() * audioInput_->GetSampleRate() / 1000};
+
+	std::vector<std::pair<std::size_t, std::size_t>> mergedSections;
+	for(const auto& transientSection : transientSections)
+	{
+		if(mergedSections.size() && mergedSections.back().second - mergedSections.back().first < minSectionLength)
+		{
+			mergedSections.back().second = transientSection.second;
+			++sectionsMerged_;
+		}
+		else
+		{
+			mergedSections.push_back(transientSection);
+		}
+	}
+
+	if(mergedSections.size() > 1 && mergedSections.back().second - mergedSections.back().first < minSectionLength)
+	{
+		auto sectionEnd{mergedSections.back().second};
+		mergedSections.pop_back();
+		mergedSections.back().second = sectionEnd;
+		++sectionsMerged_;
+	}
+
+	transientSections.swap(mergedSections);
+}
+
+// Each split leaves both pieces at least half the max section length long
+void PhaseVocoderProcessor::SplitLongSections(std::vector<std::pair<std::size_t, std::size_t>>& transientSections)
+{
+	std::vector<std::pair<std::size_t, std::size_t>> splitSections;
+
+	for(auto transientSection : transientSections)
+	{
+		while(transientSection.second - transientSection.first > maxSectionLength_)
+		{
+			auto searchStart{transientSection.first + maxSectionLength_ / 2};
+			auto searchEnd{std::min(transientSection.first + maxSectionLength_, transientSection.second - maxSectionLength_ / 2)};
+
+			auto splitPosition{FindQuietestPosition(searchStart, searchEnd)};
+			splitSections.push_back(std::make_pair(transientSection.first, splitPosition));
+			transientSection.first = splitPosition;
+		}
+
+		splitSections.push_back(transientSection);
+	}
+
+	transientSections.swap(splitSections);
+}
+
+// Returns the middle of the window with the least energy in the given range of input
+std::size_t PhaseVocoderProcessor::FindQuietestPosition(std::size_t startSample, std::size_t endSample)
+{
+	std::size_t quietestPosition{startSample + (endSample - startSample) / 2};
+	double quietestEnergy{-1.0};
+
+	double windowEnergy{0.0};
+	std::size_t windowStart{startSample};
+
+	for(auto currentSamplePosition{startSample}; currentSamplePosition < endSample; )
+	{
+		auto samplesToRead{std::min(bufferSize_, endSample - currentSamplePosition)};
+		auto audioData{GetAudioInput(currentSamplePosition, samplesToRead)};
+		if(audioData.GetSize() == 0)
+		{
+			break;
+		}
+
+		for(auto sample : audioData.GetData())
+		{
+			windowEnergy += sample * sample;
+
+			if(++currentSamplePosition - windowStart == splitSearchWindow_)
+			{
+				if(quietestEnergy < 0.0 || windowEnergy < quietestEnergy)
+				{
+					quietestEnergy = windowEnergy;
+					quietestPosition = windowStart + splitSearchWindow_ / 2;
+				}
+
+				windowEnergy = 0.0;
+				windowStart = currentSamplePosition;
+			}
+		}
+	}
+
+	return quietestPosition;
+}
+
+// Removes the transient sections not overlapping the render range and sets up the outputs to skip the 
+// stretched audio preceding the range and to stop after the stretched range.  Returns true if the 
+// leading silence (the audio before the first transient) overlaps the range.
+bool PhaseVocoderProcessor::LimitToRenderRange(std::vector<std::pair<std::size_t, std::size_t>>& transientSections)
+{
+	auto rangeStart{GetRenderRangeStart()};
+	auto rangeEnd{GetRenderRangeEnd()};
+
+	std::size_t leadingSilenceEnd{audioInput_->GetSampleCount()};
+	if(transientSections.size())
+	{
+		leadingSilenceEnd = transientSections[0].first;
+	}
+
+	bool leadingSilenceInRange{rangeStart < leadingSilenceEnd};
+
+	transientSections.erase(std::remove_if(transientSections.begin(), transientSections.end(), 
+		[&](const std::pair<std::size_t, std::size_t>& transientSection) 
+		{ 
+			return transientSection.second <= rangeStart || transientSection.first >= rangeEnd; 
+		}), transientSections.end());
+
+	// The input sample position the first output sample corresponds to
+	std::size_t outputStart{0};
+	if(!leadingSilenceInRange && transientSections.size())
+	{
+		outputStart = transientSections[0].first;
+	}
+
+	double outputSamplesPerInputSample{static_cast<double>(GetOutputSampleRate()) / static_cast<double>(audioInput_->GetSampleRate())};
+	for(auto& output : outputs_)
+	{
+		output.trimOutput_ = true;
+		output.outputSamplesToSkip_ = static_cast<std::size_t>((rangeStart - outputStart) * output.stretchFactor_ * outputSamplesPerInputSample + 0.5);
+		output.outputSamplesToKeep_ = static_cast<std::size_t>((rangeEnd - rangeStart) * output.stretchFactor_ * outputSamplesPerInputSample + 0.5);
+	}
+
+	return leadingSilenceInRange;
+}
+
+std::size_t PhaseVocoderProcessor::GetRenderRangeStart()
+{
+	std::size_t rangeStart{0};
+	if(settings_.RangeStartGiven())
+	{
+		rangeStart = settings_.GetRangeStartSample(audioInput_->GetSampleRate());
+	}
+
+	if(rangeStart >= GetRenderRangeEnd())
+	{
+		Utilities::ThrowException("Render range start must come before the range end and the end of input", rangeStart, GetRenderRangeEnd());
+	}
+
+	return rangeStart;
+}
+
+std::size_t PhaseVocoderProcessor::GetRenderRangeEnd()
+{
+	std::size_t rangeEnd{audioInput_->GetSampleCount()};
+	if(settings_.RangeEndGiven())
+	{
+		rangeEnd = std::min(rangeEnd, settings_.GetRangeEndSample(audioInput_->GetSampleRate()));
+	}
+
+	return rangeEnd;
+}
+
+// All output goes through here so a render range can be trimmed out of it
+void PhaseVocoderProcessor::WriteOutput(Output& output, const AudioData& audioData)
+{
+	TraceSpan span{"Write", "writer", streamID_, "samples", audioData.GetSize()};
+
+	if(!output.trimOutput_)
+	{
+		output.audioOutput_->WriteAudioStream(streamID_, audioData.GetData());
+		output.samplesWritten_ += audioData.GetSize();
+		ReportSamplesProduced(audioData.GetSize());
+		return;
+	}
+
+	AudioData audioToWrite{audioData};
+
+	if(output.outputSamplesToSkip_)
+	{
+		auto samplesToSkip{std::min(output.outputSamplesToSkip_, audioToWrite.GetSize())};
+		audioToWrite.RetrieveRemove(samplesToSkip);
+		output.outputSamplesToSkip_ -= samplesToSkip;
+	}
+
+	if(audioToWrite.GetSize() > output.outputSamplesToKeep_)
+	{
+		audioToWrite = audioToWrite.Retrieve(output.outputSamplesToKeep_);
+	}
+
+	output.outputSamplesToKeep_ -= audioToWrite.GetSize();
+
+	if(audioToWrite.GetSize())
+	{
+		output.audioOutput_->WriteAudioStream(streamID_, audioToWrite.GetData());
+		output.samplesWritten_ += audioToWrite.GetSize();
+		ReportSamplesProduced(audioToWrite.GetSize());
+	}
+}
+
+// Every output after the first gets a worker thread for the whole of Process(), since the outputs share 
+// nothing but the (read-only) input.  ForEachOutput hands each worker its actions.
+void PhaseVocoderProcessor::StartOutputWorkers()
+{
+	stopOutputWorkers_ = false;
+	for(std::size_t i{1}; i < outputs_.size(); ++i)
+	{
+		outputWorkers_.emplace_back([this, i] { RunOutputWorker(i); });
+	}
+}
+
+void PhaseVocoderProcessor::StopOutputWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(outputWorkMutex_);
+		stopOutputWorkers_ = true;
+	}
+
+	outputWorkGiven_.notify_all();
+	for(auto& outputWorker : outputWorkers_)
+	{
+		outputWorker.join();
+	}
+
+	outputWorkers_.clear();
+}
+
+void PhaseVocoderProcessor::RunOutputWorker(std::size_t outputIndex)
+{
+	if(Trace::IsRecording())
+	{
+		Trace::SetThreadName(Utilities::CreateString(" ", "Channel", streamID_ + 1, "Output", outputIndex + 1));
+	}
+
+	std::size_t lastRound{0};
+	std::unique_lock<std::mutex> lock(outputWorkMutex_);
+	while(true)
+	{
+		outputWorkGiven_.wait(lock, [&]{ return stopOutputWorkers_ || outputWorkRound_ != lastRound; });
+		if(stopOutputWorkers_)
+		{
+			return;
+		}
+
+		lastRound = outputWorkRound_;
+		auto action{outputWork_};
+		lock.unlock();
+
+		std::exception_ptr exception;
+		try
+		{
+			(*action)(outputs_[outputIndex]);
+		}
+		catch(...)
+		{
+			exception = std::current_exception();
+		}
+
+		lock.lock();
+		if(exception && !outputWorkException_)
+		{
+			outputWorkException_ = exception;
+		}
+
+		if(--outputWorkersBusy_ == 0)
+		{
+			outputWorkFinished_.notify_one();
+		}
+	}
+}
+
+// Runs the given action on every output.  The first output's runs on this thread and the others' on their 
+// workers.  Any exception thrown by an action is rethrown once they've all finished.
+void PhaseVocoderProcessor::ForEachOutput(const std::function<void(Output&)>& action)
+{
+	if(outputWorkers_.empty())
 	{
-		auto audioData{resampler_->FlushAudioData()};
-		audioFileWriter_->WriteAudioStream(streamID_, audioData.GetData());
+		action(outputs_[0]);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(outputWorkMutex_);
+		outputWork_ = &action;
+		outputWorkersBusy_ = outputWorkers_.size();
+		outputWorkException_ = nullptr;
+		++outputWorkRound_;
+	}
+
+	outputWorkGiven_.notify_all();
+
+	std::exception_ptr exception;
+	try
+	{
+		action(outputs_[0]);
+	}
+	catch(...)
+	{
+		exception = std::current_exception();
+	}
+
+	std::unique_lock<std::mutex> lock(outputWorkMutex_);
+	outputWorkFinished_.wait(lock, [&]{ return outputWorkersBusy_ == 0; });
+	outputWork_ = nullptr;
+	if(!exception)
+	{
+		exception = outputWorkException_;
+	}
+
+	lock.unlock();
+	if(exception)
+	{
+		std::rethrow_exception(exception);
 	}
 }
 
 void PhaseVocoderProcessor::ObtainTransients()
 {
+	TraceSpan span{"ObtainTransients", "transients", streamID_};
+
 	TransientSettings transientSettings;
 
 	transientSettings.SetStreamID(streamID_);
 
-	if(settings_.InputWaveFileGiven())
-	{
-		transientSettings.SetAudioFile(audioFileReader_);
-	}
+	transientSettings.SetAudioInput(audioInput_);
 
 	if(settings_.TransientConfigFilenameGiven())
 	{
@@ -123,146 +681,308 @@ void PhaseVocoderProcessor::ObtainTransients()
 
 	transientSettings.SetTransientValleyToPeakRatio(settings_.GetValleyToPeakRatio());
 
+	if(transientCache_)
+	{
+		transientSettings.SetTransientCache(transientCache_);
+	}
+
 	transients_.reset(new Transients(transientSettings));
-	transients_->GetTransients();
+	auto transientCount{transients_->GetTransients().size()};
+
+	if(memoryAccounting_)
+	{
+		memoryAccounting_->Add(MemoryAccounting::Stage::TRANSIENTS, streamID_, transientCount * sizeof(std::size_t));
+	}
 }
 
 void PhaseVocoderProcessor::HandleLeadingSilence()
 {
-	auto transientPositions{transients_->GetTransients()};
+	auto leadingSilenceLength{GetLeadingSilenceLength()};
+
+	if(leadingSilenceLength)
+	{
+		HandleSilenceInInput(leadingSilenceLength);
+	}
+}
+
+// The input before the first transient (all of it when there are none)
+std::size_t PhaseVocoderProcessor::GetLeadingSilenceLength()
+{
+	const auto& transientPositions{transients_->GetTransients()};
 
 	if(transientPositions.size() == 0)
 	{
-		HandleSilenceInInput(audioFileReader_->GetSampleCount());
+		return audioInput_->GetSampleCount();
+	}
+
+	return transientPositions[0];
+}
+
+void PhaseVocoderProcessor::SetSamplesToConsume(std::size_t samplesToConsume, std::size_t sectionCount)
+{
+	if(progressTracker_)
+	{
+		progressTracker_->SetSamplesToConsume(streamID_, samplesToConsume, sectionCount);
+	}
+}
+
+void PhaseVocoderProcessor::ReportSectionStarted(std::size_t sectionIndex)
+{
+	if(progressTracker_)
+	{
+		progressTracker_->SectionStarted(streamID_, sectionIndex);
 	}
-	else if(transientPositions[0] != 0)
+}
+
+void PhaseVocoderProcessor::ReportSamplesProduced(std::size_t sampleCount)
+{
+	if(progressTracker_)
 	{
-		HandleSilenceInInput(transientPositions[0]);
+		progressTracker_->SamplesProduced(streamID_, sampleCount);
 	}
 }
 
 AudioData PhaseVocoderProcessor::GetAudioInput(std::size_t startSample, std::size_t length)
 {
-	return audioFileReader_->ReadAudioStream(streamID_, startSample, length);
+	TraceSpan span{"Read", "reader", streamID_, "startSample", startSample};
+
+	return audioInput_->ReadAudioStream(streamID_, startSample, length);
 }
 
+// The outputs are written a buffer of input at a time in turn, rather than one after another, so no 
+// output gets far ahead of the others (which a bounded AudioOutput would hold up).
 void PhaseVocoderProcessor::HandleSilenceInInput(std::size_t sampleCount)
 {
-	std::size_t samplesToOutput{static_cast<std::size_t>(static_cast<double>(sampleCount) * settings_.GetStretchFactor() + 0.5)};
-
 	std::size_t currentSamplePosition{0};
-	while(currentSamplePosition < samplesToOutput)
+	while(currentSamplePosition < sampleCount)
 	{
-		std::size_t currentWriteAmount{std::min(bufferSize_, samplesToOutput - currentSamplePosition)};
+		auto nextSamplePosition{std::min(currentSamplePosition + bufferSize_, sampleCount)};
+
+		for(auto& output : outputs_)
+		{
+			auto outputStart{static_cast<std::size_t>(static_cast<double>(currentSamplePosition) * output.stretchFactor_ + 0.5)};
+			auto outputEnd{static_cast<std::size_t>(static_cast<double>(nextSamplePosition) * output.stretchFactor_ + 0.5)};
 
-		AudioData silentAudioData;
-		silentAudioData.AddSilence(currentWriteAmount);
+			// Stretched audio is still written in pieces no bigger than the buffer size
+			for(auto outputPosition{outputStart}; outputPosition < outputEnd; )
+			{
+				auto currentWriteAmount{std::min(bufferSize_, outputEnd - outputPosition)};
 
-		audioFileWriter_->WriteAudioStream(streamID_, silentAudioData.GetData());
+				AudioData silentAudioData;
+				silentAudioData.AddSilence(currentWriteAmount);
+
+				WriteOutput(output, silentAudioData);
+
+				outputPosition += currentWriteAmount;
+			}
+		}
+
+		if(progressTracker_)
+		{
+			progressTracker_->SamplesConsumed(streamID_, nextSamplePosition - currentSamplePosition);
+		}
 
-		currentSamplePosition += currentWriteAmount;
+		currentSamplePosition = nextSamplePosition;
 	}
 }
 
 void PhaseVocoderProcessor::ProcessAudioSection(std::size_t startSamplePosition, std::size_t endSamplePosition)
 {
+	TraceSpan span{"ProcessAudioSection", "section", streamID_, "startSample", startSamplePosition};
+
 	std::size_t totalSamplesToRead{endSamplePosition - startSamplePosition};
 
-	InstantiatePhaseVocoder(endSamplePosition - startSamplePosition);
-	samplesOutputFromCurrentPhaseVocoder_ = 0;
+	auto sampleLengthOfAudioToProcess{static_cast<std::size_t>(totalSamplesToRead * GetProcessingSampleRate() / audioInput_->GetSampleRate())};
+
+	auto instantiateStart{std::chrono::steady_clock::now()};
+	for(auto& output : outputs_)
+	{
+		InstantiatePhaseVocoder(output, sampleLengthOfAudioToProcess);
+		output.samplesOutputFromCurrentPhaseVocoder_ = 0;
+	}
+	sectionOverheadTime_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - instantiateStart).count();
+
+	// The number of samples actually processed in this section.  This only differs from the number of 
+	// samples read when processing at a reduced rate.
+	std::size_t totalSamplesProcessed{0};
 
 	std::size_t currentSamplePosition{0};
 	while(currentSamplePosition < totalSamplesToRead)
 	{
 		std::size_t samplesToRead{std::min(bufferSize_, totalSamplesToRead - currentSamplePosition)};
 		auto audioInputData{GetAudioInput(startSamplePosition + currentSamplePosition, samplesToRead)};
-		ProcessInput(audioInputData);
+
+		if(ReducedRateProcessing())
+		{
+			audioInputData = ReduceProcessingRate(audioInputData);
+		}
+
+		MemoryAccounting::ScopedAllocation audioInputMemory{memoryAccounting_.get(), MemoryAccounting::Stage::AUDIO_DATA, streamID_, 
+															audioInputData.GetSize() * sizeof(double)};
+
+		if(audioInputData.GetSize())
+		{
+			ForEachOutput([&](Output& output) { ProcessInput(output, audioInputData); });
+		}
+
+		totalSamplesProcessed += audioInputData.GetSize();
 		currentSamplePosition += samplesToRead;
+
+		if(progressTracker_)
+		{
+			progressTracker_->SamplesConsumed(streamID_, samplesToRead);
+		}
+	}
+
+	// At the end of input, whatever the input resampler is still holding belongs to this last section
+	if(ReducedRateProcessing() && endSamplePosition == audioInput_->GetSampleCount())
+	{
+		auto audioInputData{FlushInputResampler()};
+		if(audioInputData.GetSize())
+		{
+			ForEachOutput([&](Output& output) { ProcessInput(output, audioInputData); });
+		}
+
+		totalSamplesProcessed += audioInputData.GetSize();
+	}
+
+	auto finalizeStart{std::chrono::steady_clock::now()};
+	ForEachOutput([&](Output& output) { FinalizeAudioSection(output, totalSamplesProcessed); });
+	sectionOverheadTime_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - finalizeStart).count();
+}
+
+// Output usually comes out of AudioLib a single block at a time, so the first block is moved in rather 
+// than copied into a fresh allocation
+void PhaseVocoderProcessor::AppendAudio(AudioData& audioData, AudioData&& samples)
+{
+	if(!audioData.GetSize())
+	{
+		audioData = std::move(samples);
+		return;
+	}
+
+	audioData.Append(samples);
+}
+
+AudioData PhaseVocoderProcessor::ReduceProcessingRate(const AudioData& audioInputData)
+{
+	TraceSpan span{"ReduceProcessingRate", "resampler", streamID_, "samples", audioInputData.GetSize()};
+
+	inputResampler_->SubmitAudioData(audioInputData);
+
+	AudioData dataToReturn;
+
+	while(inputResampler_->OutputSamplesAvailable())
+	{
+		AppendAudio(dataToReturn, inputResampler_->GetAudioData(std::min(bufferSize_, inputResampler_->OutputSamplesAvailable())));
 	}
 
-	FinalizeAudioSection(totalSamplesToRead);
+	return dataToReturn;
+}
+
+AudioData PhaseVocoderProcessor::FlushInputResampler()
+{
+	TraceSpan span{"FlushInputResampler", "resampler", streamID_};
+
+	return inputResampler_->FlushAudioData();
 }
 
-void PhaseVocoderProcessor::ProcessInput(const AudioData& audioInputData)
+void PhaseVocoderProcessor::ProcessInput(Output& output, const AudioData& audioInputData)
 {
 	AudioData resultingAudio;
 
-	if(settings_.PitchShiftValueGiven() || (settings_.StretchFactorGiven() && settings_.ResampleValueGiven()))
+	if(settings_.PitchShiftValueGiven() || (settings_.StretchFactorGiven() && (settings_.ResampleValueGiven() || ReducedRateProcessing())))
 	{
-		resultingAudio = ProcessAudioWithResampler(ProcessAudioWithPhaseVocoder(audioInputData));
+		resultingAudio = ProcessAudioWithResampler(output, ProcessAudioWithPhaseVocoder(output, audioInputData));
 	}
 	else if(settings_.StretchFactorGiven() && !settings_.PitchShiftValueGiven())
 	{
-		resultingAudio = ProcessAudioWithPhaseVocoder(audioInputData);
+		resultingAudio = ProcessAudioWithPhaseVocoder(output, audioInputData);
 	}
 	else if(settings_.ResampleValueGiven() && !settings_.PitchShiftValueGiven())
 	{
-		resultingAudio = ProcessAudioWithResampler(audioInputData);
+		resultingAudio = ProcessAudioWithResampler(output, audioInputData);
 	}
 	else
 	{
 		Utilities::ThrowException("PhaseVocoderProcessor has no action to perform");
 	}
 
-	audioFileWriter_->WriteAudioStream(streamID_, resultingAudio.GetData());
+	MemoryAccounting::ScopedAllocation resultingAudioMemory{memoryAccounting_.get(), MemoryAccounting::Stage::AUDIO_DATA, streamID_, 
+															resultingAudio.GetSize() * sizeof(double)};
+	WriteOutput(output, resultingAudio);
 }
 
-void PhaseVocoderProcessor::FinalizeAudioSection(std::size_t totalInputSamples)
+void PhaseVocoderProcessor::FinalizeAudioSection(Output& output, std::size_t totalInputSamples)
 {
 	AudioData audioData;
 
 	if(settings_.StretchFactorGiven() || settings_.PitchShiftValueGiven())
 	{
-		std::size_t totalOutputSamplesNeeded{static_cast<std::size_t>(totalInputSamples * phaseVocoder_->GetStretchFactor() + 0.5)};
+		std::size_t totalOutputSamplesNeeded{static_cast<std::size_t>(totalInputSamples * output.phaseVocoder_->GetStretchFactor() + 0.5)};
 
 		// No need to do anything else if we already have the amount of samples we need
-		if(totalOutputSamplesNeeded < samplesOutputFromCurrentPhaseVocoder_)
+		if(totalOutputSamplesNeeded < output.samplesOutputFromCurrentPhaseVocoder_)
 		{
 			return;
 		}
 
-		std::size_t samplesStillNeeded{totalOutputSamplesNeeded - samplesOutputFromCurrentPhaseVocoder_};
+		std::size_t samplesStillNeeded{totalOutputSamplesNeeded - output.samplesOutputFromCurrentPhaseVocoder_};
 
-		audioData = FlushPhaseVocoderOutput(samplesStillNeeded);
+		audioData = FlushPhaseVocoderOutput(output, samplesStillNeeded);
 	}
 
-	if(audioData.GetSize() && (settings_.ResampleValueGiven() || settings_.PitchShiftValueGiven()))
+	if(audioData.GetSize() && ResamplerNeeded())
 	{
-		resampler_->SubmitAudioData(audioData);
+		output.resampler_->SubmitAudioData(audioData);
 	}
 	else if(audioData.GetSize())
 	{
-		audioFileWriter_->WriteAudioStream(streamID_, audioData.GetData());
+		WriteOutput(output, audioData);
 	}
 }
 
-AudioData PhaseVocoderProcessor::ProcessAudioWithPhaseVocoder(const AudioData& audioInputData)
+void PhaseVocoderProcessor::FlushResampler(Output& output)
 {
-	phaseVocoder_->SubmitAudioData(audioInputData);
+	TraceSpan span{"FlushResampler", "resampler", streamID_};
+
+	auto audioData{output.resampler_->FlushAudioData()};
+	WriteOutput(output, audioData);
+}
+
+AudioData PhaseVocoderProcessor::ProcessAudioWithPhaseVocoder(Output& output, const AudioData& audioInputData)
+{
+	TraceSpan span{"PhaseVocoder Submit", "phaseVocoder", streamID_, "samples", audioInputData.GetSize()};
+
+	output.phaseVocoder_->SubmitAudioData(audioInputData);
 
 	AudioData dataToReturn;
 
-	while(phaseVocoder_->OutputSamplesAvailable())
+	while(output.phaseVocoder_->OutputSamplesAvailable())
 	{
-		dataToReturn.Append(phaseVocoder_->GetAudioData(std::min(bufferSize_, phaseVocoder_->OutputSamplesAvailable())));
+		AppendAudio(dataToReturn, output.phaseVocoder_->GetAudioData(std::min(bufferSize_, output.phaseVocoder_->OutputSamplesAvailable())));
 	}
 
 	// If transient overlap data exist, mix it with this output
-	if(transientSectionOverlap_.GetSize() && (dataToReturn.GetSize() >= transientSectionOverlap_.GetSize()))
+	if(output.transientSectionOverlap_.GetSize() && (dataToReturn.GetSize() >= output.transientSectionOverlap_.GetSize()))
 	{
-		dataToReturn = LinearCrossfade(transientSectionOverlap_, dataToReturn);
-		transientSectionOverlap_.Clear();	
+		dataToReturn = LinearCrossfade(output.transientSectionOverlap_, dataToReturn);
+		output.transientSectionOverlap_.Clear();	
 	}
 
-	samplesOutputFromCurrentPhaseVocoder_ += dataToReturn.GetSize();
+	output.samplesOutputFromCurrentPhaseVocoder_ += dataToReturn.GetSize();
 
 	return dataToReturn;
 }
 
-AudioData PhaseVocoderProcessor::FlushPhaseVocoderOutput(std::size_t samplesNeeded)
+AudioData PhaseVocoderProcessor::FlushPhaseVocoderOutput(Output& output, std::size_t samplesNeeded)
 {
+	TraceSpan span{"PhaseVocoder Flush", "phaseVocoder", streamID_, "samplesNeeded", samplesNeeded};
+
 	AudioData audioToReturn;
-	auto flushedOutput{phaseVocoder_->FlushAudioData()};
+	auto flushedOutput{output.phaseVocoder_->FlushAudioData()};
+	MemoryAccounting::ScopedAllocation flushedOutputMemory{memoryAccounting_.get(), MemoryAccounting::Stage::AUDIO_DATA, streamID_, 
+															flushedOutput.GetSize() * sizeof(double)};
 
 	if(samplesNeeded)
 	{
@@ -274,67 +994,118 @@ AudioData PhaseVocoderProcessor::FlushPhaseVocoderOutput(std::size_t samplesNeed
 		audioToReturn = flushedOutput.RetrieveRemove(samplesNeeded);
   
 		// If transient overlap data exist, mix it with this output
-		if(transientSectionOverlap_.GetSize())
+		if(output.transientSectionOverlap_.GetSize())
 		{
-			audioToReturn = LinearCrossfade(transientSectionOverlap_, audioToReturn);
-			transientSectionOverlap_.Clear();	
+			audioToReturn = LinearCrossfade(output.transientSectionOverlap_, audioToReturn);
+			output.transientSectionOverlap_.Clear();	
 		}
 	}
 
 	// Save off transient overlap samples for clean mix/transition to next transient
 	if(flushedOutput.GetSize() >= transientSectionOverlapSampleCount_)
 	{
-		transientSectionOverlap_.Append(flushedOutput.Retrieve(transientSectionOverlapSampleCount_));
+		output.transientSectionOverlap_.Append(flushedOutput.Retrieve(transientSectionOverlapSampleCount_));
 	}
 
 	return audioToReturn;
 }
 
-AudioData PhaseVocoderProcessor::ProcessAudioWithResampler(const AudioData& audioInputData)
+AudioData PhaseVocoderProcessor::ProcessAudioWithResampler(Output& output, const AudioData& audioInputData)
 {
-	resampler_->SubmitAudioData(audioInputData);
+	TraceSpan span{"Resample", "resampler", streamID_, "samples", audioInputData.GetSize()};
+
+	output.resampler_->SubmitAudioData(audioInputData);
 
 	AudioData dataToReturn;
 
-	while(resampler_->OutputSamplesAvailable())
+	while(output.resampler_->OutputSamplesAvailable())
 	{
-		dataToReturn.Append(resampler_->GetAudioData(std::min(bufferSize_, resampler_->OutputSamplesAvailable())));
+		AppendAudio(dataToReturn, output.resampler_->GetAudioData(std::min(bufferSize_, output.resampler_->OutputSamplesAvailable())));
 	}
 
+	// The Resampler's own state lives in AudioLib, so only the audio passing through it is counted
+	MemoryAccounting::ScopedAllocation resamplerMemory{memoryAccounting_.get(), MemoryAccounting::Stage::RESAMPLER, streamID_, 
+														(audioInputData.GetSize() + dataToReturn.GetSize()) * sizeof(double)};
+
 	return dataToReturn;
 }
 
-void PhaseVocoderProcessor::InstantiatePhaseVocoder(std::size_t sampleLengthOfAudioToProcess)
+void PhaseVocoderProcessor::InstantiatePhaseVocoder(Output& output, std::size_t sampleLengthOfAudioToProcess)
 {
-	if(!settings_.GetStretchFactor() && !settings_.PitchShiftValueGiven())
+	if(!settings_.StretchFactorGiven() && !settings_.PitchShiftValueGiven())
 	{
 		// No Phase Vocoder needed
 		return;
 	}
 
-	double stretchFactor{1.0};
-	if(settings_.StretchFactorGiven())
-	{
-		stretchFactor = settings_.GetStretchFactor();	
-	}
+	double stretchFactor{output.stretchFactor_};
 
 	if(settings_.PitchShiftValueGiven())
 	{
 		stretchFactor *= GetPitchShiftRatio();
 	}
 
-	phaseVocoder_.reset(new Signal::PhaseVocoder(audioFileReader_->GetSampleRate(), sampleLengthOfAudioToProcess, stretchFactor));
+	output.phaseVocoder_.reset(new Signal::PhaseVocoder(GetProcessingSampleRate(), sampleLengthOfAudioToProcess, stretchFactor));
+
+	if(memoryAccounting_)
+	{
+		memoryAccounting_->Remove(MemoryAccounting::Stage::PHASE_VOCODER, streamID_, output.phaseVocoderBytes_);
+		output.phaseVocoderBytes_ = static_cast<std::size_t>(EstimatePhaseVocoderBytes(static_cast<double>(sampleLengthOfAudioToProcess), stretchFactor));
+		memoryAccounting_->Add(MemoryAccounting::Stage::PHASE_VOCODER, streamID_, output.phaseVocoderBytes_);
+	}
 }
 
-void PhaseVocoderProcessor::InstantiateResampler()
+void PhaseVocoderProcessor::InstantiateResampler(Output& output)
 {
-	if(!settings_.ResampleValueGiven() && !settings_.PitchShiftValueGiven())
+	if(!ResamplerNeeded())
 	{
 		// No Resampler needed
 		return;
 	}
 
-	resampler_.reset(new Signal::Resampler(audioFileReader_->GetSampleRate(), GetResampleRatio()));
+	output.resampler_.reset(new Signal::Resampler(GetProcessingSampleRate(), GetResampleRatio()));
+}
+
+void PhaseVocoderProcessor::InstantiateInputResampler()
+{
+	if(!ReducedRateProcessing())
+	{
+		return;
+	}
+
+	inputResampler_.reset(new Signal::Resampler(audioInput_->GetSampleRate(), settings_.GetProcessingRateRatio()));
+}
+
+// Reduced rate processing only applies when the phase vocoder is used.  Just resampling is already 
+// about as cheap as it gets.
+bool PhaseVocoderProcessor::ReducedRateProcessing() const
+{
+	return settings_.GetProcessingRateRatio() < 1.0 && (settings_.StretchFactorGiven() || settings_.PitchShiftValueGiven());
+}
+
+bool PhaseVocoderProcessor::ResamplerNeeded() const
+{
+	return settings_.ResampleValueGiven() || settings_.PitchShiftValueGiven() || ReducedRateProcessing();
+}
+
+std::size_t PhaseVocoderProcessor::GetOutputSampleRate() const
+{
+	if(settings_.ResampleValueGiven())
+	{
+		return settings_.GetResampleValue();
+	}
+
+	return audioInput_->GetSampleRate();
+}
+
+std::size_t PhaseVocoderProcessor::GetProcessingSampleRate() const
+{
+	if(ReducedRateProcessing())
+	{
+		return static_cast<std::size_t>(audioInput_->GetSampleRate() * settings_.GetProcessingRateRatio() + 0.5);
+	}
+
+	return audioInput_->GetSampleRate();
 }
 
 double PhaseVocoderProcessor::GetPitchShiftRatio()
@@ -349,7 +1120,7 @@ double PhaseVocoderProcessor::GetResampleRatio()
 
 	if(settings_.ResampleValueGiven())
 	{
-		resampleRatio = static_cast<double>(settings_.GetResampleValue()) / static_cast<double>(audioFileReader_->GetSampleRate());
+		resampleRatio = static_cast<double>(settings_.GetResampleValue()) / static_cast<double>(audioInput_->GetSampleRate());
 	}
 
 	if(settings_.PitchShiftValueGiven())
@@ -357,6 +1128,12 @@ double PhaseVocoderProcessor::GetResampleRatio()
 		resampleRatio = resampleRatio / GetPitchShiftRatio();
 	}
 
+	// Bring reduced rate output back up to the output sample rate
+	if(ReducedRateProcessing())
+	{
+		resampleRatio = resampleRatio * static_cast<double>(audioInput_->GetSampleRate()) / static_cast<double>(GetProcessingSampleRate());
+	}
+
 	return resampleRatio;
 }
 
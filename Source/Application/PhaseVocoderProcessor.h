@@ -27,9 +27,19 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include <AudioData/AudioData.h>
 #include <Application/PhaseVocoderSettings.h>
 #include <Application/Transients.h>
+#include <Application/TransientCache.h>
+#include <Application/RenderManifest.h>
+#include <Application/AudioInput.h>
+#include <Application/AudioOutput.h>
+#include <Application/MemoryAccounting.h>
+#include <Application/Progress.h>
 
 namespace Signal
 {
@@ -37,49 +47,138 @@ namespace Signal
 	class Resampler;
 }
 
-namespace ThreadSafeAudioFile
-{
-	class Reader;
-	class Writer;
-}
-
 class PhaseVocoderProcessor
 {
 	public:
 		PhaseVocoderProcessor(std::size_t streamID, const PhaseVocoderSettings& settings, 
-								std::shared_ptr<ThreadSafeAudioFile::Reader> audioFileReader, 
-								std::shared_ptr<ThreadSafeAudioFile::Writer> audioFileWriter);
+								std::shared_ptr<AudioInput> audioFileReader, 
+								std::shared_ptr<AudioOutput> audioOutput);
+
+		// Renders one output per stretch factor in the settings.  The writers must be given in the same 
+		// order as the stretch factors.
+		PhaseVocoderProcessor(std::size_t streamID, const PhaseVocoderSettings& settings, 
+								std::shared_ptr<AudioInput> audioFileReader, 
+								const std::vector<std::shared_ptr<AudioOutput>>& audioOutputs);
 		virtual ~PhaseVocoderProcessor();
 
 		void Process();
 
+		// Optional.  Detected transients are loaded from/stored to the given cache.
+		void SetTransientCache(std::shared_ptr<TransientCache> transientCache);
+
+		// Optional.  Records each rendered section in the given manifest.  When a previous manifest and 
+		// the output it describes are given, unchanged sections are copied from the previous output 
+		// instead of being processed again.  Only supported when just stretching to a single output.
+		void SetIncrementalRender(std::shared_ptr<RenderManifest> renderManifest, 
+									std::shared_ptr<const RenderManifest> previousRenderManifest, 
+									std::shared_ptr<AudioInput> previousOutput);
+
+		// Optional.  Transient sections longer than this (in input samples) are split at their quietest 
+		// point, bounding the memory each PhaseVocoder needs.  Zero leaves sections unbounded.
+		void SetMaxSectionLength(std::size_t maxSectionLength);
+
+		// Optional.  Records the memory this stream's processing holds.
+		void SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting);
+
+		// Optional.  Reports the samples this stream consumes and produces and the section it's on.
+		void SetProgressTracker(std::shared_ptr<ProgressTracker> progressTracker);
+
+		// AudioLib's PhaseVocoder is sized by its section.  It's taken to hold a couple of copies of the 
+		// section's input and of its stretched output.
+		static double EstimatePhaseVocoderBytes(double sectionLength, double stretchFactor);
+
+		std::size_t GetSectionsRendered() const;
+		std::size_t GetSectionsReused() const;
+
+		// Only non-zero when a minimum section length is given
+		std::size_t GetSectionsMerged() const;
+
+		// Seconds spent creating and flushing PhaseVocoders, the fixed cost of every section
+		double GetSectionOverheadTime() const;
+
 		const std::vector<std::size_t>& GetTransients() const;
 
 	private:
+		// Everything needed to synthesize a single output.  When multiple stretch factors are given, the 
+		// input reads and transient detection are shared and each output gets its own PhaseVocoder, 
+		// Resampler and writer.
+		struct Output
+		{
+			double stretchFactor_{1.0};
+			std::shared_ptr<AudioOutput> audioOutput_;
+			std::unique_ptr<Signal::PhaseVocoder> phaseVocoder_;
+			std::unique_ptr<Signal::Resampler> resampler_;
+			std::size_t samplesOutputFromCurrentPhaseVocoder_{0};
+			std::size_t phaseVocoderBytes_{0};  // As estimated for the memory accounting
+			AudioData transientSectionOverlap_;
+
+			// Only used when rendering a range of the input.  Output samples preceding the range are 
+			// skipped and output is cut off once the range has been written.
+			bool trimOutput_{false};
+			std::size_t outputSamplesToSkip_{0};
+			std::size_t outputSamplesToKeep_{0};
+
+			std::size_t samplesWritten_{0};
+		};
+
+		void InstantiateOutputs(const std::vector<std::shared_ptr<AudioOutput>>& audioOutputs);
+
+		void ProcessAudio();
+		void FinishOutputStreams();
+
 		void HandleSilenceInInput(std::size_t sampleCount);
 
 		void ProcessAudioSection(std::size_t startSamplePosition, std::size_t endSamplePosition);
+		void ProcessTransientSection(const std::vector<std::pair<std::size_t, std::size_t>>& transientSections, std::size_t sectionIndex);
+		void ReuseAudioSection(const RenderManifest::Section& previousSection);
+
+		std::vector<std::pair<std::size_t, std::size_t>> GetTransientSections();
+		void MergeShortSections(std::vector<std::pair<std::size_t, std::size_t>>& transientSections);
+		void SplitLongSections(std::vector<std::pair<std::size_t, std::size_t>>& transientSections);
+		std::size_t FindQuietestPosition(std::size_t startSample, std::size_t endSample);
+		bool LimitToRenderRange(std::vector<std::pair<std::size_t, std::size_t>>& transientSections);
+		std::size_t GetRenderRangeStart();
+		std::size_t GetRenderRangeEnd();
+
+		void WriteOutput(Output& output, const AudioData& audioData);
 
 		AudioData GetAudioInput(std::size_t startSample, std::size_t length);
 
 		void HandleLeadingSilence();
+		std::size_t GetLeadingSilenceLength();
+		void SetSamplesToConsume(std::size_t samplesToConsume, std::size_t sectionCount);
+		void ReportSectionStarted(std::size_t sectionIndex);
+		void ReportSamplesProduced(std::size_t sampleCount);
+
+		AudioData FlushPhaseVocoderOutput(Output& output, std::size_t samplesNeeded);
+		static void AppendAudio(AudioData& audioData, AudioData&& samples);
 
-		AudioData FlushPhaseVocoderOutput(std::size_t samplesNeeded);
+		void InstantiatePhaseVocoder(Output& output, std::size_t sampleLengthOfAudioToProcess);
+		void InstantiateResampler(Output& output);
+		void InstantiateInputResampler();
 
-		void InstantiatePhaseVocoder(std::size_t sampleLengthOfAudioToProcess);
-		void InstantiateResampler();
+		AudioData ReduceProcessingRate(const AudioData& audioInputData);
+		AudioData FlushInputResampler();
 
-		void ProcessInput(const AudioData& audioInputData);
-		void FinalizeAudioSection(std::size_t totalInputSamples);
-		AudioData ProcessAudioWithPhaseVocoder(const AudioData& audioInputData);
-		AudioData ProcessAudioWithResampler(const AudioData& audioInputData);
+		bool ReducedRateProcessing() const;
+		bool ResamplerNeeded() const;
+		std::size_t GetProcessingSampleRate() const;
+		std::size_t GetOutputSampleRate() const;
+
+		void StartOutputWorkers();
+		void StopOutputWorkers();
+		void RunOutputWorker(std::size_t outputIndex);
+		void ForEachOutput(const std::function<void(Output&)>& action);
+
+		void ProcessInput(Output& output, const AudioData& audioInputData);
+		void FinalizeAudioSection(Output& output, std::size_t totalInputSamples);
+		void FlushResampler(Output& output);
+		AudioData ProcessAudioWithPhaseVocoder(Output& output, const AudioData& audioInputData);
+		AudioData ProcessAudioWithResampler(Output& output, const AudioData& audioInputData);
 
 		double GetPitchShiftRatio();
 		double GetResampleRatio();
 
-		std::size_t samplesOutputFromCurrentPhaseVocoder_{0};
-
-		AudioData transientSectionOverlap_;
 		std::size_t transientSectionOverlapSampleCount_{64};  // The number of samples to crossfade-mix between output transient sections
 
 		std::size_t streamID_;
@@ -88,13 +187,41 @@ class PhaseVocoderProcessor
 
 		std::size_t bufferSize_{8192};
 
+		std::size_t maxSectionLength_{0};
+
+		std::shared_ptr<MemoryAccounting> memoryAccounting_;
+		std::shared_ptr<ProgressTracker> progressTracker_;
+		const std::size_t splitSearchWindow_{1024};  // Energy is compared over windows of this many samples when splitting sections
+
 		void ObtainTransients();
 
 		std::unique_ptr<Transients> transients_;
-		std::unique_ptr<Signal::PhaseVocoder> phaseVocoder_;
-		std::unique_ptr<Signal::Resampler> resampler_;
-		std::shared_ptr<ThreadSafeAudioFile::Reader> audioFileReader_;
-		std::shared_ptr<ThreadSafeAudioFile::Writer> audioFileWriter_;
+		std::shared_ptr<TransientCache> transientCache_;
+
+		std::shared_ptr<RenderManifest> renderManifest_;
+		std::shared_ptr<const RenderManifest> previousRenderManifest_;
+		std::shared_ptr<AudioInput> previousOutput_;
+		std::size_t sectionsRendered_{0};
+		std::size_t sectionsReused_{0};
+		std::size_t sectionsMerged_{0};
+		double sectionOverheadTime_{0.0};
+		std::shared_ptr<AudioInput> audioInput_;
+		std::vector<Output> outputs_;
+
+		// One thread per output after the first, for the whole of Process().  ForEachOutput gives them each 
+		// action by bumping outputWorkRound_, and waits for outputWorkersBusy_ to come back down to zero.
+		std::vector<std::thread> outputWorkers_;
+		std::mutex outputWorkMutex_;
+		std::condition_variable outputWorkGiven_;
+		std::condition_variable outputWorkFinished_;
+		const std::function<void(Output&)>* outputWork_{nullptr};
+		std::size_t outputWorkRound_{0};
+		std::size_t outputWorkersBusy_{0};
+		std::exception_ptr outputWorkException_;
+		bool stopOutputWorkers_{false};
+
+		// Only used by the lower quality presets to bring the input down to the reduced processing rate
+		std::unique_ptr<Signal::Resampler> inputResampler_;
 
 		std::vector<std::size_t> noTransients_;
 
@@ -25,6 +25,64 @@
  */
 
 #include <Application/PhaseVocoderSettings.h>
+#include <Utilities/Stringify.h>
+#include <cmath>
+
+namespace
+{
+	// The stretch factor must be between 0.01 and 10.0
+	const double minimumStretchFactor{0.01};
+	const double maximumStretchFactor{10.0};
+
+	// The pitch shift must be between -24.0 and +24.0 semitones
+	const double minimumPitchShift{-24.0};
+	const double maximumPitchShift{24.0};
+
+	// The resample frequency must be between 1000 and 192000 Hz
+	const std::size_t minimumResampleFrequency{1000};
+	const std::size_t maximumResampleFrequency{192000};
+}
+
+// NaN fails every comparison, so it's ruled out along with infinity before the range is checked
+std::string PhaseVocoderSettings::ValidateStretchFactor(double stretchFactor)
+{
+	if(!std::isfinite(stretchFactor) || stretchFactor < minimumStretchFactor || stretchFactor > maximumStretchFactor)
+	{
+		return Utilities::CreateString(" ", "Given stretch factor out of range.  Min:", minimumStretchFactor, " Max:", maximumStretchFactor);
+	}
+
+	return "";
+}
+
+std::string PhaseVocoderSettings::ValidatePitchShiftValue(double pitchShiftValue)
+{
+	if(!std::isfinite(pitchShiftValue) || pitchShiftValue < minimumPitchShift || pitchShiftValue > maximumPitchShift)
+	{
+		return Utilities::CreateString(" ", "Given pitch setting out of range.  Min:", minimumPitchShift, " Max:", maximumPitchShift);
+	}
+
+	return "";
+}
+
+std::string PhaseVocoderSettings::ValidateResampleValue(double resampleValue)
+{
+	if(!std::isfinite(resampleValue) || resampleValue < minimumResampleFrequency || resampleValue > maximumResampleFrequency)
+	{
+		return Utilities::CreateString(" ", "Given resample setting out of range.  Min:", minimumResampleFrequency, " Max:", maximumResampleFrequency);
+	}
+
+	return "";
+}
+
+std::string PhaseVocoderSettings::ValidateValleyToPeakRatio(double valleyToPeakRatio)
+{
+	if(!std::isfinite(valleyToPeakRatio) || valleyToPeakRatio <= 0.0)
+	{
+		return "Given valley to peak ratio must be greater than zero";
+	}
+
+	return "";
+}
 
 void PhaseVocoderSettings::SetInputWaveFile(const std::string& filename)
 {
@@ -40,10 +98,16 @@ void PhaseVocoderSettings::SetOutputWaveFile(const std::string& filename)
 
 void PhaseVocoderSettings::SetStretchFactor(double stretchFactor)
 {
-	stretchFactor_ = stretchFactor;	
+	stretchFactors_ = std::vector<double>{stretchFactor};
 	stretchFactorGiven_ = true;
 }
 
+void PhaseVocoderSettings::SetStretchFactors(const std::vector<double>& stretchFactors)
+{
+	stretchFactors_ = stretchFactors;
+	stretchFactorGiven_ = (stretchFactors_.size() != 0);
+}
+
 void PhaseVocoderSettings::SetResampleValue(std::size_t resampleValue)
 {
 	resampleValue_ = resampleValue;
@@ -62,11 +126,60 @@ void PhaseVocoderSettings::SetValleyToPeakRatio(double valleyToPeakRatio)
 	valleyToPeakRatioGiven_ = true;
 }
 
+void PhaseVocoderSettings::SetTransientCacheDirectory(const std::string& transientCacheDirectory)
+{
+	transientCacheDirectory_ = transientCacheDirectory;
+	transientCacheDirectoryGiven_ = true;
+}
+
+void PhaseVocoderSettings::SetQualityPreset(QualityPreset qualityPreset)
+{
+	qualityPreset_ = qualityPreset;
+	qualityPresetGiven_ = true;
+}
+
+void PhaseVocoderSettings::SetRangeStart(double position, bool inSeconds)
+{
+	rangeStart_ = position;
+	rangeStartInSeconds_ = inSeconds;
+	rangeStartGiven_ = true;
+}
+
+void PhaseVocoderSettings::SetRangeEnd(double position, bool inSeconds)
+{
+	rangeEnd_ = position;
+	rangeEndInSeconds_ = inSeconds;
+	rangeEndGiven_ = true;
+}
+
+void PhaseVocoderSettings::SetReadAheadBlocks(std::size_t readAheadBlocks)
+{
+	readAheadBlocks_ = readAheadBlocks;
+	readAheadGiven_ = true;
+}
+
+void PhaseVocoderSettings::SetMaxMemory(std::size_t maxMemory)
+{
+	maxMemory_ = maxMemory;
+	maxMemoryGiven_ = true;
+}
+
+void PhaseVocoderSettings::SetMinSectionLength(std::size_t minSectionLength)
+{
+	minSectionLength_ = minSectionLength;
+	minSectionLengthGiven_ = true;
+}
+
 void PhaseVocoderSettings::SetDisplayTransients()
 {
 	displayTransients_ = true;
 }
 
+void PhaseVocoderSettings::SetIncrementalRender()
+{
+	incrementalRender_ = true;
+}
+
 void PhaseVocoderSettings::SetTransientConfigFilename(const std::string& transientConfgFilename)
 {
 	transientConfigFilename_ = transientConfgFilename;
@@ -88,6 +201,11 @@ bool PhaseVocoderSettings::StretchFactorGiven() const
 	return stretchFactorGiven_;
 }
 
+bool PhaseVocoderSettings::MultipleStretchFactorsGiven() const
+{
+	return stretchFactors_.size() > 1;
+}
+
 bool PhaseVocoderSettings::ResampleValueGiven() const
 {
 	return resampleValueGiven_;
@@ -103,6 +221,46 @@ bool PhaseVocoderSettings::ValleyToPeakRatioGiven() const
 	return valleyToPeakRatioGiven_;
 }
 
+bool PhaseVocoderSettings::TransientCacheDirectoryGiven() const
+{
+	return transientCacheDirectoryGiven_;
+}
+
+bool PhaseVocoderSettings::QualityPresetGiven() const
+{
+	return qualityPresetGiven_;
+}
+
+bool PhaseVocoderSettings::RangeStartGiven() const
+{
+	return rangeStartGiven_;
+}
+
+bool PhaseVocoderSettings::RangeEndGiven() const
+{
+	return rangeEndGiven_;
+}
+
+bool PhaseVocoderSettings::RenderRangeGiven() const
+{
+	return rangeStartGiven_ || rangeEndGiven_;
+}
+
+bool PhaseVocoderSettings::ReadAheadGiven() const
+{
+	return readAheadGiven_;
+}
+
+bool PhaseVocoderSettings::MaxMemoryGiven() const
+{
+	return maxMemoryGiven_;
+}
+
+bool PhaseVocoderSettings::MinSectionLengthGiven() const
+{
+	return minSectionLengthGiven_;
+}
+
 bool PhaseVocoderSettings::TransientConfigFilenameGiven() const
 {
 	return transientConfigFilenameGiven_;
@@ -113,6 +271,11 @@ bool PhaseVocoderSettings::DisplayTransients() const
 	return displayTransients_;
 }
 
+bool PhaseVocoderSettings::IncrementalRender() const
+{
+	return incrementalRender_;
+}
+
 const std::string& PhaseVocoderSettings::GetInputWaveFile() const
 {
 	return inputWaveFilename_;
@@ -125,7 +288,17 @@ const std::string& PhaseVocoderSettings::GetOutputWaveFile() const
 
 double PhaseVocoderSettings::GetStretchFactor() const
 {
-	return stretchFactor_;
+	if(stretchFactors_.size() == 0)
+	{
+		return 0.0;
+	}
+
+	return stretchFactors_[0];
+}
+
+const std::vector<double>& PhaseVocoderSettings::GetStretchFactors() const
+{
+	return stretchFactors_;
 }
 
 std::size_t PhaseVocoderSettings::GetResampleValue() const
@@ -146,4 +319,62 @@ const std::string& PhaseVocoderSettings::GetTransientConfigFilename() const
 double PhaseVocoderSettings::GetValleyToPeakRatio() const
 {
 	return valleyToPeakRatio_;
+}
+
+const std::string& PhaseVocoderSettings::GetTransientCacheDirectory() const
+{
+	return transientCacheDirectory_;
+}
+
+PhaseVocoderSettings::QualityPreset PhaseVocoderSettings::GetQualityPreset() const
+{
+	return qualityPreset_;
+}
+
+double PhaseVocoderSettings::GetProcessingRateRatio() const
+{
+	switch(qualityPreset_)
+	{
+		case QualityPreset::MEDIUM:
+			return 0.5;
+		case QualityPreset::DRAFT:
+			return 0.25;
+		default:
+			return 1.0;
+	}
+}
+
+std::size_t PhaseVocoderSettings::GetReadAheadBlocks() const
+{
+	return readAheadBlocks_;
+}
+
+std::size_t PhaseVocoderSettings::GetMaxMemory() const
+{
+	return maxMemory_;
+}
+
+std::size_t PhaseVocoderSettings::GetMinSectionLength() const
+{
+	return minSectionLength_;
+}
+
+std::size_t PhaseVocoderSettings::GetRangeStartSample(std::size_t sampleRate) const
+{
+	if(rangeStartInSeconds_)
+	{
+		return static_cast<std::size_t>(rangeStart_ * sampleRate + 0.5);
+	}
+
+	return static_cast<std::size_t>(rangeStart_);
+}
+
+std::size_t PhaseVocoderSettings::GetRangeEndSample(std::size_t sampleRate) const
+{
+	if(rangeEndInSeconds_)
+	{
+		return static_cast<std::size_t>(rangeEnd_ * sampleRate + 0.5);
+	}
+
+	return static_cast<std::size_t>(rangeEnd_);
 }
\ No newline at end of file
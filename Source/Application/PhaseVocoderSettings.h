@@ -29,38 +29,79 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <vector>
 
 class PhaseVocoderSettings
 {
 	public:
+		// Lower quality presets run the phase vocoder at a reduced internal sample rate (the input is 
+		// resampled down before the phase vocoder and back up after it).  This is much faster and is 
+		// meant for quickly auditioning a stretch.
+		enum class QualityPreset { HIGH, MEDIUM, DRAFT };
+
+		// The values the stretch, pitch, resample and transient settings accept, shared by the command line 
+		// and the engine's C API.  Each returns why the value isn't accepted, or an empty string if it is.
+		static std::string ValidateStretchFactor(double stretchFactor);
+		static std::string ValidatePitchShiftValue(double pitchShiftValue);
+		static std::string ValidateResampleValue(double resampleValue);
+		static std::string ValidateValleyToPeakRatio(double valleyToPeakRatio);
+
 		// Typical setter methods
 		void SetInputWaveFile(const std::string& filename);
 		void SetOutputWaveFile(const std::string& filename);
 		void SetStretchFactor(double stretchFactor);
+		void SetStretchFactors(const std::vector<double>& stretchFactors);
 		void SetResampleValue(std::size_t resampleValue);
 		void SetPitchShiftValue(double pitchShiftValue);
 		void SetTransientConfigFilename(const std::string& transientConfgFilename);
 		void SetDisplayTransients();
+		void SetIncrementalRender();
 		void SetValleyToPeakRatio(double valleyToPeakRatio);
+		void SetTransientCacheDirectory(const std::string& transientCacheDirectory);
+		void SetQualityPreset(QualityPreset qualityPreset);
+		void SetRangeStart(double position, bool inSeconds);  // Position is a sample position unless inSeconds is true
+		void SetRangeEnd(double position, bool inSeconds);
+		void SetReadAheadBlocks(std::size_t readAheadBlocks);
+		void SetMaxMemory(std::size_t maxMemory);
+		void SetMinSectionLength(std::size_t minSectionLength);
 
 		// Methods to check if a value was actually given
 		bool InputWaveFileGiven() const;
 		bool OutputWaveFileGiven() const;
 		bool StretchFactorGiven() const;
+		bool MultipleStretchFactorsGiven() const;
 		bool ResampleValueGiven() const;
 		bool PitchShiftValueGiven() const;
 		bool TransientConfigFilenameGiven() const;
 		bool DisplayTransients() const;
+		bool IncrementalRender() const;
 		bool ValleyToPeakRatioGiven() const;
+		bool TransientCacheDirectoryGiven() const;
+		bool QualityPresetGiven() const;
+		bool RangeStartGiven() const;
+		bool RangeEndGiven() const;
+		bool RenderRangeGiven() const;
+		bool ReadAheadGiven() const;
+		bool MaxMemoryGiven() const;
+		bool MinSectionLengthGiven() const;
 
 		// Typical getter methods
 		const std::string& GetInputWaveFile() const;
 		const std::string& GetOutputWaveFile() const;
 		double GetStretchFactor() const;
+		const std::vector<double>& GetStretchFactors() const;
 		std::size_t GetResampleValue() const;
 		double GetPitchShiftValue() const;
 		const std::string& GetTransientConfigFilename() const;
 		double GetValleyToPeakRatio() const;
+		const std::string& GetTransientCacheDirectory() const;
+		QualityPreset GetQualityPreset() const;
+		double GetProcessingRateRatio() const;  // Internal phase vocoder sample rate relative to the input's
+		std::size_t GetRangeStartSample(std::size_t sampleRate) const;
+		std::size_t GetRangeEndSample(std::size_t sampleRate) const;
+		std::size_t GetReadAheadBlocks() const;  // Blocks of input to prefetch per channel on a background thread
+		std::size_t GetMaxMemory() const;  // In megabytes.  Bounds the size of sections and of the output buffering.
+		std::size_t GetMinSectionLength() const;  // In milliseconds.  Transients closer than this to the previous one are merged into its section.
 
 	private:
 		std::string inputWaveFilename_;
@@ -69,7 +110,7 @@ class PhaseVocoderSettings
 		std::string outputWaveFilename_;
 		bool outputWaveFilenameGiven_{false};
 
-		double stretchFactor_;
+		std::vector<double> stretchFactors_;  // More than one factor renders one output per factor
 		bool stretchFactorGiven_{false};
 
 		std::size_t resampleValue_;
@@ -80,9 +121,34 @@ class PhaseVocoderSettings
 
 		bool displayTransients_{false};
 
+		bool incrementalRender_{false};
+
 		std::string transientConfigFilename_;
 		bool transientConfigFilenameGiven_{false};
 
 		double valleyToPeakRatio_{1.5};
 		bool valleyToPeakRatioGiven_{false};
+
+		std::string transientCacheDirectory_;
+		bool transientCacheDirectoryGiven_{false};
+
+		QualityPreset qualityPreset_{QualityPreset::HIGH};
+		bool qualityPresetGiven_{false};
+
+		double rangeStart_{0.0};
+		bool rangeStartInSeconds_{false};
+		bool rangeStartGiven_{false};
+
+		double rangeEnd_{0.0};
+		bool rangeEndInSeconds_{false};
+		bool rangeEndGiven_{false};
+
+		std::size_t readAheadBlocks_{0};
+		bool readAheadGiven_{false};
+
+		std::size_t maxMemory_{0};
+		bool maxMemoryGiven_{false};
+
+		std::size_t minSectionLength_{0};
+		bool minSectionLengthGiven_{false};
 };
\ No newline at end of file
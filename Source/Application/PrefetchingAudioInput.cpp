@@ -0,0 +1,284 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/PrefetchingAudioInput.h>
+#include <Application/Trace.h>
+#include <Utilities/Exception.h>
+#include <algorithm>
+
+PrefetchingAudioInput::PrefetchingAudioInput(std::shared_ptr<AudioInput> audioInput, std::size_t readAheadBlocks, std::size_t blockSize) : 
+	audioInput_{audioInput}, readAheadBlocks_{readAheadBlocks}, blockSize_{std::max<std::size_t>(blockSize, 1)}
+{
+	blockCount_ = (audioInput_->GetSampleCount() + blockSize_ - 1) / blockSize_;
+	streams_.resize(audioInput_->GetChannels());
+
+	readAheadThread_ = std::thread([this]{ ReadAhead(); });
+}
+
+PrefetchingAudioInput::~PrefetchingAudioInput()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+
+	blockWanted_.notify_all();
+	readAheadThread_.join();
+}
+
+std::size_t PrefetchingAudioInput::GetSampleRate()
+{
+	return audioInput_->GetSampleRate();
+}
+
+std::size_t PrefetchingAudioInput::GetChannels()
+{
+	return audioInput_->GetChannels();
+}
+
+std::size_t PrefetchingAudioInput::GetBitsPerSample()
+{
+	return audioInput_->GetBitsPerSample();
+}
+
+std::size_t PrefetchingAudioInput::GetSampleCount()
+{
+	return audioInput_->GetSampleCount();
+}
+
+std::size_t PrefetchingAudioInput::GetBlocksPrefetched()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return blocksPrefetched_;
+}
+
+AudioData PrefetchingAudioInput::ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount)
+{
+	if(streamID >= streams_.size())
+	{
+		Utilities::ThrowException("Invalid stream ID given to PrefetchingAudioInput", streamID);
+	}
+
+	auto endSample{std::min(startSample + sampleCount, GetSampleCount())};
+
+	AudioData audioData;
+	for(auto position{startSample}; position < endSample; )
+	{
+		auto block{position / blockSize_};
+		auto blockData{GetBlock(streamID, block)};
+
+		auto offset{position - block * blockSize_};
+		auto samplesToCopy{std::min(endSample - position, blockData->GetSize() - offset)};
+		audioData.Append(std::vector<double>(blockData->GetData().begin() + offset, blockData->GetData().begin() + offset + samplesToCopy));
+
+		position += samplesToCopy;
+	}
+
+	return audioData;
+}
+
+void PrefetchingAudioInput::SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	memoryAccounting_ = memoryAccounting;
+}
+
+// The block last read and those read ahead of it.  Called with the mutex held.
+bool PrefetchingAudioInput::InWindow(const Stream& stream, std::size_t block) const
+{
+	return block + 1 >= stream.nextBlock_ && block < stream.nextBlock_ + readAheadBlocks_;
+}
+
+// Called with the mutex held
+void PrefetchingAudioInput::DropBlocksOutside(std::size_t streamID, std::size_t firstBlock, std::size_t endBlock)
+{
+	auto& stream{streams_[streamID]};
+
+	auto DropBlocks = [&](Blocks::iterator begin, Blocks::iterator end)
+	{
+		if(memoryAccounting_)
+		{
+			for(auto element{begin}; element != end; ++element)
+			{
+				memoryAccounting_->Remove(MemoryAccounting::Stage::READER, streamID, element->second->GetSize() * sizeof(double));
+			}
+		}
+
+		stream.blocks_.erase(begin, end);
+	};
+
+	DropBlocks(stream.blocks_.begin(), stream.blocks_.lower_bound(firstBlock));
+	DropBlocks(stream.blocks_.lower_bound(endBlock), stream.blocks_.end());
+
+	stream.failedBlocks_.erase(stream.failedBlocks_.begin(), stream.failedBlocks_.lower_bound(firstBlock));
+	stream.failedBlocks_.erase(stream.failedBlocks_.lower_bound(endBlock), stream.failedBlocks_.end());
+}
+
+std::shared_ptr<const AudioData> PrefetchingAudioInput::GetBlock(std::size_t streamID, std::size_t block)
+{
+	std::shared_ptr<const AudioData> blockData;
+	std::exception_ptr readException;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		auto& stream{streams_[streamID]};
+
+		// Move the read ahead window along (or back, for another pass) and drop everything outside it
+		stream.nextBlock_ = block + 1;
+		DropBlocksOutside(streamID, block, stream.nextBlock_ + readAheadBlocks_);
+
+		blockRead_.wait(lock, [&]{ return stream.blocksInFlight_.count(block) == 0; });
+
+		auto element{stream.blocks_.find(block)};
+		if(element != stream.blocks_.end())
+		{
+			blockData = element->second;
+			++blocksPrefetched_;
+		}
+
+		auto failedBlock{stream.failedBlocks_.find(block)};
+		if(failedBlock != stream.failedBlocks_.end())
+		{
+			readException = failedBlock->second;
+			stream.failedBlocks_.erase(failedBlock);
+		}
+	}
+
+	blockWanted_.notify_one();
+
+	if(readException)
+	{
+		std::rethrow_exception(readException);
+	}
+
+	if(!blockData)
+	{
+		blockData = ReadBlock(streamID, block);
+	}
+
+	return blockData;
+}
+
+std::shared_ptr<const AudioData> PrefetchingAudioInput::ReadBlock(std::size_t streamID, std::size_t block)
+{
+	TraceSpan span{"Read Block", "reader", streamID, "block", block};
+
+	return std::make_shared<const AudioData>(audioInput_->ReadAudioStream(streamID, block * blockSize_, blockSize_));
+}
+
+void PrefetchingAudioInput::ReadAhead()
+{
+	if(Trace::IsRecording())
+	{
+		Trace::SetThreadName("Read Ahead");
+	}
+
+	while(true)
+	{
+		std::size_t streamID{0};
+		std::size_t block{0};
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			blockWanted_.wait(lock, [&]{ return stopping_ || FindBlockToPrefetch(streamID, block); });
+
+			if(stopping_)
+			{
+				return;
+			}
+
+			streams_[streamID].blocksInFlight_.insert(block);
+		}
+
+		// An exception escaping this thread would terminate the process, so it's kept for the stream instead
+		std::shared_ptr<const AudioData> blockData;
+		std::exception_ptr readException;
+		try
+		{
+			blockData = ReadBlock(streamID, block);
+		}
+		catch(...)
+		{
+			readException = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto& stream{streams_[streamID]};
+			stream.blocksInFlight_.erase(block);
+
+			// The stream may have moved past this block (or back from it) while it was being read
+			if(readException)
+			{
+				if(InWindow(stream, block))
+				{
+					stream.failedBlocks_[block] = readException;
+				}
+			}
+			else if(InWindow(stream, block))
+			{
+				stream.blocks_[block] = blockData;
+				if(memoryAccounting_)
+				{
+					memoryAccounting_->Add(MemoryAccounting::Stage::READER, streamID, blockData->GetSize() * sizeof(double));
+				}
+			}
+		}
+
+		blockRead_.notify_all();
+	}
+}
+
+// Picks the stream with the fewest blocks read ahead so all streams progress together
+bool PrefetchingAudioInput::FindBlockToPrefetch(std::size_t& streamID, std::size_t& block)
+{
+	bool found{false};
+	std::size_t fewestBlocksAhead{readAheadBlocks_};
+
+	for(std::size_t i{0}; i < streams_.size(); ++i)
+	{
+		const auto& stream{streams_[i]};
+		auto windowEnd{std::min(stream.nextBlock_ + readAheadBlocks_, blockCount_)};
+
+		for(auto candidate{stream.nextBlock_}; candidate < windowEnd; ++candidate)
+		{
+			if(stream.blocks_.count(candidate) == 0 && stream.failedBlocks_.count(candidate) == 0 && stream.blocksInFlight_.count(candidate) == 0)
+			{
+				if(candidate - stream.nextBlock_ < fewestBlocksAhead)
+				{
+					fewestBlocksAhead = candidate - stream.nextBlock_;
+					streamID = i;
+					block = candidate;
+					found = true;
+				}
+
+				break;
+			}
+		}
+	}
+
+	return found;
+}
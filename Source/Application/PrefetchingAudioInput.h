@@ -0,0 +1,101 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <Application/AudioInput.h>
+#include <Application/MemoryAccounting.h>
+
+// Wraps another AudioInput, reading ahead of each stream on a background thread so processing doesn't 
+// stall on every read when the input is on slow storage.
+//
+// The input is read in fixed size blocks.  Each stream keeps a window of blocks following the last one 
+// it read.  The processors read each stream sequentially (once for transient detection and once for 
+// processing) so blocks behind the last one read are dropped, as are blocks read ahead of a position a 
+// stream has gone back from for another pass.  Reads of blocks not yet prefetched are 
+// done on the calling thread.  A read that fails on the background thread is rethrown to the stream 
+// when it gets to that block.
+class PrefetchingAudioInput : public AudioInput
+{
+	public:
+		PrefetchingAudioInput(std::shared_ptr<AudioInput> audioInput, std::size_t readAheadBlocks, std::size_t blockSize = 8192);
+		virtual ~PrefetchingAudioInput();
+
+		std::size_t GetSampleRate() override;
+		std::size_t GetChannels() override;
+		std::size_t GetBitsPerSample() override;
+		std::size_t GetSampleCount() override;
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override;
+
+		std::size_t GetBlocksPrefetched();  // Blocks read by the background thread and later used
+
+		// Optional.  Blocks read ahead are recorded as reader memory.
+		void SetMemoryAccounting(std::shared_ptr<MemoryAccounting> memoryAccounting);
+
+	private:
+		using Blocks = std::map<std::size_t, std::shared_ptr<const AudioData>>;
+
+		struct Stream
+		{
+			Blocks blocks_;
+			std::map<std::size_t, std::exception_ptr> failedBlocks_;
+			std::set<std::size_t> blocksInFlight_;
+			std::size_t nextBlock_{0};  // The block following the last one read
+		};
+
+		std::shared_ptr<const AudioData> GetBlock(std::size_t streamID, std::size_t block);
+		std::shared_ptr<const AudioData> ReadBlock(std::size_t streamID, std::size_t block);
+		void ReadAhead();
+		bool FindBlockToPrefetch(std::size_t& streamID, std::size_t& block);
+		bool InWindow(const Stream& stream, std::size_t block) const;
+		void DropBlocksOutside(std::size_t streamID, std::size_t firstBlock, std::size_t endBlock);
+
+		std::shared_ptr<AudioInput> audioInput_;
+		std::size_t readAheadBlocks_;
+		std::size_t blockSize_;
+		std::size_t blockCount_;
+
+		std::vector<Stream> streams_;
+		std::size_t blocksPrefetched_{0};
+
+		std::shared_ptr<MemoryAccounting> memoryAccounting_;
+
+		std::mutex mutex_;
+		std::condition_variable blockWanted_;
+		std::condition_variable blockRead_;
+		bool stopping_{false};
+
+		std::thread readAheadThread_;
+};
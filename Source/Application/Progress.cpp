@@ -0,0 +1,190 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/Progress.h>
+#include <Utilities/Exception.h>
+#include <algorithm>
+
+double Progress::GetFractionComplete() const
+{
+	std::size_t samplesToConsume{0};
+	std::size_t samplesConsumed{0};
+	for(const auto& stream : streams_)
+	{
+		samplesToConsume += stream.samplesToConsume_;
+		samplesConsumed += std::min(stream.samplesConsumed_, stream.samplesToConsume_);
+	}
+
+	if(finished_)
+	{
+		return 1.0;
+	}
+
+	if(samplesToConsume == 0)
+	{
+		return 0.0;
+	}
+
+	return static_cast<double>(samplesConsumed) / static_cast<double>(samplesToConsume);
+}
+
+double Progress::GetEstimatedSecondsRemaining() const
+{
+	auto fractionComplete{GetFractionComplete()};
+	if(fractionComplete <= 0.0)
+	{
+		return 0.0;
+	}
+
+	return elapsedSeconds_ * (1.0 - fractionComplete) / fractionComplete;
+}
+
+void Progress::WriteStatus(std::ostream& stream) const
+{
+	stream << "{\"state\": \"" << (finished_ ? "finished" : "running") << "\", \"elapsedSeconds\": " << elapsedSeconds_;
+	stream << ", \"fractionComplete\": " << GetFractionComplete() << ", \"realtimeFactor\": " << realtimeFactor_;
+	stream << ", \"secondsRemaining\": " << GetEstimatedSecondsRemaining() << ", \"streams\": [";
+
+	for(std::size_t streamID{0}; streamID < streams_.size(); ++streamID)
+	{
+		const auto& streamProgress{streams_[streamID]};
+		stream << (streamID ? ", " : "") << "{\"stream\": " << streamID << ", \"samplesToConsume\": " << streamProgress.samplesToConsume_;
+		stream << ", \"samplesConsumed\": " << streamProgress.samplesConsumed_ << ", \"samplesProduced\": " << streamProgress.samplesProduced_;
+		stream << ", \"section\": " << streamProgress.currentSection_ << ", \"sectionCount\": " << streamProgress.sectionCount_;
+		stream << ", \"finished\": " << (streamProgress.finished_ ? "true" : "false") << "}";
+	}
+
+	stream << "]}" << std::endl;
+}
+
+ProgressTracker::ProgressTracker(std::size_t streamCount, std::size_t sampleRate, ProgressCallback callback, double reportInterval) : 
+	callback_{callback}, 
+	reportInterval_{reportInterval}, 
+	startTime_{std::chrono::steady_clock::now()}
+{
+	progress_.streams_.resize(streamCount);
+	progress_.sampleRate_ = sampleRate;
+}
+
+void ProgressTracker::SetSamplesToConsume(std::size_t streamID, std::size_t samplesToConsume, std::size_t sectionCount)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if(streamID >= progress_.streams_.size())
+	{
+		Utilities::ThrowException("Invalid stream ID given to ProgressTracker", streamID);
+	}
+
+	progress_.streams_[streamID].samplesToConsume_ = samplesToConsume;
+	progress_.streams_[streamID].sectionCount_ = sectionCount;
+}
+
+void ProgressTracker::SectionStarted(std::size_t streamID, std::size_t sectionIndex)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	progress_.streams_.at(streamID).currentSection_ = sectionIndex + 1;
+	ReportIfDue();
+}
+
+void ProgressTracker::SamplesConsumed(std::size_t streamID, std::size_t sampleCount)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	progress_.streams_.at(streamID).samplesConsumed_ += sampleCount;
+	ReportIfDue();
+}
+
+void ProgressTracker::SamplesProduced(std::size_t streamID, std::size_t sampleCount)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	progress_.streams_.at(streamID).samplesProduced_ += sampleCount;
+	ReportIfDue();
+}
+
+void ProgressTracker::StreamFinished(std::size_t streamID)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	progress_.streams_.at(streamID).finished_ = true;
+}
+
+void ProgressTracker::Finish()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	progress_.finished_ = true;
+	Report();
+}
+
+Progress ProgressTracker::GetProgress()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return progress_;
+}
+
+void ProgressTracker::ReportIfDue()
+{
+	auto now{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count()};
+	if(now - lastReportTime_ >= reportInterval_)
+	{
+		Report();
+	}
+}
+
+// Expects the mutex to be held
+void ProgressTracker::Report()
+{
+	auto now{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count()};
+	auto secondsConsumed{GetAverageSecondsConsumed()};
+
+	progress_.elapsedSeconds_ = now;
+	if(now > lastReportTime_)
+	{
+		progress_.realtimeFactor_ = (secondsConsumed - lastReportSecondsConsumed_) / (now - lastReportTime_);
+	}
+
+	lastReportTime_ = now;
+	lastReportSecondsConsumed_ = secondsConsumed;
+
+	if(callback_)
+	{
+		callback_(progress_);
+	}
+}
+
+// Channels are processed side by side, so the input processed is the average across them
+double ProgressTracker::GetAverageSecondsConsumed() const
+{
+	if(progress_.streams_.empty() || progress_.sampleRate_ == 0)
+	{
+		return 0.0;
+	}
+
+	std::size_t samplesConsumed{0};
+	for(const auto& stream : progress_.streams_)
+	{
+		samplesConsumed += stream.samplesConsumed_;
+	}
+
+	return static_cast<double>(samplesConsumed) / static_cast<double>(progress_.streams_.size()) / static_cast<double>(progress_.sampleRate_);
+}
@@ -0,0 +1,96 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+#include <ostream>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <cstddef>
+
+// A snapshot of how far a render has got
+struct Progress
+{
+	struct Stream
+	{
+		std::size_t samplesToConsume_{0};  // Input samples this stream will read (less when rendering a range)
+		std::size_t samplesConsumed_{0};
+		std::size_t samplesProduced_{0};   // Output samples written, summed across outputs
+		std::size_t currentSection_{0};    // Counting from one.  Zero until the first section starts.
+		std::size_t sectionCount_{0};
+		bool finished_{false};
+	};
+
+	std::vector<Stream> streams_;  // One per channel
+	std::size_t sampleRate_{0};    // Of the input
+	double elapsedSeconds_{0.0};
+	double realtimeFactor_{0.0};   // Seconds of input processed per second since the previous report
+	bool finished_{false};
+
+	double GetFractionComplete() const;
+	double GetEstimatedSecondsRemaining() const;  // At the average rate so far
+
+	// A single line of JSON, for schedulers polling a render's status
+	void WriteStatus(std::ostream& stream) const;
+};
+
+using ProgressCallback = std::function<void(const Progress&)>;
+
+// Collects progress from the processors (one per channel thread, plus a thread per extra output) and 
+// passes a snapshot to the callback at most once per report interval, on whichever thread is processing 
+// at the time.  The callback should return quickly as processing waits on it.
+class ProgressTracker
+{
+	public:
+		ProgressTracker(std::size_t streamCount, std::size_t sampleRate, ProgressCallback callback, double reportInterval);
+
+		void SetSamplesToConsume(std::size_t streamID, std::size_t samplesToConsume, std::size_t sectionCount);
+		void SectionStarted(std::size_t streamID, std::size_t sectionIndex);
+		void SamplesConsumed(std::size_t streamID, std::size_t sampleCount);
+		void SamplesProduced(std::size_t streamID, std::size_t sampleCount);
+		void StreamFinished(std::size_t streamID);
+
+		// Sends a last report for the render
+		void Finish();
+
+		Progress GetProgress();
+
+	private:
+		void ReportIfDue();
+		void Report();
+		double GetAverageSecondsConsumed() const;
+
+		std::mutex mutex_;
+		Progress progress_;
+		ProgressCallback callback_;
+		double reportInterval_;
+
+		std::chrono::steady_clock::time_point startTime_;
+		double lastReportTime_{0.0};
+		double lastReportSecondsConsumed_{0.0};
+};
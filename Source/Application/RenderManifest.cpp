@@ -0,0 +1,189 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/RenderManifest.h>
+#include <Utilities/Exception.h>
+#include <Utilities/Stringify.h>
+#include <yaml-cpp/yaml.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+RenderManifest::RenderManifest(std::size_t streamCount, const std::string& settingsHash) : 
+	settingsHash_{settingsHash}, streams_(streamCount)
+{
+
+}
+
+RenderManifest::RenderManifest(const std::string& filename)
+{
+	ReadManifestFile(filename);
+}
+
+RenderManifest::~RenderManifest() { }
+
+void RenderManifest::ReadManifestFile(const std::string& filename)
+{
+	try
+	{
+		YAML::Node manifest = YAML::LoadFile(filename);
+
+		settingsHash_ = manifest["settings_hash"].as<std::string>();
+
+		for(auto stream : manifest["streams"])
+		{
+			std::vector<Section> sections;
+			for(auto sectionNode : stream)
+			{
+				Section section;
+				section.start_ = sectionNode["start"].as<std::size_t>();
+				section.end_ = sectionNode["end"].as<std::size_t>();
+				section.outputOffset_ = sectionNode["output_offset"].as<std::size_t>();
+				section.outputLength_ = sectionNode["output_length"].as<std::size_t>();
+				for(auto sample : sectionNode["crossfade_tail"])
+				{
+					section.crossfadeTail_.push_back(sample.as<double>());
+				}
+
+				sections.push_back(section);
+			}
+
+			streams_.push_back(sections);
+		}
+	}
+	catch(std::exception& theException)
+	{
+		auto exceptionWhat{Utilities::CreateString(" ", "Exception trying to read render manifest file", filename, "Message from yaml-cpp lib:", theException.what())};
+		Utilities::ThrowException(exceptionWhat);
+	}
+}
+
+void RenderManifest::Save(const std::string& filename) const
+{
+	YAML::Emitter emitter;
+	emitter.SetDoublePrecision(17);  // Enough to round trip the crossfade tails exactly
+
+	emitter << YAML::BeginMap;
+	emitter << YAML::Key << "settings_hash" << YAML::Value << settingsHash_;
+	emitter << YAML::Key << "streams" << YAML::Value << YAML::BeginSeq;
+	for(const auto& sections : streams_)
+	{
+		emitter << YAML::BeginSeq;
+		for(const auto& section : sections)
+		{
+			emitter << YAML::BeginMap;
+			emitter << YAML::Key << "start" << YAML::Value << section.start_;
+			emitter << YAML::Key << "end" << YAML::Value << section.end_;
+			emitter << YAML::Key << "output_offset" << YAML::Value << section.outputOffset_;
+			emitter << YAML::Key << "output_length" << YAML::Value << section.outputLength_;
+			emitter << YAML::Key << "crossfade_tail" << YAML::Value << YAML::Flow << section.crossfadeTail_;
+			emitter << YAML::EndMap;
+		}
+		emitter << YAML::EndSeq;
+	}
+	emitter << YAML::EndSeq;
+	emitter << YAML::EndMap;
+
+	std::ofstream file(filename, std::ios::trunc);
+	if(!file)
+	{
+		Utilities::ThrowException("Unable to write render manifest file", filename);
+	}
+
+	file << emitter.c_str() << std::endl;
+}
+
+const std::string& RenderManifest::GetSettingsHash() const
+{
+	return settingsHash_;
+}
+
+std::size_t RenderManifest::GetStreamCount() const
+{
+	return streams_.size();
+}
+
+void RenderManifest::AddSection(std::size_t streamID, const Section& section)
+{
+	streams_[streamID].push_back(section);
+}
+
+const std::vector<RenderManifest::Section>& RenderManifest::GetSections(std::size_t streamID) const
+{
+	return streams_[streamID];
+}
+
+const RenderManifest::Section* RenderManifest::FindReusableSection(std::size_t streamID, std::size_t start, std::size_t end, 
+																	bool hasPredecessor, std::size_t predecessorStart) const
+{
+	if(streamID >= streams_.size())
+	{
+		return nullptr;
+	}
+
+	const auto& sections{streams_[streamID]};
+
+	// Sections are added in order so they're sorted by start position
+	auto section{std::lower_bound(sections.begin(), sections.end(), start, 
+		[](const Section& section, std::size_t position) { return section.start_ < position; })};
+
+	if(section == sections.end() || section->start_ != start || section->end_ != end)
+	{
+		return nullptr;
+	}
+
+	if(section == sections.begin())
+	{
+		return hasPredecessor ? nullptr : &(*section);
+	}
+
+	auto predecessor{section - 1};
+	if(!hasPredecessor || predecessor->start_ != predecessorStart || predecessor->end_ != start)
+	{
+		return nullptr;
+	}
+
+	return &(*section);
+}
+
+// A 64 bit FNV-1a hash of the given string as hex
+std::string RenderManifest::HashString(const std::string& stringToHash)
+{
+	const uint64_t fnvPrime{0x100000001b3ULL};
+	uint64_t hash{0xcbf29ce484222325ULL};
+
+	for(auto character : stringToHash)
+	{
+		hash ^= static_cast<unsigned char>(character);
+		hash *= fnvPrime;
+	}
+
+	std::ostringstream hashString;
+	hashString << std::hex << std::setfill('0') << std::setw(16) << hash;
+
+	return hashString.str();
+}
@@ -0,0 +1,76 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// A render manifest records how each transient section of the input was rendered into the output file 
+// so a later render can reuse the output of sections that haven't changed (e.g. after hand tuning a 
+// few transients in a transient config file).  It's saved as a YAML file next to the output.
+//
+// Each stream (channel) has its own list of sections.  A stream's list should only be added to by the 
+// thread processing that stream.
+class RenderManifest
+{
+	public:
+		struct Section
+		{
+			std::size_t start_{0};         // Input sample positions of the section
+			std::size_t end_{0};
+			std::size_t outputOffset_{0};  // Where the section's output starts in the output file
+			std::size_t outputLength_{0};
+			std::vector<double> crossfadeTail_;  // Crossfaded into the start of the next section's output
+		};
+
+		RenderManifest(std::size_t streamCount, const std::string& settingsHash);
+		RenderManifest(const std::string& filename);  // Loads a previously saved manifest
+		virtual ~RenderManifest();
+
+		void Save(const std::string& filename) const;
+
+		const std::string& GetSettingsHash() const;
+		std::size_t GetStreamCount() const;
+
+		void AddSection(std::size_t streamID, const Section& section);
+		const std::vector<Section>& GetSections(std::size_t streamID) const;
+
+		// A section's output can be reused if a section with the same bounds was rendered before, and 
+		// its predecessor was the same too (the predecessor's crossfade tail is mixed into its output).  
+		// Returns null if there is no such section.
+		const Section* FindReusableSection(std::size_t streamID, std::size_t start, std::size_t end, 
+											bool hasPredecessor, std::size_t predecessorStart) const;
+
+		static std::string HashString(const std::string& stringToHash);
+
+	private:
+		void ReadManifestFile(const std::string& filename);
+
+		std::string settingsHash_;
+		std::vector<std::vector<Section>> streams_;
+};
@@ -0,0 +1,235 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/Trace.h>
+#include <Utilities/Exception.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <limits>
+
+std::atomic<bool> Trace::recording_{false};
+
+const std::size_t Trace::noStream{std::numeric_limits<std::size_t>::max()};
+
+namespace
+{
+	// A thread's events.  Its mutex is only ever contended while the trace is being written or restarted 
+	// (the name and inUse_ flag are guarded by buffersMutex).
+	struct ThreadBuffer
+	{
+		std::mutex mutex_;
+		std::size_t threadID_{0};
+		std::string threadName_;
+		std::vector<Trace::Event> events_;
+		bool inUse_{true};
+	};
+
+	// Buffers outlive their threads so a trace can be written after the threads recording it are gone
+	std::mutex buffersMutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+	std::chrono::steady_clock::time_point startTime{std::chrono::steady_clock::now()};
+
+	// Threads started per section (e.g. one per output) would otherwise add a buffer and a track each time, 
+	// so a thread takes over the buffer of a finished thread of the same name when there is one.
+	std::shared_ptr<ThreadBuffer> AcquireBuffer(const std::string& threadName)
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+
+		for(auto& buffer : buffers)
+		{
+			if(!buffer->inUse_ && buffer->threadName_ == threadName)
+			{
+				buffer->inUse_ = true;
+				return buffer;
+			}
+		}
+
+		auto buffer{std::make_shared<ThreadBuffer>()};
+		buffer->threadID_ = buffers.size() + 1;
+		buffer->threadName_ = threadName;
+		buffers.push_back(buffer);
+
+		return buffer;
+	}
+
+	struct ThreadBufferHolder
+	{
+		~ThreadBufferHolder()
+		{
+			if(buffer_)
+			{
+				std::lock_guard<std::mutex> lock(buffersMutex);
+				buffer_->inUse_ = false;
+			}
+		}
+
+		std::shared_ptr<ThreadBuffer> buffer_;
+	};
+
+	thread_local ThreadBufferHolder threadBufferHolder;
+
+	ThreadBuffer& GetThreadBuffer()
+	{
+		if(!threadBufferHolder.buffer_)
+		{
+			threadBufferHolder.buffer_ = AcquireBuffer("");
+		}
+
+		return *threadBufferHolder.buffer_;
+	}
+
+	void WriteString(std::ostream& stream, const std::string& value)
+	{
+		stream << '"';
+		for(auto character : value)
+		{
+			if(character == '"' || character == '\\')
+			{
+				stream << '\\';
+			}
+
+			stream << character;
+		}
+
+		stream << '"';
+	}
+}
+
+void Trace::Start()
+{
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	for(auto& buffer : buffers)
+	{
+		std::lock_guard<std::mutex> bufferLock(buffer->mutex_);
+		buffer->events_.clear();
+	}
+
+	startTime = std::chrono::steady_clock::now();
+	recording_ = true;
+}
+
+void Trace::Stop()
+{
+	recording_ = false;
+}
+
+bool Trace::IsRecording()
+{
+	return recording_.load(std::memory_order_relaxed);
+}
+
+double Trace::GetTime()
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Trace::Record(const Event& event)
+{
+	auto& buffer{GetThreadBuffer()};
+
+	std::lock_guard<std::mutex> lock(buffer.mutex_);
+	buffer.events_.push_back(event);
+}
+
+void Trace::SetThreadName(const std::string& threadName)
+{
+	if(!threadBufferHolder.buffer_)
+	{
+		threadBufferHolder.buffer_ = AcquireBuffer(threadName);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	threadBufferHolder.buffer_->threadName_ = threadName;
+}
+
+void Trace::Write(const std::string& filename)
+{
+	std::ofstream traceFile{filename};
+	if(!traceFile)
+	{
+		Utilities::ThrowException("Unable to write trace file", filename);
+	}
+
+	traceFile << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+
+	bool firstEvent{true};
+	auto separator = [&]() -> const char* { auto text{firstEvent ? "" : ",\n"}; firstEvent = false; return text; };
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	for(auto& buffer : buffers)
+	{
+		std::lock_guard<std::mutex> bufferLock(buffer->mutex_);
+
+		if(buffer->threadName_.size())
+		{
+			traceFile << separator() << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadID_ << ", \"args\": {\"name\": ";
+			WriteString(traceFile, buffer->threadName_);
+			traceFile << "}}";
+		}
+
+		for(const auto& event : buffer->events_)
+		{
+			traceFile << separator() << "{\"name\": \"" << event.name_ << "\", \"cat\": \"" << event.category_ << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadID_;
+			traceFile << std::fixed << ", \"ts\": " << event.start_ << ", \"dur\": " << event.duration_ << std::defaultfloat << ", \"args\": {";
+
+			if(event.streamID_ != noStream)
+			{
+				traceFile << "\"stream\": " << event.streamID_ << (event.argumentName_ ? ", " : "");
+			}
+
+			if(event.argumentName_)
+			{
+				traceFile << "\"" << event.argumentName_ << "\": " << event.argument_;
+			}
+
+			traceFile << "}}";
+		}
+	}
+
+	traceFile << std::endl << "]}" << std::endl;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category, std::size_t streamID, const char* argumentName, std::size_t argument) : 
+	recording_{Trace::IsRecording()}
+{
+	if(recording_)
+	{
+		event_ = Trace::Event{name, category, streamID, Trace::GetTime(), 0.0, argumentName, argument};
+	}
+}
+
+TraceSpan::~TraceSpan()
+{
+	if(recording_)
+	{
+		event_.duration_ = Trace::GetTime() - event_.start_;
+		Trace::Record(event_);
+	}
+}
@@ -0,0 +1,88 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+// Records spans of time (sections, PhaseVocoder and Resampler calls, reads, writes, writer waits) in 
+// Chrome's trace event format, which chrome://tracing and Perfetto display as a timeline per thread.
+//
+// Recording is process wide.  Each thread appends to its own buffer, so recording threads don't contend 
+// with each other, and when recording is off a span costs a single relaxed atomic load.
+class Trace
+{
+	public:
+		static void Start();
+		static void Stop();
+		static bool IsRecording();
+
+		// Writes everything recorded since Start() as JSON
+		static void Write(const std::string& filename);
+
+		// Shown as the name of the calling thread's track
+		static void SetThreadName(const std::string& threadName);
+
+		static const std::size_t noStream;
+
+		struct Event
+		{
+			const char* name_;
+			const char* category_;
+			std::size_t streamID_;
+			double start_;     // Microseconds since Start()
+			double duration_;  // Microseconds
+			const char* argumentName_;
+			std::size_t argument_;
+		};
+
+		// Name, category and argument name must be string literals (only the pointers are kept)
+		static void Record(const Event& event);
+		static double GetTime();
+
+	private:
+		static std::atomic<bool> recording_;
+};
+
+// Records a span from construction to destruction.  An optional argument (e.g. a section's start sample) 
+// is shown alongside the stream ID.
+class TraceSpan
+{
+	public:
+		TraceSpan(const char* name, const char* category, std::size_t streamID = Trace::noStream, 
+					const char* argumentName = nullptr, std::size_t argument = 0);
+		~TraceSpan();
+
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+	private:
+		bool recording_;
+		Trace::Event event_;
+};
@@ -0,0 +1,190 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/TransientCache.h>
+#include <Utilities/Exception.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cstdio>
+#include <random>
+
+TransientCache::TransientCache(const std::string& cacheDirectory, const std::string& inputFilename) : 
+	cacheDirectory_{cacheDirectory}, inputHash_{HashFile(inputFilename)}
+{
+
+}
+
+TransientCache::TransientCache(const std::string& cacheDirectory, uint64_t inputHash) : 
+	cacheDirectory_{cacheDirectory}, inputHash_{inputHash}
+{
+
+}
+
+TransientCache::~TransientCache() { }
+
+bool TransientCache::Load(std::size_t streamID, double valleyToPeakRatio, std::vector<std::size_t>& transients) const
+{
+	std::ifstream file(GetEntryFilename(streamID, valleyToPeakRatio), std::ios::binary);
+	if(!file)
+	{
+		return false;
+	}
+
+	uint32_t magic{0};
+	uint32_t version{0};
+	uint64_t count{0};
+	file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	file.read(reinterpret_cast<char*>(&version), sizeof(version));
+	file.read(reinterpret_cast<char*>(&count), sizeof(count));
+	if(!file || magic != magic_ || version != version_)
+	{
+		return false;
+	}
+
+	// The count comes from disk, so it's only trusted once it matches what the rest of the file holds
+	auto headerEnd{file.tellg()};
+	file.seekg(0, std::ios::end);
+	auto bytesLeft{static_cast<uint64_t>(file.tellg() - headerEnd)};
+	if(!file || count != bytesLeft / sizeof(uint64_t) || bytesLeft % sizeof(uint64_t))
+	{
+		return false;
+	}
+
+	file.seekg(headerEnd);
+
+	std::vector<uint64_t> positions(static_cast<std::size_t>(count));
+	file.read(reinterpret_cast<char*>(positions.data()), static_cast<std::streamsize>(count * sizeof(uint64_t)));
+	if(!file)
+	{
+		return false;
+	}
+
+	transients.assign(positions.begin(), positions.end());
+
+	return true;
+}
+
+void TransientCache::Store(std::size_t streamID, double valleyToPeakRatio, const std::vector<std::size_t>& transients) const
+{
+	auto entryFilename{GetEntryFilename(streamID, valleyToPeakRatio)};
+
+	// Unique, so renders of the same input storing at once don't write over each other's temporary file
+	std::ostringstream temporaryFilename;
+	temporaryFilename << entryFilename << "." << std::hex << std::random_device{}() << ".tmp";
+
+	std::ofstream file(temporaryFilename.str(), std::ios::binary | std::ios::trunc);
+	if(!file)
+	{
+		Utilities::ThrowException("Unable to write transient cache file", temporaryFilename.str());
+	}
+
+	uint64_t count{transients.size()};
+	std::vector<uint64_t> positions(transients.begin(), transients.end());
+
+	file.write(reinterpret_cast<const char*>(&magic_), sizeof(magic_));
+	file.write(reinterpret_cast<const char*>(&version_), sizeof(version_));
+	file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+	file.write(reinterpret_cast<const char*>(positions.data()), static_cast<std::streamsize>(count * sizeof(uint64_t)));
+	file.close();
+
+	if(!file)
+	{
+		std::remove(temporaryFilename.str().c_str());
+		Utilities::ThrowException("Unable to write transient cache file", temporaryFilename.str());
+	}
+
+	// Windows won't rename over an existing file
+	if(std::rename(temporaryFilename.str().c_str(), entryFilename.c_str()) != 0)
+	{
+		std::remove(entryFilename.c_str());
+		if(std::rename(temporaryFilename.str().c_str(), entryFilename.c_str()) != 0)
+		{
+			std::remove(temporaryFilename.str().c_str());
+			Utilities::ThrowException("Unable to write transient cache file", entryFilename);
+		}
+	}
+}
+
+uint64_t TransientCache::GetInputHash() const
+{
+	return inputHash_;
+}
+
+// A 64 bit FNV-1a style hash of the file's content, taken 8 bytes at a time rather than byte by byte so 
+// long inputs hash at about the speed they're read.  Multiplying only carries low bits upwards, so the 
+// high half is folded back down after each word.
+uint64_t TransientCache::HashFile(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if(!file)
+	{
+		Utilities::ThrowException("Unable to open file for hashing", filename);
+	}
+
+	const uint64_t fnvPrime{0x100000001b3ULL};
+	uint64_t hash{0xcbf29ce484222325ULL};
+
+	std::vector<char> buffer(65536);
+	while(file)
+	{
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		auto bytesRead{static_cast<std::size_t>(file.gcount())};
+
+		std::size_t i{0};
+		for(; i + sizeof(uint64_t) <= bytesRead; i += sizeof(uint64_t))
+		{
+			uint64_t word{0};
+			std::memcpy(&word, buffer.data() + i, sizeof(word));
+			hash ^= word;
+			hash *= fnvPrime;
+			hash ^= hash >> 32;
+		}
+
+		// Only the file's last read can end part way through a word
+		for(; i < bytesRead; ++i)
+		{
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= fnvPrime;
+		}
+	}
+
+	return hash;
+}
+
+std::string TransientCache::GetEntryFilename(std::size_t streamID, double valleyToPeakRatio) const
+{
+	// Use the exact bits of the ratio so we never reuse an entry made with a slightly different ratio
+	uint64_t ratioBits{0};
+	std::memcpy(&ratioBits, &valleyToPeakRatio, sizeof(ratioBits));
+
+	std::ostringstream entryFilename;
+	entryFilename << cacheDirectory_ << "/" << std::hex << std::setfill('0') << std::setw(16) << inputHash_ 
+		<< "-" << std::dec << streamID << "-" << std::hex << std::setw(16) << ratioBits << ".transients";
+
+	return entryFilename.str();
+}
@@ -0,0 +1,65 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Caches detected transient positions on disk so repeated renders of the same input can skip 
+// transient detection.  Entries are keyed by a hash of the input file's content, the stream (channel) 
+// and the valley-to-peak ratio used for detection.
+//
+// Each entry is a small binary file: a fixed header (magic, version, count) followed by the transient 
+// sample positions as 64 bit integers.
+class TransientCache
+{
+	public:
+		TransientCache(const std::string& cacheDirectory, const std::string& inputFilename);
+		TransientCache(const std::string& cacheDirectory, uint64_t inputHash);  // From HashFile
+		virtual ~TransientCache();
+
+		// Returns false if no (valid) cache entry exists for the given parameters.  A truncated or corrupt 
+		// entry counts as not existing.
+		bool Load(std::size_t streamID, double valleyToPeakRatio, std::vector<std::size_t>& transients) const;
+
+		// Written to a temporary file and renamed into place, so an entry is either whole or missing
+		void Store(std::size_t streamID, double valleyToPeakRatio, const std::vector<std::size_t>& transients) const;
+
+		std::string GetEntryFilename(std::size_t streamID, double valleyToPeakRatio) const;
+
+		uint64_t GetInputHash() const;
+
+		static uint64_t HashFile(const std::string& filename);
+
+	private:
+		std::string cacheDirectory_;
+		uint64_t inputHash_;
+
+		const uint32_t magic_{0x43545650};  // "PVTC"
+		const uint32_t version_{1};
+};
@@ -26,10 +26,11 @@
 
 #include <Application/Transients.h>
 #include <Application/TransientConfigFile.h>
+#include <Application/TransientCache.h>
 #include <Signal/TransientDetector.h>
 #include <Utilities/Exception.h>
 #include <Utilities/Stringify.h>
-#include <ThreadSafeAudioFile/Reader.h>
+#include <Application/AudioInput.h>
 #include <yaml-cpp/yaml.h>
 #include <algorithm>
 
@@ -41,9 +42,9 @@ void TransientSettings::SetStreamID(std::size_t streamID)
 	streamID_ = streamID;
 }
 
-void TransientSettings::SetAudioFile(std::shared_ptr<ThreadSafeAudioFile::Reader> audioFile)
+void TransientSettings::SetAudioInput(std::shared_ptr<AudioInput> audioInput)
 {
-	audioFile_ = audioFile;
+	audioInput_ = audioInput;
 }
 
 void TransientSettings::SetTransientValleyToPeakRatio(double valleyToPeakRatio)
@@ -51,6 +52,11 @@ void TransientSettings::SetTransientValleyToPeakRatio(double valleyToPeakRatio)
 	valleyToPeakRatio_ = valleyToPeakRatio;	
 }
 
+void TransientSettings::SetTransientCache(std::shared_ptr<TransientCache> transientCache)
+{
+	transientCache_ = transientCache;
+}
+
 void TransientSettings::SetTransientConfigFilename(const std::string& transientConfgFilename)
 {
 	transientConfigFilename_ = transientConfgFilename;
@@ -67,9 +73,9 @@ bool TransientSettings::TransientConfigFilenameGiven() const
 	return transientConfigFilenameGiven_;
 }
 
-std::shared_ptr<ThreadSafeAudioFile::Reader> TransientSettings::GetAudioFile() const
+std::shared_ptr<AudioInput> TransientSettings::GetAudioInput() const
 {
-	return audioFile_;
+	return audioInput_;
 }
 
 const std::string& TransientSettings::GetTransientConfigFilename() const
@@ -82,6 +88,11 @@ double TransientSettings::GetTransientValleyToPeakRatio() const
 	return valleyToPeakRatio_;
 }
 
+std::shared_ptr<TransientCache> TransientSettings::GetTransientCache() const
+{
+	return transientCache_;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Now the actual Transient Methods
 
@@ -97,9 +108,13 @@ const std::vector<std::size_t>& Transients::GetTransients()
 		{
 			GetTransientPositionsFromConfigFile();
 		}
+		else if(settings_.GetTransientCache())
+		{
+			GetTransientPositionsFromCacheOrAudio();
+		}
 		else
 		{
-			GetTransientPositionsFromAudioFile();
+			GetTransientPositionsFromAudio();
 		}
 
 		transientsProcessed_ = true;
@@ -109,21 +124,21 @@ const std::vector<std::size_t>& Transients::GetTransients()
 }
 
 // Uses the TransientDetector in our Signal lib to find transients
-void Transients::GetTransientPositionsFromAudioFile()
+void Transients::GetTransientPositionsFromAudio()
 {
-	auto audioFile{settings_.GetAudioFile()};
-	Signal::TransientDetector transientDetector{audioFile->GetSampleRate()};
+	auto audioInput{settings_.GetAudioInput()};
+	Signal::TransientDetector transientDetector{audioInput->GetSampleRate()};
 	transientDetector.SetValleyToPeakRatio(settings_.GetTransientValleyToPeakRatio());
 
 	std::size_t currentSamplePosition{0};
 	const std::size_t bufferSize{8192};
 
-	std::size_t samplesLeft{settings_.GetAudioFile()->GetSampleCount()};
+	std::size_t samplesLeft{audioInput->GetSampleCount()};
 	while(samplesLeft)
 	{
 		std::size_t samplesToRead{std::min(bufferSize, samplesLeft)};
 
-		auto audioData{audioFile->ReadAudioStream(settings_.GetStreamID(), currentSamplePosition, samplesToRead)};
+		auto audioData{audioInput->ReadAudioStream(settings_.GetStreamID(), currentSamplePosition, samplesToRead)};
 
 		std::vector<std::size_t> newTransients;
 		if(transientDetector.FindTransients(audioData, newTransients))
@@ -136,6 +151,18 @@ void Transients::GetTransientPositionsFromAudioFile()
 	}
 }
 
+void Transients::GetTransientPositionsFromCacheOrAudio()
+{
+	auto transientCache{settings_.GetTransientCache()};
+	if(transientCache->Load(settings_.GetStreamID(), settings_.GetTransientValleyToPeakRatio(), transients_))
+	{
+		return;
+	}
+
+	GetTransientPositionsFromAudio();
+	transientCache->Store(settings_.GetStreamID(), settings_.GetTransientValleyToPeakRatio(), transients_);
+}
+
 void Transients::GetTransientPositionsFromConfigFile()
 {
 	auto transientConfigFile{TransientConfigFile{settings_.GetTransientConfigFilename()}};	
@@ -31,28 +31,29 @@
 #include <functional>
 #include <vector>
 
-namespace ThreadSafeAudioFile
-{
-	class Reader;
-}
+class AudioInput;
+
+class TransientCache;
 
 class TransientSettings
 {
 	public:
 		// Typical setter methods
 		void SetStreamID(std::size_t streamID);
-		void SetAudioFile(std::shared_ptr<ThreadSafeAudioFile::Reader> audioFile);
+		void SetAudioInput(std::shared_ptr<AudioInput> audioInput);
 		void SetTransientConfigFilename(const std::string& transientConfgFilename);
 		void SetTransientValleyToPeakRatio(double valleyToPeakRatio);
+		void SetTransientCache(std::shared_ptr<TransientCache> transientCache);
 
 		// Methods to check if a value was actually given
 		bool TransientConfigFilenameGiven() const;
 
 		// Typical getter methods
 		std::size_t GetStreamID() const;
-		std::shared_ptr<ThreadSafeAudioFile::Reader> GetAudioFile() const;
+		std::shared_ptr<AudioInput> GetAudioInput() const;
 		const std::string& GetTransientConfigFilename() const;
 		double GetTransientValleyToPeakRatio() const;
+		std::shared_ptr<TransientCache> GetTransientCache() const;  // Null if no cache is used
 
 	private:
 		std::size_t streamID_;
@@ -65,7 +66,9 @@ class TransientSettings
 
 		double valleyToPeakRatio_{1.5};
 
-		std::shared_ptr<ThreadSafeAudioFile::Reader> audioFile_;
+		std::shared_ptr<AudioInput> audioInput_;
+
+		std::shared_ptr<TransientCache> transientCache_;
 };
 
 class Transients
@@ -77,7 +80,8 @@ class Transients
 		const std::vector<std::size_t>& GetTransients();
 
 	private:
-		void GetTransientPositionsFromAudioFile();
+		void GetTransientPositionsFromAudio();
+		void GetTransientPositionsFromCacheOrAudio();
 		void GetTransientPositionsFromConfigFile();
 
 		TransientSettings settings_;
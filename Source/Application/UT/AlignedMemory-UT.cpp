@@ -0,0 +1,86 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <numeric>
+#include <Application/AlignedMemory.h>
+
+namespace AlignedMemoryUT {
+
+bool IsAligned(const void* memory, std::size_t alignment)
+{
+	return reinterpret_cast<std::uintptr_t>(memory) % alignment == 0;
+}
+
+TEST(AlignedMemory, SmallAllocationsAreCacheLineAligned)
+{
+	for(std::size_t bytes : {1, 8, 63, 65, 4096, 100000})
+	{
+		auto memory{AlignedMemory::Allocate(bytes)};
+		EXPECT_TRUE(IsAligned(memory, AlignedMemory::alignment)) << bytes;
+		static_cast<uint8_t*>(memory)[bytes - 1] = 1;
+		AlignedMemory::Free(memory, bytes);
+	}
+}
+
+TEST(AlignedMemory, LargeAllocationsAreUsable)
+{
+	auto bytes{AlignedMemory::hugePageSize * 3 + 100};
+	auto memory{static_cast<uint8_t*>(AlignedMemory::Allocate(bytes))};
+	EXPECT_TRUE(IsAligned(memory, AlignedMemory::alignment));
+
+	memory[0] = 1;
+	memory[bytes - 1] = 2;
+	EXPECT_EQ(1, memory[0]);
+	EXPECT_EQ(2, memory[bytes - 1]);
+
+	AlignedMemory::Free(memory, bytes);
+}
+
+// Growing through the huge page threshold moves the samples between both kinds of allocation
+TEST(AlignedMemory, VectorGrowsPastHugePage)
+{
+	AlignedMemory::SetHugePages(AlignedMemory::HugePagesSupported());
+
+	AlignedMemory::Vector<double> samples;
+	auto sampleCount{AlignedMemory::hugePageSize / sizeof(double) * 2};
+	for(std::size_t i{0}; i < sampleCount; ++i)
+	{
+		samples.push_back(static_cast<double>(i));
+		ASSERT_TRUE(IsAligned(samples.data(), AlignedMemory::alignment));
+	}
+
+	EXPECT_DOUBLE_EQ(static_cast<double>(sampleCount - 1) * sampleCount / 2.0, std::accumulate(samples.begin(), samples.end(), 0.0));
+
+	samples.erase(samples.begin(), samples.begin() + sampleCount / 2);
+	samples.shrink_to_fit();
+	EXPECT_DOUBLE_EQ(static_cast<double>(sampleCount / 2), samples[0]);
+
+	AlignedMemory::SetHugePages(false);
+}
+
+}
@@ -0,0 +1,223 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <Application/CachingAudioInput.h>
+#include <Utilities/Exception.h>
+
+namespace CachingAudioInputUT {
+
+// Counts the reads made of it
+class CountingAudioInput : public AudioBufferInput
+{
+	public:
+		CountingAudioInput(const std::vector<std::vector<double>>& channels) : AudioBufferInput{channels, 44100, 16} { }
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override
+		{
+			++reads_;
+			return AudioBufferInput::ReadAudioStream(streamID, startSample, sampleCount);
+		}
+
+		std::atomic<std::size_t> reads_{0};
+};
+
+// Counts the passes made over its audio, reading every channel in one pass like WaveFileInput
+class OnePassAudioInput : public AudioBufferInput
+{
+	public:
+		OnePassAudioInput(const std::vector<std::vector<double>>& channels) : AudioBufferInput{channels, 44100, 24} { }
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override
+		{
+			++passes_;
+			return AudioBufferInput::ReadAudioStream(streamID, startSample, sampleCount);
+		}
+
+		std::vector<AudioData> ReadAudio(std::size_t startSample, std::size_t sampleCount) override
+		{
+			++passes_;
+			std::vector<AudioData> audioData;
+			for(std::size_t streamID{0}; streamID < GetChannels(); ++streamID)
+			{
+				audioData.push_back(AudioBufferInput::ReadAudioStream(streamID, startSample, sampleCount));
+			}
+
+			return audioData;
+		}
+
+		bool ReadsAudioInOnePass() override { return true; }
+
+		std::atomic<std::size_t> passes_{0};
+};
+
+std::shared_ptr<CountingAudioInput> CreateAudioInput(std::size_t sampleCount)
+{
+	std::vector<double> left;
+	std::vector<double> right;
+	for(std::size_t i{0}; i < sampleCount; ++i)
+	{
+		left.push_back(static_cast<double>(i));
+		right.push_back(-static_cast<double>(i));
+	}
+
+	return std::make_shared<CountingAudioInput>(std::vector<std::vector<double>>{left, right});
+}
+
+void VerifySequentialRead(AudioInput& audioInput, std::size_t streamID, std::size_t chunkSize)
+{
+	auto sign{streamID == 0 ? 1.0 : -1.0};
+
+	std::size_t position{0};
+	while(position < audioInput.GetSampleCount())
+	{
+		auto audioData{audioInput.ReadAudioStream(streamID, position, chunkSize)};
+		ASSERT_EQ(std::min(chunkSize, audioInput.GetSampleCount() - position), audioData.GetSize());
+
+		for(std::size_t i{0}; i < audioData.GetSize(); ++i)
+		{
+			ASSERT_EQ(sign * static_cast<double>(position + i), audioData.GetData()[i]);
+		}
+
+		position += audioData.GetSize();
+	}
+}
+
+}
+
+TEST(CachingAudioInput, EachBlockReadOnce)
+{
+	auto countingAudioInput{CachingAudioInputUT::CreateAudioInput(10000)};
+	CachingAudioInput audioInput(countingAudioInput, 16, 1000);
+
+	// Two passes over both channels
+	for(auto pass{0}; pass < 2; ++pass)
+	{
+		CachingAudioInputUT::VerifySequentialRead(audioInput, 0, 300);
+		CachingAudioInputUT::VerifySequentialRead(audioInput, 1, 700);
+	}
+
+	EXPECT_EQ(10, audioInput.GetBlocksRead());
+	EXPECT_EQ(20, countingAudioInput->reads_);  // One read per channel per block
+}
+
+// Reading both channels block by block takes one pass per channel uncached, and one pass per block cached
+TEST(CachingAudioInput, FewerPassesForOnePassInput)
+{
+	auto CreateAudioInput = []
+	{
+		std::vector<double> left(10000, 0.5);
+		std::vector<double> right(10000, -0.5);
+		return std::make_shared<CachingAudioInputUT::OnePassAudioInput>(std::vector<std::vector<double>>{left, right});
+	};
+
+	auto ReadBlocks = [](AudioInput& audioInput)
+	{
+		for(std::size_t position{0}; position < audioInput.GetSampleCount(); position += 1000)
+		{
+			audioInput.ReadAudioStream(0, position, 1000);
+			audioInput.ReadAudioStream(1, position, 1000);
+		}
+	};
+
+	auto uncachedAudioInput{CreateAudioInput()};
+	EXPECT_TRUE(uncachedAudioInput->ReadsAudioInOnePass());
+	ReadBlocks(*uncachedAudioInput);
+	EXPECT_EQ(20, uncachedAudioInput->passes_);
+
+	auto onePassAudioInput{CreateAudioInput()};
+	CachingAudioInput audioInput(onePassAudioInput, 16, 1000);
+	ReadBlocks(audioInput);
+	EXPECT_EQ(10, onePassAudioInput->passes_);
+
+	// AudioBufferInput (like AudioFileInput) reads each channel separately, so it isn't worth caching
+	EXPECT_FALSE(CachingAudioInputUT::CreateAudioInput(100)->ReadsAudioInOnePass());
+}
+
+TEST(CachingAudioInput, LeastRecentlyUsedDropped)
+{
+	auto countingAudioInput{CachingAudioInputUT::CreateAudioInput(10000)};
+	CachingAudioInput audioInput(countingAudioInput, 2, 1000);
+
+	audioInput.ReadAudioStream(0, 0, 1000);     // Block 0
+	audioInput.ReadAudioStream(0, 1000, 1000);  // Block 1
+	audioInput.ReadAudioStream(1, 0, 1000);     // Block 0 again, now most recently used
+	audioInput.ReadAudioStream(0, 2000, 1000);  // Block 2 replaces block 1
+	EXPECT_EQ(3, audioInput.GetBlocksRead());
+
+	audioInput.ReadAudioStream(1, 0, 1000);
+	EXPECT_EQ(3, audioInput.GetBlocksRead());
+
+	audioInput.ReadAudioStream(1, 1000, 1000);
+	EXPECT_EQ(4, audioInput.GetBlocksRead());
+}
+
+// Two blocks of 1000 samples are held at most, per channel
+TEST(CachingAudioInput, MemoryAccounting)
+{
+	auto memoryAccounting{std::make_shared<MemoryAccounting>()};
+	CachingAudioInput audioInput(CachingAudioInputUT::CreateAudioInput(10000), 2, 1000);
+	audioInput.SetMemoryAccounting(memoryAccounting);
+
+	for(std::size_t position{0}; position < 10000; position += 1000)
+	{
+		audioInput.ReadAudioStream(0, position, 1000);
+	}
+
+	for(std::size_t streamID{0}; streamID < 2; ++streamID)
+	{
+		EXPECT_EQ(2000 * sizeof(double), memoryAccounting->GetUsage(MemoryAccounting::Stage::READER, streamID).current_);
+		EXPECT_EQ(2000 * sizeof(double), memoryAccounting->GetUsage(MemoryAccounting::Stage::READER, streamID).peak_);
+	}
+
+	EXPECT_EQ(4000 * sizeof(double), memoryAccounting->GetStageUsage(MemoryAccounting::Stage::READER).peak_);
+}
+
+TEST(CachingAudioInput, ReadsPastEnd)
+{
+	CachingAudioInput audioInput(CachingAudioInputUT::CreateAudioInput(1000), 4, 256);
+	EXPECT_EQ(100, audioInput.ReadAudioStream(0, 900, 500).GetSize());
+	EXPECT_EQ(0, audioInput.ReadAudioStream(0, 1000, 500).GetSize());
+	EXPECT_THROW(audioInput.ReadAudioStream(2, 0, 100), Utilities::Exception);
+}
+
+TEST(CachingAudioInput, ConcurrentStreams)
+{
+	auto countingAudioInput{CachingAudioInputUT::CreateAudioInput(100000)};
+	CachingAudioInput audioInput(countingAudioInput, 200, 512);
+
+	std::thread leftThread([&]{ CachingAudioInputUT::VerifySequentialRead(audioInput, 0, 700); });
+	std::thread rightThread([&]{ CachingAudioInputUT::VerifySequentialRead(audioInput, 1, 900); });
+
+	leftThread.join();
+	rightThread.join();
+
+	EXPECT_EQ((100000 + 511) / 512, audioInput.GetBlocksRead());
+}
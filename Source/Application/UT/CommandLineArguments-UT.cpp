@@ -259,6 +259,12 @@ TEST(CommandLineArguments, TestTooLargeStretchFactor)
 	VerifyTooLargeStretchFactor(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 11.0"));
 }
 
+TEST(CommandLineArguments, TestNonFiniteStretchFactor)
+{
+	VerifyTooLargeStretchFactor(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s nan"));
+	VerifyTooLargeStretchFactor(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s inf"));
+}
+
 void VerifyValleyToPeakRatio(const CommandLineArguments& commandLineArguments)
 {
 	EXPECT_TRUE(commandLineArguments.IsValid());
@@ -271,6 +277,13 @@ TEST(CommandLineArguments, TestValleyToPeakRatio)
 	VerifyValleyToPeakRatio(CreateCommandLineArguments("-i InputFileName.wav -a 1.75 -t"));
 }
 
+TEST(CommandLineArguments, TestInvalidValleyToPeakRatio)
+{
+	auto commandLineArguments{CreateCommandLineArguments("-i InputFileName.wav -a -1.5 -t")};
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given valley to peak ratio must be greater than zero", commandLineArguments.GetErrorMessage().c_str());
+}
+
 void VerifyNoValueGivenForRequiredArgument(const CommandLineArguments& commandLineArguments)
 {
 	EXPECT_FALSE(commandLineArguments.IsValid());
@@ -283,3 +296,311 @@ TEST(CommandLineArguments, TestNoValueGivenForRequiredArgument)
 	VerifyNoValueGivenForRequiredArgument(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s"));
 }
 
+void VerifyMultipleStretchFactors(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Out_%s.wav", commandLineArguments.GetOutputFilename().c_str());
+
+	auto stretchFactors{commandLineArguments.GetStretchFactors()};
+	EXPECT_EQ(4, stretchFactors.size());
+	if(stretchFactors.size() == 4)
+	{
+		EXPECT_EQ(0.9, stretchFactors[0]);
+		EXPECT_EQ(0.95, stretchFactors[1]);
+		EXPECT_EQ(1.05, stretchFactors[2]);
+		EXPECT_EQ(1.1, stretchFactors[3]);
+	}
+}
+
+TEST(CommandLineArguments, TestMultipleStretchFactors)
+{
+	VerifyMultipleStretchFactors(CreateCommandLineArguments("--input InputFileName.wav --output Out_%s.wav --stretch 0.9,0.95,1.05,1.1"));
+	VerifyMultipleStretchFactors(CreateCommandLineArguments("-i InputFileName.wav -o Out_%s.wav -s 0.9,0.95,1.05,1.1"));
+}
+
+void VerifyMultipleStretchFactorsWithoutPlaceholder(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Multiple stretch factors given, but output filename has no %s placeholder.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestMultipleStretchFactorsWithoutPlaceholder)
+{
+	VerifyMultipleStretchFactorsWithoutPlaceholder(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 0.9,1.1"));
+	VerifyMultipleStretchFactorsWithoutPlaceholder(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 0.9,1.1"));
+}
+
+void VerifyDuplicateStretchFactors(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("The same stretch factor was given more than once.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestDuplicateStretchFactors)
+{
+	VerifyDuplicateStretchFactors(CreateCommandLineArguments("--input InputFileName.wav --output Out_%s.wav --stretch 0.9,1.1,1.1"));
+	VerifyDuplicateStretchFactors(CreateCommandLineArguments("-i InputFileName.wav -o Out_%s.wav -s 1.1,0.9,1.10"));
+}
+
+TEST(CommandLineArguments, TestMultipleStretchFactorsOneOutOfRange)
+{
+	VerifyTooLargeStretchFactor(CreateCommandLineArguments("--input InputFileName.wav --output Out_%s.wav --stretch 0.9,11.0"));
+	VerifyTooLargeStretchFactor(CreateCommandLineArguments("-i InputFileName.wav -o Out_%s.wav -s 0.9,11.0"));
+}
+
+void VerifyQualityPreset(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.QualityPresetGiven());
+	EXPECT_STREQ("draft", commandLineArguments.GetQualityPreset().c_str());
+}
+
+TEST(CommandLineArguments, TestQualityPreset)
+{
+	VerifyQualityPreset(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --quality draft"));
+	VerifyQualityPreset(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -q draft"));
+}
+
+void VerifyInvalidQualityPreset(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given quality setting is invalid.  Must be high, medium or draft.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestInvalidQualityPreset)
+{
+	VerifyInvalidQualityPreset(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --quality best"));
+	VerifyInvalidQualityPreset(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -q best"));
+}
+
+void VerifyReadAhead(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.ReadAheadGiven());
+	EXPECT_EQ(16, commandLineArguments.GetReadAheadBlocks());
+}
+
+TEST(CommandLineArguments, TestReadAhead)
+{
+	VerifyReadAhead(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --prefetch 16"));
+	VerifyReadAhead(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -f 16"));
+}
+
+void VerifyReadAheadOutOfRange(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given prefetch block count out of range.  Min: 1  Max: 1024", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestReadAheadOutOfRange)
+{
+	VerifyReadAheadOutOfRange(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --prefetch 0"));
+	VerifyReadAheadOutOfRange(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -f 2000"));
+}
+
+void VerifyMaxMemory(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.MaxMemoryGiven());
+	EXPECT_EQ(512, commandLineArguments.GetMaxMemory());
+}
+
+TEST(CommandLineArguments, TestMaxMemory)
+{
+	VerifyMaxMemory(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --maxmemory 512"));
+	VerifyMaxMemory(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -m 512"));
+}
+
+void VerifyMaxMemoryOutOfRange(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given max memory (in MB) out of range.  Min: 32  Max: 1048576", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestMaxMemoryOutOfRange)
+{
+	VerifyMaxMemoryOutOfRange(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --maxmemory 8"));
+	VerifyMaxMemoryOutOfRange(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -m 0"));
+}
+
+void VerifyMemoryReport(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.MemoryReportFilenameGiven());
+	EXPECT_STREQ("memory.json", commandLineArguments.GetMemoryReportFilename().c_str());
+}
+
+TEST(CommandLineArguments, TestMemoryReport)
+{
+	VerifyMemoryReport(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --memoryreport memory.json"));
+	VerifyMemoryReport(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -u memory.json"));
+}
+
+void VerifyProgress(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.ShowProgress());
+	EXPECT_FALSE(commandLineArguments.StatusIntervalGiven());
+}
+
+TEST(CommandLineArguments, TestProgress)
+{
+	VerifyProgress(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --progress"));
+	VerifyProgress(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -k"));
+}
+
+void VerifyStatus(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_FALSE(commandLineArguments.ShowProgress());
+	EXPECT_TRUE(commandLineArguments.StatusIntervalGiven());
+	EXPECT_DOUBLE_EQ(2.5, commandLineArguments.GetStatusInterval());
+}
+
+TEST(CommandLineArguments, TestStatus)
+{
+	VerifyStatus(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --status 2.5"));
+	VerifyStatus(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -z 2.5"));
+}
+
+void VerifyStatusOutOfRange(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given status interval (in seconds) out of range.  Min: 0.100000  Max: 3600.000000", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestStatusOutOfRange)
+{
+	VerifyStatusOutOfRange(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --status 0.01"));
+	VerifyStatusOutOfRange(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -z 7200"));
+}
+
+void VerifyProgressAndStatus(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Progress and status can't both be given.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestProgressAndStatus)
+{
+	VerifyProgressAndStatus(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --progress --status 5"));
+	VerifyProgressAndStatus(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -k -z 5"));
+}
+
+void VerifyCpuTier(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.CpuTierGiven());
+	EXPECT_STREQ("avx2", commandLineArguments.GetCpuTier().c_str());
+}
+
+TEST(CommandLineArguments, TestCpuTier)
+{
+	VerifyCpuTier(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --cputier avx2"));
+	VerifyCpuTier(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -j avx2"));
+}
+
+void VerifyInvalidCpuTier(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given CPU tier not recognized.  Use baseline, avx2 or avx512.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestInvalidCpuTier)
+{
+	VerifyInvalidCpuTier(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --cputier sse4"));
+	VerifyInvalidCpuTier(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -j AVX2"));
+}
+
+void VerifyTrace(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.TraceFilenameGiven());
+	EXPECT_STREQ("trace.json", commandLineArguments.GetTraceFilename().c_str());
+}
+
+TEST(CommandLineArguments, TestTrace)
+{
+	VerifyTrace(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --trace trace.json"));
+	VerifyTrace(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -g trace.json"));
+}
+
+void VerifyRenderRange(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.RangeStartGiven());
+	EXPECT_EQ(441000.0, commandLineArguments.GetRangeStart());
+	EXPECT_FALSE(commandLineArguments.RangeStartInSeconds());
+	EXPECT_TRUE(commandLineArguments.RangeEndGiven());
+	EXPECT_EQ(30.5, commandLineArguments.GetRangeEnd());
+	EXPECT_TRUE(commandLineArguments.RangeEndInSeconds());
+}
+
+TEST(CommandLineArguments, TestRenderRange)
+{
+	VerifyRenderRange(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --start 441000 --end 30.5s"));
+	VerifyRenderRange(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -b 441000 -e 30.5s"));
+}
+
+void VerifyInvalidRangeStart(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given start position is invalid.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestInvalidRangeStart)
+{
+	VerifyInvalidRangeStart(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --start -5"));
+	VerifyInvalidRangeStart(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -b 12.5"));
+}
+
+void VerifyRangeEndBeforeStart(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given end position must come after the start position.", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestRangeEndBeforeStart)
+{
+	VerifyRangeEndBeforeStart(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --start 20s --end 10s"));
+	VerifyRangeEndBeforeStart(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -b 1000 -e 1000"));
+}
+
+void VerifyMinSectionLength(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.MinSectionLengthGiven());
+	EXPECT_EQ(20, commandLineArguments.GetMinSectionLength());
+	EXPECT_TRUE(commandLineArguments.GetPhaseVocoderSettings().MinSectionLengthGiven());
+	EXPECT_EQ(20, commandLineArguments.GetPhaseVocoderSettings().GetMinSectionLength());
+}
+
+TEST(CommandLineArguments, TestMinSectionLength)
+{
+	VerifyMinSectionLength(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --minsection 20"));
+	VerifyMinSectionLength(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -y 20"));
+}
+
+void VerifyMinSectionLengthOutOfRange(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_FALSE(commandLineArguments.IsValid());
+	EXPECT_STREQ("Given minimum section length (in ms) out of range.  Min: 1  Max: 1000", commandLineArguments.GetErrorMessage().c_str());
+}
+
+TEST(CommandLineArguments, TestMinSectionLengthOutOfRange)
+{
+	VerifyMinSectionLengthOutOfRange(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --minsection 0"));
+	VerifyMinSectionLengthOutOfRange(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -y 5000"));
+}
+
+void VerifyHugePages(const CommandLineArguments& commandLineArguments)
+{
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_TRUE(commandLineArguments.HugePages());
+}
+
+TEST(CommandLineArguments, TestHugePages)
+{
+	VerifyHugePages(CreateCommandLineArguments("--input InputFileName.wav --output OutputFileName.wav --stretch 1.25 --hugepages"));
+	VerifyHugePages(CreateCommandLineArguments("-i InputFileName.wav -o OutputFileName.wav -s 1.25 -H"));
+}
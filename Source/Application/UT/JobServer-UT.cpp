@@ -0,0 +1,281 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <Application/JobServer.h>
+#include <Application/JobClient.h>
+#include <Application/JobProtocol.h>
+#include <Application/AudioInput.h>
+#include <Utilities/Exception.h>
+#include <Utilities/File.h>
+#include <Application/UT/ReferenceAudio.h>
+
+#ifndef _WIN32
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace JobServerUT {
+
+const std::string socketPath{"PhaseVocoderJobServer-UT.sock"};
+
+// Connects without sending anything
+int ConnectQuietly()
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+	int connection{socket(AF_UNIX, SOCK_STREAM, 0)};
+	EXPECT_EQ(0, connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)));
+
+	return connection;
+}
+
+// Waits until the server has exactly this many connections queued, after having queued at least maxQueueDepth
+void WaitForQueueDepth(JobServer& jobServer, std::size_t queueDepth, std::size_t maxQueueDepth)
+{
+	while(jobServer.GetStatistics().queueDepth_ != queueDepth || jobServer.GetStatistics().maxQueueDepth_ < maxQueueDepth)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+std::vector<double> ReadSamples(const std::string& filename)
+{
+	WaveFileInput waveFileInput{filename};
+	return waveFileInput.ReadAudioStream(0, 0, waveFileInput.GetSampleCount()).GetData();
+}
+
+}
+
+TEST(JobProtocol, EncodeAndDecodePcm)
+{
+	std::vector<std::vector<double>> channels{{0.0, 1.0, -32768.0, 32767.0}, {-1.0, 2.0, 100.0, -100.0}};
+	auto pcm{JobProtocol::EncodePcm(channels)};
+	EXPECT_EQ(16, pcm.size());
+	EXPECT_EQ(channels, JobProtocol::DecodePcm(pcm, 2));
+	EXPECT_THROW(JobProtocol::DecodePcm(pcm, 3), Utilities::Exception);
+}
+
+TEST(JobProtocol, FormatAndParseFields)
+{
+	JobProtocol::Fields fields{{"command", "process"}, {"input", "in.wav"}, {"stretch", "1.25"}, {"incremental", ""}};
+	auto parsedFields{JobProtocol::ParseFields(JobProtocol::FormatFields(fields))};
+	EXPECT_EQ(fields, parsedFields);
+}
+
+TEST(JobProtocol, GetCommandLineArguments)
+{
+	auto commandLineArguments{JobProtocol::GetCommandLineArguments(JobProtocol::Fields{{"command", "process"}, {"input", "in.wav"}, {"output", "out.wav"}, {"stretch", "1.25"}})};
+	EXPECT_TRUE(commandLineArguments.IsValid());
+	EXPECT_EQ("in.wav", commandLineArguments.GetInputFilename());
+	EXPECT_EQ(1.25, commandLineArguments.GetStretchFactor());
+
+	auto invalidArguments{JobProtocol::GetCommandLineArguments(JobProtocol::Fields{{"command", "process"}, {"input", "in.wav"}, {"output", "out.wav"}})};
+	EXPECT_FALSE(invalidArguments.IsValid());
+}
+
+TEST(JobClient, NoServer)
+{
+	JobClient jobClient("NonExistentJobServer-UT.sock");
+	EXPECT_THROW(jobClient.SendRequest(JobProtocol::Fields{{"command", "stats"}}), Utilities::Exception);
+}
+
+#ifndef _DEBUG
+TEST(JobServer, ProcessJobs)
+{
+	JobServer jobServer(JobServerUT::socketPath, 2);
+	std::thread serverThread([&jobServer]{ jobServer.Run(); });
+
+	JobClient jobClient(JobServerUT::socketPath);
+
+	auto response{jobClient.SendRequest(JobProtocol::Fields{{"command", "process"}, {"input", "BuiltToSpillBeatAbbrev.wav"}, 
+		{"output", "BuiltToSpillBeatAbbrevJobServerResample48000.wav"}, {"resample", "48000"}})};
+	EXPECT_EQ("ok", response["status"]);
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrevResample48000.wav", "BuiltToSpillBeatAbbrevJobServerResample48000.wav"));
+
+	response = jobClient.SendRequest(JobProtocol::Fields{{"command", "process"}, {"input", "BuiltToSpillBeatAbbrev.wav"}, {"resample", "48000"}});
+	EXPECT_EQ("error", response["status"]);
+	EXPECT_FALSE(response["message"].empty());
+
+	response = jobClient.SendRequest(JobProtocol::Fields{{"command", "stats"}});
+	EXPECT_EQ("ok", response["status"]);
+	EXPECT_EQ("1", response["jobs_completed"]);
+	EXPECT_EQ("1", response["jobs_failed"]);
+	EXPECT_EQ("0", response["queue_depth"]);
+
+	response = jobClient.SendRequest(JobProtocol::Fields{{"command", "shutdown"}});
+	EXPECT_EQ("ok", response["status"]);
+
+	serverThread.join();
+}
+
+// The same resample as above, with the audio sent and returned inline.  AudioLib's writer may round 
+// halfway samples the other way, so the samples are allowed one step either way.
+TEST(JobServer, ProcessInlinePcmJob)
+{
+	JobServer jobServer(JobServerUT::socketPath, 1);
+	std::thread serverThread([&jobServer]{ jobServer.Run(); });
+
+	JobClient jobClient(JobServerUT::socketPath);
+
+	auto inputPcm{JobProtocol::EncodePcm(std::vector<std::vector<double>>{JobServerUT::ReadSamples("BuiltToSpillBeatAbbrev.wav")})};
+	std::string outputPcm;
+	auto response{jobClient.SendRequest(JobProtocol::Fields{{"command", "process"}, {"input", "-"}, {"output", "-"}, {"resample", "48000"}, 
+		{"pcm_channels", "1"}, {"pcm_sample_rate", "44100"}}, inputPcm, outputPcm)};
+
+	std::string unusedPcm;
+	auto missingFormatResponse{jobClient.SendRequest(JobProtocol::Fields{{"command", "process"}, {"input", "-"}, {"output", "-"}, 
+		{"resample", "48000"}}, inputPcm, unusedPcm)};
+
+	jobClient.SendRequest(JobProtocol::Fields{{"command", "shutdown"}});
+	serverThread.join();
+
+	EXPECT_EQ("error", missingFormatResponse["status"]);
+
+	EXPECT_EQ("ok", response["status"]);
+	EXPECT_EQ("1", response["pcm_channels"]);
+	EXPECT_EQ("48000", response["pcm_sample_rate"]);
+
+	auto reference{JobServerUT::ReadSamples("BuiltToSpillBeatAbbrevResample48000.wav")};
+	auto result{JobProtocol::DecodePcm(outputPcm, 1)};
+	ASSERT_EQ(1, result.size());
+	ASSERT_EQ(reference.size(), result[0].size());
+
+#ifndef FAST_MATH
+	const double tolerance{1.0};
+#else
+	const double tolerance{ReferenceAudio::fastMathTolerance + 1.0};
+#endif
+	double largestDifference{0.0};
+	for(std::size_t i{0}; i < reference.size(); ++i)
+	{
+		largestDifference = std::max(largestDifference, std::abs(reference[i] - result[0][i]));
+	}
+	EXPECT_LE(largestDifference, tolerance);
+}
+#endif
+
+// A client that connects and never sends its request is dropped once it times out, and the server 
+// goes on to the next one
+TEST(JobServer, QuietConnectionTimesOut)
+{
+	JobServer jobServer(JobServerUT::socketPath, 1);
+	jobServer.SetConnectionTimeout(0.2);
+	std::thread serverThread([&jobServer]{ jobServer.Run(); });
+
+	int quietConnection{JobServerUT::ConnectQuietly()};
+
+	JobClient jobClient(JobServerUT::socketPath);
+	auto response{jobClient.SendRequest(JobProtocol::Fields{{"command", "stats"}})};
+
+	char buffer;
+	auto bytesRead{read(quietConnection, &buffer, 1)};
+	close(quietConnection);
+
+	jobClient.SendRequest(JobProtocol::Fields{{"command", "shutdown"}});
+	serverThread.join();
+
+	EXPECT_EQ("ok", response["status"]);
+	EXPECT_EQ(0, bytesRead);
+}
+
+// Requests are read by the workers, so a quiet client only holds up the one reading it
+TEST(JobServer, QuietConnectionHoldsUpOneWorker)
+{
+	JobServer jobServer(JobServerUT::socketPath, 2);
+	std::thread serverThread([&jobServer]{ jobServer.Run(); });
+
+	int quietConnection{JobServerUT::ConnectQuietly()};
+	JobServerUT::WaitForQueueDepth(jobServer, 0, 1);
+
+	auto startTime{std::chrono::steady_clock::now()};
+	JobClient jobClient(JobServerUT::socketPath);
+	auto response{jobClient.SendRequest(JobProtocol::Fields{{"command", "stats"}})};
+	auto responseTime{std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count()};
+
+	close(quietConnection);
+
+	jobClient.SendRequest(JobProtocol::Fields{{"command", "shutdown"}});
+	serverThread.join();
+
+	EXPECT_EQ("ok", response["status"]);
+	EXPECT_LT(responseTime, 1.0);  // Well short of the five second connection timeout
+}
+
+// One connection being read by the only worker and one queued fill the queue, so the next is turned away
+TEST(JobServer, FullQueueIsBusy)
+{
+	JobServer jobServer(JobServerUT::socketPath, 1);
+	jobServer.SetMaxQueuedJobs(1);
+	std::thread serverThread([&jobServer]{ jobServer.Run(); });
+
+	int readConnection{JobServerUT::ConnectQuietly()};
+	JobServerUT::WaitForQueueDepth(jobServer, 0, 1);
+
+	int queuedConnection{JobServerUT::ConnectQuietly()};
+	JobServerUT::WaitForQueueDepth(jobServer, 1, 1);
+
+	JobClient jobClient(JobServerUT::socketPath);
+	auto busyResponse{jobClient.SendRequest(JobProtocol::Fields{{"command", "stats"}})};
+
+	close(readConnection);
+	close(queuedConnection);
+	JobServerUT::WaitForQueueDepth(jobServer, 0, 1);
+
+	auto response{jobClient.SendRequest(JobProtocol::Fields{{"command", "stats"}})};
+
+	jobClient.SendRequest(JobProtocol::Fields{{"command", "shutdown"}});
+	serverThread.join();
+
+	EXPECT_EQ("busy", busyResponse["status"]);
+	EXPECT_EQ("ok", response["status"]);
+	EXPECT_EQ("1", response["jobs_rejected"]);
+}
+
+// Only a socket left behind is removed, never some other file at the path
+TEST(JobServer, ExistingFileKept)
+{
+	std::ofstream("PhaseVocoderJobServerFile-UT.sock") << "Not a socket";
+
+	EXPECT_THROW(JobServer("PhaseVocoderJobServerFile-UT.sock", 1), Utilities::Exception);
+	EXPECT_TRUE(std::ifstream("PhaseVocoderJobServerFile-UT.sock").good());
+
+	std::remove("PhaseVocoderJobServerFile-UT.sock");
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <Application/MemoryAccounting.h>
+
+namespace MemoryAccountingUT {
+
+TEST(MemoryAccounting, CurrentAndPeak)
+{
+	MemoryAccounting memoryAccounting;
+	memoryAccounting.Add(MemoryAccounting::Stage::READER, 0, 1000);
+	memoryAccounting.Add(MemoryAccounting::Stage::READER, 0, 500);
+	memoryAccounting.Remove(MemoryAccounting::Stage::READER, 0, 1200);
+	memoryAccounting.Add(MemoryAccounting::Stage::READER, 0, 100);
+
+	auto usage{memoryAccounting.GetUsage(MemoryAccounting::Stage::READER, 0)};
+	EXPECT_EQ(400, usage.current_);
+	EXPECT_EQ(1500, usage.peak_);
+}
+
+TEST(MemoryAccounting, NeverBelowZero)
+{
+	MemoryAccounting memoryAccounting;
+	memoryAccounting.Add(MemoryAccounting::Stage::WRITER, 0, 100);
+	memoryAccounting.Remove(MemoryAccounting::Stage::WRITER, 0, 200);
+
+	EXPECT_EQ(0, memoryAccounting.GetUsage(MemoryAccounting::Stage::WRITER, 0).current_);
+	EXPECT_EQ(0, memoryAccounting.GetTotalUsage().current_);
+}
+
+// Stage and total peaks are of the sums, not sums of the peaks
+TEST(MemoryAccounting, StageAndTotalUsage)
+{
+	MemoryAccounting memoryAccounting;
+	memoryAccounting.Add(MemoryAccounting::Stage::PHASE_VOCODER, 0, 1000);
+	memoryAccounting.Remove(MemoryAccounting::Stage::PHASE_VOCODER, 0, 1000);
+	memoryAccounting.Add(MemoryAccounting::Stage::PHASE_VOCODER, 1, 800);
+	memoryAccounting.Add(MemoryAccounting::Stage::TRANSIENTS, 1, 50);
+
+	EXPECT_EQ(1000, memoryAccounting.GetStageUsage(MemoryAccounting::Stage::PHASE_VOCODER).peak_);
+	EXPECT_EQ(800, memoryAccounting.GetStageUsage(MemoryAccounting::Stage::PHASE_VOCODER).current_);
+	EXPECT_EQ(1000, memoryAccounting.GetTotalUsage().peak_);
+	EXPECT_EQ(850, memoryAccounting.GetTotalUsage().current_);
+
+	EXPECT_EQ((std::vector<std::size_t>{0, 1}), memoryAccounting.GetStreamIDs(MemoryAccounting::Stage::PHASE_VOCODER));
+	EXPECT_TRUE(memoryAccounting.GetStreamIDs(MemoryAccounting::Stage::RESAMPLER).empty());
+}
+
+TEST(MemoryAccounting, ScopedAllocation)
+{
+	MemoryAccounting memoryAccounting;
+
+	{
+		MemoryAccounting::ScopedAllocation allocation{&memoryAccounting, MemoryAccounting::Stage::AUDIO_DATA, 0, 4096};
+		EXPECT_EQ(4096, memoryAccounting.GetUsage(MemoryAccounting::Stage::AUDIO_DATA, 0).current_);
+	}
+
+	EXPECT_EQ(0, memoryAccounting.GetUsage(MemoryAccounting::Stage::AUDIO_DATA, 0).current_);
+	EXPECT_EQ(4096, memoryAccounting.GetUsage(MemoryAccounting::Stage::AUDIO_DATA, 0).peak_);
+
+	// Without a MemoryAccounting nothing is recorded
+	MemoryAccounting::ScopedAllocation allocation{nullptr, MemoryAccounting::Stage::AUDIO_DATA, 0, 4096};
+}
+
+TEST(MemoryAccounting, Report)
+{
+	MemoryAccounting memoryAccounting;
+	memoryAccounting.Add(MemoryAccounting::Stage::READER, MemoryAccounting::allStreams, 2048);
+	memoryAccounting.Add(MemoryAccounting::Stage::WRITER, 1, 512);
+	memoryAccounting.Remove(MemoryAccounting::Stage::WRITER, 1, 512);
+
+	std::ostringstream report;
+	memoryAccounting.WriteReport(report);
+
+	EXPECT_NE(std::string::npos, report.str().find("\"currentBytes\": 2048,"));
+	EXPECT_NE(std::string::npos, report.str().find("\"peakBytes\": 2560,"));
+	EXPECT_NE(std::string::npos, report.str().find("{\"stream\": \"all\", \"currentBytes\": 2048, \"peakBytes\": 2048}"));
+	EXPECT_NE(std::string::npos, report.str().find("{\"stage\": \"writer\", \"currentBytes\": 0, \"peakBytes\": 512, \"streams\": [{\"stream\": 1, \"currentBytes\": 0, \"peakBytes\": 512}]}"));
+	EXPECT_NE(std::string::npos, report.str().find("{\"stage\": \"resampler\", \"currentBytes\": 0, \"peakBytes\": 0, \"streams\": []},"));
+}
+
+}
@@ -0,0 +1,189 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <random>
+#include <limits>
+#include <cstdlib>
+#include <functional>
+#include <Application/PcmConversion.h>
+#include <Application/CpuTier.h>
+
+namespace PcmConversionUT {
+
+// Random samples beyond the 16 bit range, plus the values where rounding and clamping are most likely 
+// to go wrong
+std::vector<double> CreateSamples(std::size_t sampleCount, unsigned int seed)
+{
+	std::vector<double> edgeCases{0.0, -0.0, 0.5, -0.5, 1.5, -1.5, 2.5, -2.5, 0.49999999999999994, -0.49999999999999994, 
+		32766.5, 32767.0, 32767.49, 32767.5, 32768.0, -32767.5, -32768.0, -32768.5, -32769.0, 1.0e12, -1.0e12, 
+		std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+
+	std::mt19937 generator{seed};
+	std::uniform_real_distribution<double> distribution{-40000.0, 40000.0};
+
+	std::vector<double> samples;
+	for(std::size_t i{0}; i < sampleCount; ++i)
+	{
+		samples.push_back(i < edgeCases.size() ? edgeCases[i] : distribution(generator));
+	}
+
+	return samples;
+}
+
+// Runs the check with the kernels of every tier this CPU supports
+void ForEachSupportedTier(const std::function<void()>& check)
+{
+	auto originalTier{CpuTier::GetTier()};
+
+	for(auto tier : CpuTier::GetTiers())
+	{
+		if(CpuTier::IsSupported(tier))
+		{
+			SCOPED_TRACE(CpuTier::GetTierName(tier));
+			CpuTier::SetTier(tier);
+			check();
+		}
+	}
+
+	CpuTier::SetTier(originalTier);
+}
+
+void VerifyInterleave(const std::vector<std::vector<double>>& channels, std::size_t frameCount)
+{
+	std::vector<int16_t> expected(frameCount * channels.size());
+	PcmConversion::InterleaveScalar(channels, frameCount, expected.data());
+
+	ForEachSupportedTier([&]
+	{
+		std::vector<int16_t> actual(frameCount * channels.size());
+		PcmConversion::Interleave(channels, frameCount, actual.data());
+		EXPECT_EQ(expected, actual);
+	});
+}
+
+void VerifyDeinterleave(std::size_t frameCount, std::size_t channelCount)
+{
+	std::mt19937 generator{static_cast<unsigned int>(frameCount)};
+	std::uniform_int_distribution<int> distribution{-32768, 32767};
+
+	std::vector<int16_t> input{-32768, 32767, -1, 0, 1};
+	while(input.size() < frameCount * channelCount)
+	{
+		input.push_back(static_cast<int16_t>(distribution(generator)));
+	}
+	input.resize(frameCount * channelCount);
+
+	std::vector<std::vector<double>> expected;
+	PcmConversion::DeinterleaveScalar(input.data(), frameCount, channelCount, expected);
+
+	ForEachSupportedTier([&]
+	{
+		std::vector<std::vector<double>> actual;
+		PcmConversion::Deinterleave(input.data(), frameCount, channelCount, actual);
+		EXPECT_EQ(expected, actual);
+	});
+}
+
+}
+
+TEST(PcmConversion, InterleaveMonoBitExact)
+{
+	for(std::size_t frameCount : {0, 1, 7, 8, 9, 15, 16, 17, 1001})
+	{
+		PcmConversionUT::VerifyInterleave({PcmConversionUT::CreateSamples(frameCount, 1)}, frameCount);
+	}
+}
+
+TEST(PcmConversion, InterleaveStereoBitExact)
+{
+	for(std::size_t frameCount : {0, 1, 3, 4, 5, 7, 8, 9, 1001})
+	{
+		PcmConversionUT::VerifyInterleave({PcmConversionUT::CreateSamples(frameCount, 1), PcmConversionUT::CreateSamples(frameCount, 2)}, frameCount);
+	}
+}
+
+TEST(PcmConversion, InterleaveUnevenChannelsBitExact)
+{
+	PcmConversionUT::VerifyInterleave({PcmConversionUT::CreateSamples(1001, 1), PcmConversionUT::CreateSamples(990, 2)}, 1001);
+	PcmConversionUT::VerifyInterleave({PcmConversionUT::CreateSamples(100, 1), PcmConversionUT::CreateSamples(100, 2), PcmConversionUT::CreateSamples(100, 3)}, 100);
+}
+
+TEST(PcmConversion, Rounding)
+{
+	std::vector<int16_t> output(8);
+	PcmConversion::Interleave({{0.5, -0.5, 1.5, -2.5, 40000.0, -40000.0, 0.49, -0.51}}, 8, output.data());
+	EXPECT_EQ((std::vector<int16_t>{1, -1, 2, -3, 32767, -32768, 0, -1}), output);
+}
+
+TEST(PcmConversion, DeinterleaveBitExact)
+{
+	for(std::size_t frameCount : {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 1001})
+	{
+		PcmConversionUT::VerifyDeinterleave(frameCount, 1);
+		PcmConversionUT::VerifyDeinterleave(frameCount, 2);
+		PcmConversionUT::VerifyDeinterleave(frameCount, 3);
+	}
+}
+
+TEST(PcmConversion, CpuTiers)
+{
+	EXPECT_TRUE(CpuTier::IsSupported(CpuTier::Tier::BASELINE));
+	EXPECT_TRUE(CpuTier::IsSupported(CpuTier::GetBestSupportedTier()));
+
+	for(auto tier : CpuTier::GetTiers())
+	{
+		CpuTier::Tier parsedTier;
+		EXPECT_TRUE(CpuTier::ParseTierName(CpuTier::GetTierName(tier), parsedTier));
+		EXPECT_EQ(tier, parsedTier);
+	}
+
+	CpuTier::Tier parsedTier;
+	EXPECT_FALSE(CpuTier::ParseTierName("sse4", parsedTier));
+}
+
+TEST(PcmConversion, Dither)
+{
+	const std::size_t frameCount{10000};
+	std::vector<std::vector<double>> channels{std::vector<double>(frameCount, 100.25)};
+
+	std::vector<int16_t> output(frameCount);
+	uint32_t randomState{12345};
+	PcmConversion::InterleaveWithDither(channels, frameCount, output.data(), randomState);
+
+	// Triangular dither of +/-1 LSB keeps every sample within one step and the average unbiased
+	double sum{0.0};
+	for(auto sample : output)
+	{
+		EXPECT_GE(sample, 99);
+		EXPECT_LE(sample, 102);
+		sum += sample;
+	}
+
+	EXPECT_NEAR(100.25, sum / frameCount, 0.05);
+	EXPECT_NE(12345u, randomState);
+}
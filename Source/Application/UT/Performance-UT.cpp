@@ -0,0 +1,420 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <yaml-cpp/yaml.h>
+#include <Application/PhaseVocoderMediator.h>
+#include <Application/PhaseVocoderSettings.h>
+#include <Application/AudioInput.h>
+#include <Application/AudioOutput.h>
+#include <Application/AlignedMemory.h>
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <atomic>
+#include <new>
+
+// Performance regression tests.  Each one times a fixed synthetic workload and divides its time by that 
+// of a calibration loop, so the figures carry over between machines, then compares the result against 
+// PerformanceBaseline.yaml.  A test fails when its workload costs more than the baseline by more than 
+// the tolerance (PHASEVOCODER_PERF_TOLERANCE, a fraction, 0.25 by default).
+//
+// Timings are only meaningful for release builds on an otherwise idle machine, so these are built into 
+// their own executable, PhaseVocoderPerf-UT, which isn't run with the rest of the UT.
+//
+// Setting PHASEVOCODER_PERF_RECORD to a filename writes the figures measured to it in the baseline's 
+// format, for updating PerformanceBaseline.yaml from the reference machine.  A workload the checked in 
+// baseline has no figure for is compared against its own first run on this machine instead, which is kept 
+// in PerformanceBaseline.local.yaml in the working directory (delete it to start over).
+//
+// AllocationsPerSection counts heap allocations instead of timing, through the replacement operator new 
+// and delete at the end of this file.  Being in their own executable, these only see the performance tests.
+namespace PerformanceUT {
+
+// Every heap allocation and free made by the performance tests, counted by the replacement operator new and delete below
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> frees{0};
+
+const std::size_t sampleRate{44100};
+const double pi{3.14159265358979};
+
+// Audio generated on the fly from a function of the sample position.  Every channel gets the same audio 
+// unless the generator for the second channel is given.
+class GeneratedAudioInput : public AudioInput
+{
+	public:
+		GeneratedAudioInput(std::size_t sampleCount, std::function<double(std::size_t)> generator) : 
+			sampleCount_{sampleCount}, generator_{generator} { }
+
+		GeneratedAudioInput(std::size_t sampleCount, std::function<double(std::size_t)> generator, std::function<double(std::size_t)> secondGenerator) : 
+			sampleCount_{sampleCount}, generator_{generator}, secondGenerator_{secondGenerator} { }
+
+		std::size_t GetSampleRate() override { return sampleRate; }
+		std::size_t GetChannels() override { return secondGenerator_ ? 2 : 1; }
+		std::size_t GetBitsPerSample() override { return 16; }
+		std::size_t GetSampleCount() override { return sampleCount_; }
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override
+		{
+			auto endSample{std::min(startSample + sampleCount, sampleCount_)};
+
+			const auto& generator{streamID == 1 && secondGenerator_ ? secondGenerator_ : generator_};
+
+			std::vector<double> samples;
+			for(auto i{startSample}; i < endSample; ++i)
+			{
+				samples.push_back(generator(i));
+			}
+
+			return AudioData{samples};
+		}
+
+	private:
+		std::size_t sampleCount_;
+		std::function<double(std::size_t)> generator_;
+		std::function<double(std::size_t)> secondGenerator_;
+};
+
+class DiscardingAudioOutput : public AudioOutput
+{
+	public:
+		void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) override { samplesWritten_ += audioData.size(); }
+		std::size_t GetMaxBufferedSamples() override { return 0; }
+
+		std::size_t samplesWritten_{0};
+};
+
+double Tone(std::size_t position)
+{
+	return 16000.0 * std::sin(2.0 * pi * 440.0 * static_cast<double>(position) / sampleRate);
+}
+
+// A tone with a sharp attack every attackInterval samples
+double Attacks(std::size_t position, std::size_t attackInterval)
+{
+	auto sinceAttack{static_cast<double>(position % attackInterval)};
+	return Tone(position) * std::exp(-sinceAttack / (attackInterval / 4.0));
+}
+
+// Best of a few runs, in seconds, as the fastest run is the least disturbed by anything else
+double TimeBestOf(const std::function<void()>& action, std::size_t runs)
+{
+	double bestTime{0.0};
+	for(std::size_t run{0}; run < runs; ++run)
+	{
+		auto start{std::chrono::steady_clock::now()};
+		action();
+		auto time{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+		bestTime = (run == 0) ? time : std::min(bestTime, time);
+	}
+
+	return bestTime;
+}
+
+// A fixed mix of the floating point work processing does (multiply-adds over a buffer, filtering and trig)
+double GetCalibrationTime()
+{
+	static double calibrationTime{TimeBestOf([]
+	{
+		std::vector<double> buffer(4096);
+		double sum{0.0};
+		for(std::size_t pass{0}; pass < 256; ++pass)
+		{
+			for(std::size_t i{0}; i < buffer.size(); ++i)
+			{
+				buffer[i] = buffer[i] * 0.999 + std::sin(static_cast<double>(i + pass) * 0.01);
+			}
+
+			for(std::size_t i{16}; i < buffer.size(); ++i)
+			{
+				for(std::size_t tap{0}; tap < 16; ++tap)
+				{
+					sum += buffer[i - tap] * static_cast<double>(tap + 1);
+				}
+			}
+		}
+
+		volatile double result{sum};
+		(void)result;
+	}, 5)};
+
+	return calibrationTime;
+}
+
+double GetTolerance()
+{
+	auto tolerance{std::getenv("PHASEVOCODER_PERF_TOLERANCE")};
+	return tolerance ? std::atof(tolerance) : 0.25;
+}
+
+const std::string baselineFilename{"PerformanceBaseline.yaml"};
+const std::string localBaselineFilename{"PerformanceBaseline.local.yaml"};
+
+// Zero when the file or the workload's figure isn't there
+double GetBaseline(const std::string& filename, const std::string& workloadName)
+{
+	std::ifstream baselineFile{filename};
+	if(!baselineFile)
+	{
+		return 0.0;
+	}
+
+	auto baseline{YAML::Load(baselineFile)};
+	if(!baseline.IsMap() || !baseline[workloadName])
+	{
+		return 0.0;
+	}
+
+	return baseline[workloadName].as<double>();
+}
+
+// Adds the figure to the file, keeping the figures already in it
+void WriteFigure(const std::string& filename, const std::string& workloadName, double figure)
+{
+	YAML::Node figures;
+	std::ifstream existingFile{filename};
+	if(existingFile)
+	{
+		figures = YAML::Load(existingFile);
+		existingFile.close();
+	}
+
+	figures[workloadName] = figure;
+
+	std::ofstream figuresFile{filename};
+	figuresFile << figures << std::endl;
+}
+
+void CheckAgainstBaseline(const std::string& workloadName, double figure)
+{
+	auto recordFilename{std::getenv("PHASEVOCODER_PERF_RECORD")};
+	if(recordFilename)
+	{
+		WriteFigure(recordFilename, workloadName, figure);
+	}
+
+	auto baseline{GetBaseline(baselineFilename, workloadName)};
+	if(baseline <= 0.0)
+	{
+		baseline = GetBaseline(localBaselineFilename, workloadName);
+	}
+
+	if(baseline <= 0.0)
+	{
+		WriteFigure(localBaselineFilename, workloadName, figure);
+		std::cout << workloadName << ": no baseline figure yet, so this run's is kept in " << localBaselineFilename 
+					<< " for later runs to be compared against" << std::endl;
+		return;
+	}
+
+	EXPECT_LE(figure, baseline * (1.0 + GetTolerance())) << workloadName << " is worse than its baseline of " << baseline;
+}
+
+void CheckPerformance(const std::string& workloadName, const PhaseVocoderSettings& settings, std::size_t sampleCount, 
+						std::function<double(std::size_t)> generator)
+{
+	auto workloadTime{TimeBestOf([&]
+	{
+		auto audioOutput{std::make_shared<DiscardingAudioOutput>()};
+		PhaseVocoderMediator phaseVocoderMediator(settings, std::make_shared<GeneratedAudioInput>(sampleCount, generator), 
+													std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+		phaseVocoderMediator.Process();
+
+		EXPECT_LT(0, audioOutput->samplesWritten_);
+	}, 3)};
+
+	auto normalizedCost{workloadTime / GetCalibrationTime()};
+	std::cout << workloadName << ": " << workloadTime << " seconds, normalized cost " << normalizedCost << std::endl;
+
+	CheckAgainstBaseline(workloadName, normalizedCost);
+}
+
+// Five minutes of stereo written to a wave file.  The left channel has an attack a second and the right 
+// a single long section, so the channels run at different paces and the writer queues a lot of audio.
+void CheckStereoRender(const std::string& workloadName, bool hugePages)
+{
+	const std::string outputFilename{"PerformanceStereoRender.wav"};
+	const std::size_t sampleCount{sampleRate * 300};
+
+	PhaseVocoderSettings settings;
+	settings.SetStretchFactor(1.25);
+
+	AlignedMemory::SetHugePages(hugePages);
+
+	auto workloadTime{TimeBestOf([&]
+	{
+		auto audioInput{std::make_shared<GeneratedAudioInput>(sampleCount, 
+							[](std::size_t position) { return Attacks(position, sampleRate); }, 
+							[](std::size_t position) { return position < sampleRate / 2 ? 0.0 : Tone(position); })};
+		auto audioOutput{std::make_shared<WaveFileOutput>(outputFilename, 2, sampleRate, 16, WaveFormat::SampleFormat::INTEGER)};
+
+		PhaseVocoderMediator phaseVocoderMediator(settings, audioInput, std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+		phaseVocoderMediator.Process();
+
+		EXPECT_LT(0, audioOutput->GetMaxBufferedSamples());
+	}, 3)};
+
+	AlignedMemory::SetHugePages(false);
+	std::remove(outputFilename.c_str());
+
+	auto normalizedCost{workloadTime / GetCalibrationTime()};
+	std::cout << workloadName << ": " << workloadTime << " seconds, normalized cost " << normalizedCost << std::endl;
+
+	CheckAgainstBaseline(workloadName, normalizedCost);
+}
+
+// The same stretch at each quality preset, so their figures show what the lower presets save
+void CheckQualityPreset(const std::string& workloadName, PhaseVocoderSettings::QualityPreset qualityPreset)
+{
+	PhaseVocoderSettings settings;
+	settings.SetStretchFactor(1.25);
+	settings.SetQualityPreset(qualityPreset);
+
+	CheckPerformance(workloadName, settings, sampleRate * 60, [](std::size_t position) { return Attacks(position, sampleRate); });
+}
+
+}
+
+void* operator new(std::size_t size)
+{
+	++PerformanceUT::allocations;
+
+	auto memory{std::malloc(size ? size : 1)};
+	if(!memory)
+	{
+		throw std::bad_alloc{};
+	}
+
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if(memory)
+	{
+		++PerformanceUT::frees;
+	}
+
+	std::free(memory);
+}
+
+// Twenty attacks a second, so many short sections
+TEST(Performance, DenseTransients)
+{
+	PhaseVocoderSettings settings;
+	settings.SetStretchFactor(1.5);
+
+	PerformanceUT::CheckPerformance("DenseTransients", settings, PerformanceUT::sampleRate * 20, 
+									[](std::size_t position) { return PerformanceUT::Attacks(position, PerformanceUT::sampleRate / 20); });
+}
+
+// A single attack, so one section a minute long
+TEST(Performance, LongSections)
+{
+	PhaseVocoderSettings settings;
+	settings.SetStretchFactor(1.1);
+
+	PerformanceUT::CheckPerformance("LongSections", settings, PerformanceUT::sampleRate * 60, 
+									[](std::size_t position) { return position < PerformanceUT::sampleRate / 2 ? 0.0 : PerformanceUT::Tone(position); });
+}
+
+TEST(Performance, PitchShift)
+{
+	PhaseVocoderSettings settings;
+	settings.SetPitchShiftValue(3.0);
+
+	PerformanceUT::CheckPerformance("PitchShift", settings, PerformanceUT::sampleRate * 20, 
+									[](std::size_t position) { return PerformanceUT::Attacks(position, PerformanceUT::sampleRate); });
+}
+
+TEST(Performance, ResampleOnly)
+{
+	PhaseVocoderSettings settings;
+	settings.SetResampleValue(48000);
+
+	PerformanceUT::CheckPerformance("ResampleOnly", settings, PerformanceUT::sampleRate * 60, PerformanceUT::Tone);
+}
+
+TEST(Performance, QualityHigh)
+{
+	PerformanceUT::CheckQualityPreset("QualityHigh", PhaseVocoderSettings::QualityPreset::HIGH);
+}
+
+TEST(Performance, QualityMedium)
+{
+	PerformanceUT::CheckQualityPreset("QualityMedium", PhaseVocoderSettings::QualityPreset::MEDIUM);
+}
+
+TEST(Performance, QualityDraft)
+{
+	PerformanceUT::CheckQualityPreset("QualityDraft", PhaseVocoderSettings::QualityPreset::DRAFT);
+}
+
+TEST(Performance, LongStereoRender)
+{
+	PerformanceUT::CheckStereoRender("LongStereoRender", false);
+}
+
+// Only differs from LongStereoRender where huge pages are supported
+TEST(Performance, LongStereoRenderHugePages)
+{
+	PerformanceUT::CheckStereoRender("LongStereoRenderHugePages", AlignedMemory::HugePagesSupported());
+}
+
+// Heap traffic made while rendering, per section, for the dense transients workload.  Counts don't 
+// depend on the machine, so the baseline figure is compared directly.
+TEST(Performance, AllocationsPerSection)
+{
+	PhaseVocoderSettings settings;
+	settings.SetStretchFactor(1.5);
+
+	auto audioOutput{std::make_shared<PerformanceUT::DiscardingAudioOutput>()};
+	auto audioInput{std::make_shared<PerformanceUT::GeneratedAudioInput>(PerformanceUT::sampleRate * 20, 
+							[](std::size_t position) { return PerformanceUT::Attacks(position, PerformanceUT::sampleRate / 20); })};
+	PhaseVocoderMediator phaseVocoderMediator(settings, audioInput, std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+
+	auto allocationsBefore{PerformanceUT::allocations.load()};
+	auto freesBefore{PerformanceUT::frees.load()};
+	phaseVocoderMediator.Process();
+	auto allocations{PerformanceUT::allocations.load() - allocationsBefore};
+	auto frees{PerformanceUT::frees.load() - freesBefore};
+
+	auto sections{static_cast<double>(phaseVocoderMediator.GetSectionsRendered())};
+	ASSERT_LT(0.0, sections);
+
+	std::cout << "AllocationsPerSection: " << allocations / sections << " allocations and " << frees / sections << " frees per section over " 
+				<< sections << " sections" << std::endl;
+
+	PerformanceUT::CheckAgainstBaseline("AllocationsPerSection", allocations / sections);
+}
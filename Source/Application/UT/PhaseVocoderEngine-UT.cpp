@@ -0,0 +1,165 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <cmath>
+#include <string>
+#include <limits>
+#include <functional>
+#include <Application/PhaseVocoderEngine.h>
+
+namespace PhaseVocoderEngineUT {
+
+const std::size_t sampleRate{44100};
+
+std::vector<int16_t> CreateSineWave(std::size_t frameCount, unsigned int channelCount)
+{
+	const double pi{3.14159265358979323846};
+
+	std::vector<int16_t> samples;
+	for(std::size_t frame{0}; frame < frameCount; ++frame)
+	{
+		for(unsigned int channel{0}; channel < channelCount; ++channel)
+		{
+			samples.push_back(static_cast<int16_t>(10000.0 * std::sin(2.0 * pi * 440.0 * frame / sampleRate)));
+		}
+	}
+
+	return samples;
+}
+
+PhaseVocoderEngineBuffer CreateBuffer(std::vector<int16_t>& samples, unsigned int channelCount)
+{
+	return PhaseVocoderEngineBuffer{samples.data(), samples.size() / channelCount, channelCount, sampleRate};
+}
+
+}
+
+TEST(PhaseVocoderEngine, NothingToDo)
+{
+	auto samples{PhaseVocoderEngineUT::CreateSineWave(1000, 1)};
+	auto input{PhaseVocoderEngineUT::CreateBuffer(samples, 1)};
+
+	PhaseVocoderEngineOptions options;
+	PhaseVocoderEngine_InitOptions(&options);
+
+	PhaseVocoderEngineBuffer output;
+	EXPECT_EQ(PHASEVOCODER_ENGINE_INVALID_ARGUMENT, PhaseVocoderEngine_Process(&options, &input, &output));
+	EXPECT_FALSE(std::string(PhaseVocoderEngine_GetLastError()).empty());
+}
+
+TEST(PhaseVocoderEngine, InvalidChannelCount)
+{
+	auto samples{PhaseVocoderEngineUT::CreateSineWave(1000, 3)};
+	auto input{PhaseVocoderEngineUT::CreateBuffer(samples, 3)};
+
+	PhaseVocoderEngineOptions options;
+	PhaseVocoderEngine_InitOptions(&options);
+	options.stretchFactor = 1.25;
+
+	PhaseVocoderEngineBuffer output;
+	EXPECT_EQ(PHASEVOCODER_ENGINE_INVALID_ARGUMENT, PhaseVocoderEngine_Process(&options, &input, &output));
+}
+
+TEST(PhaseVocoderEngine, UninitializedOptions)
+{
+	auto samples{PhaseVocoderEngineUT::CreateSineWave(1000, 1)};
+	auto input{PhaseVocoderEngineUT::CreateBuffer(samples, 1)};
+
+	PhaseVocoderEngineOptions options{};
+	options.stretchFactor = 1.25;
+
+	PhaseVocoderEngineBuffer output;
+	EXPECT_EQ(PHASEVOCODER_ENGINE_INVALID_ARGUMENT, PhaseVocoderEngine_Process(&options, &input, &output));
+}
+
+// The engine accepts the same settings the command line does
+TEST(PhaseVocoderEngine, SettingsOutOfRange)
+{
+	auto samples{PhaseVocoderEngineUT::CreateSineWave(1000, 1)};
+	auto input{PhaseVocoderEngineUT::CreateBuffer(samples, 1)};
+
+	auto checkRejected{[&](const std::function<void(PhaseVocoderEngineOptions&)>& setOption)
+	{
+		PhaseVocoderEngineOptions options;
+		PhaseVocoderEngine_InitOptions(&options);
+		setOption(options);
+
+		PhaseVocoderEngineBuffer output;
+		EXPECT_EQ(PHASEVOCODER_ENGINE_INVALID_ARGUMENT, PhaseVocoderEngine_Process(&options, &input, &output));
+	}};
+
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = std::numeric_limits<double>::quiet_NaN(); });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = std::numeric_limits<double>::infinity(); });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = -1.25; });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = 0.001; });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = 11.0; });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.pitchShift = std::numeric_limits<double>::quiet_NaN(); });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.pitchShift = 25.0; });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.resampleRate = 500; });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = 1.25; options.valleyToPeakRatio = -1.0; });
+	checkRejected([](PhaseVocoderEngineOptions& options) { options.stretchFactor = 1.25; options.valleyToPeakRatio = std::numeric_limits<double>::infinity(); });
+}
+
+#ifndef _DEBUG
+TEST(PhaseVocoderEngine, StretchStereo)
+{
+	auto samples{PhaseVocoderEngineUT::CreateSineWave(PhaseVocoderEngineUT::sampleRate, 2)};
+	auto input{PhaseVocoderEngineUT::CreateBuffer(samples, 2)};
+
+	PhaseVocoderEngineOptions options;
+	PhaseVocoderEngine_InitOptions(&options);
+	options.stretchFactor = 1.25;
+
+	PhaseVocoderEngineBuffer output;
+	ASSERT_EQ(PHASEVOCODER_ENGINE_OK, PhaseVocoderEngine_Process(&options, &input, &output));
+	EXPECT_EQ(2, output.channelCount);
+	EXPECT_EQ(PhaseVocoderEngineUT::sampleRate, output.sampleRate);
+	EXPECT_NEAR(PhaseVocoderEngineUT::sampleRate * 1.25, static_cast<double>(output.frameCount), PhaseVocoderEngineUT::sampleRate * 0.01);
+
+	PhaseVocoderEngine_FreeBuffer(&output);
+	EXPECT_EQ(nullptr, output.samples);
+}
+
+TEST(PhaseVocoderEngine, Resample)
+{
+	auto samples{PhaseVocoderEngineUT::CreateSineWave(PhaseVocoderEngineUT::sampleRate, 1)};
+	auto input{PhaseVocoderEngineUT::CreateBuffer(samples, 1)};
+
+	PhaseVocoderEngineOptions options;
+	PhaseVocoderEngine_InitOptions(&options);
+	options.resampleRate = 48000;
+
+	PhaseVocoderEngineBuffer output;
+	ASSERT_EQ(PHASEVOCODER_ENGINE_OK, PhaseVocoderEngine_Process(&options, &input, &output));
+	EXPECT_EQ(1, output.channelCount);
+	EXPECT_EQ(48000, output.sampleRate);
+	EXPECT_LE(47520, output.frameCount);  // The resampler's flush may add a little to the end
+
+	PhaseVocoderEngine_FreeBuffer(&output);
+}
+#endif
@@ -27,9 +27,16 @@
 #include <gtest/gtest.h>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
 #include <Application/PhaseVocoderMediator.h>
+#include <Application/PhaseVocoderProcessor.h>
 #include <Utilities/Exception.h>
 #include <Utilities/File.h>
+#include <Application/UT/ReferenceAudio.h>
 
 namespace PhaseVocoderMediatorUT {
 
@@ -44,6 +51,17 @@ void Stretch(const std::string& inputFile, const std::string& outputFile, double
 	phaseVocoderMediator.Process();
 }
 
+void MultipleStretch(const std::string& inputFile, const std::string& outputFilePattern, const std::vector<double>& stretchFactors)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetInputWaveFile(inputFile);
+	phaseVocoderSettings.SetOutputWaveFile(outputFilePattern);
+	phaseVocoderSettings.SetStretchFactors(stretchFactors);
+
+	PhaseVocoderMediator phaseVocoderMediator(phaseVocoderSettings);
+	phaseVocoderMediator.Process();
+}
+
 void Resample(const std::string& inputFile, const std::string& outputFile, std::size_t newSampleRate)
 {
 	PhaseVocoderSettings phaseVocoderSettings;
@@ -85,50 +103,66 @@ std::vector<std::size_t> SpecificValleyToPeakRatio(const std::string& inputFile,
 TEST(PhaseVocoderMediator, StretchTest1)
 {
 	PhaseVocoderMediatorUT::Stretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResult1.25.wav", 1.25);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrev1.25.wav", "BuiltToSpillBeatAbbrevCurrentResult1.25.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev1.25.wav", "BuiltToSpillBeatAbbrevCurrentResult1.25.wav"));
 }
 
 TEST(PhaseVocoderMediator, StretchTest2)
 {
 	PhaseVocoderMediatorUT::Stretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResult1.50.wav", 1.50);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrev1.50.wav", "BuiltToSpillBeatAbbrevCurrentResult1.50.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev1.50.wav", "BuiltToSpillBeatAbbrevCurrentResult1.50.wav"));
 }
 
 TEST(PhaseVocoderMediator, StretchTest3)
 {
 	PhaseVocoderMediatorUT::Stretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResult1.75.wav", 1.75);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrev1.75.wav", "BuiltToSpillBeatAbbrev1.75.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev1.75.wav", "BuiltToSpillBeatAbbrev1.75.wav"));
 }
 
 TEST(PhaseVocoderMediator, CompressTest1)
 {
 	PhaseVocoderMediatorUT::Stretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResult0.75.wav", 0.75);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrev0.75.wav", "BuiltToSpillBeatAbbrevCurrentResult0.75.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev0.75.wav", "BuiltToSpillBeatAbbrevCurrentResult0.75.wav"));
 }
 
 TEST(PhaseVocoderMediator, CompressTest2)
 {
 	PhaseVocoderMediatorUT::Stretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResult0.50.wav", 0.50);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrev0.50.wav", "BuiltToSpillBeatAbbrevCurrentResult0.50.wav" ));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev0.50.wav", "BuiltToSpillBeatAbbrevCurrentResult0.50.wav" ));
 }
 
 TEST(PhaseVocoderMediator, CompressTest3)
 {
 	PhaseVocoderMediatorUT::Stretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResult0.25.wav", 0.25);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrev0.25.wav", "BuiltToSpillBeatAbbrevCurrentResult0.25.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev0.25.wav", "BuiltToSpillBeatAbbrevCurrentResult0.25.wav"));
+}
+
+// Rendering several stretch factors from one pass must give the same results as rendering each one separately
+TEST(PhaseVocoderMediator, MultipleStretchTest)
+{
+	PhaseVocoderMediatorUT::MultipleStretch("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentMultiResult%s.wav", std::vector<double>{0.75, 1.25, 1.5});
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev0.75.wav", "BuiltToSpillBeatAbbrevCurrentMultiResult0.75.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev1.25.wav", "BuiltToSpillBeatAbbrevCurrentMultiResult1.25.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrev1.50.wav", "BuiltToSpillBeatAbbrevCurrentMultiResult1.5.wav"));
 }
 #endif
 
+TEST(PhaseVocoderMediator, OutputFilenameForStretchFactor)
+{
+	EXPECT_STREQ("Out_0.9.wav", PhaseVocoderMediator::GetOutputFilenameForStretchFactor("Out_%s.wav", 0.9).c_str());
+	EXPECT_STREQ("Out_1.05.wav", PhaseVocoderMediator::GetOutputFilenameForStretchFactor("Out_%s.wav", 1.05).c_str());
+	EXPECT_THROW(PhaseVocoderMediator::GetOutputFilenameForStretchFactor("Out.wav", 1.05), Utilities::Exception);
+}
+
 TEST(PhaseVocoderMediator, ResampleTest1)
 {
 	PhaseVocoderMediatorUT::Resample("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResample48000.wav", 48000);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrevResample48000.wav", "BuiltToSpillBeatAbbrevCurrentResample48000.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrevResample48000.wav", "BuiltToSpillBeatAbbrevCurrentResample48000.wav"));
 }
 
 TEST(PhaseVocoderMediator, ResampleTest2)
 {
 	PhaseVocoderMediatorUT::Resample("BuiltToSpillBeatAbbrev.wav", "BuiltToSpillBeatAbbrevCurrentResample32123.wav", 32123);
-	EXPECT_EQ(true, Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrevResample32123.wav", "BuiltToSpillBeatAbbrevCurrentResample32123.wav"));
+	EXPECT_TRUE(ReferenceAudio::MatchesReference("BuiltToSpillBeatAbbrevResample32123.wav", "BuiltToSpillBeatAbbrevCurrentResample32123.wav"));
 }
 
 
@@ -249,4 +283,509 @@ TEST(TransientDetectorTests, SpecifcTransientRatioRelaxed)
 	}
 }
 
+// Generates a tone on the fly, so inputs hours long take no memory.  The tone starts after half a second 
+// of silence and fades out and back in every twenty seconds, with no sharp attacks after the first.  Every 
+// channel gets the same tone.
+class SyntheticAudioInput : public AudioInput
+{
+	public:
+		SyntheticAudioInput(std::size_t sampleCount, std::size_t channels = 1) : sampleCount_{sampleCount}, channels_{channels} { }
+
+		std::size_t GetSampleRate() override { return 44100; }
+		std::size_t GetChannels() override { return channels_; }
+		std::size_t GetBitsPerSample() override { return 16; }
+		std::size_t GetSampleCount() override { return sampleCount_; }
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override
+		{
+			const double pi{3.14159265358979};
+			auto endSample{std::min(startSample + sampleCount, sampleCount_)};
+
+			std::vector<double> samples;
+			for(auto i{startSample}; i < endSample; ++i)
+			{
+				auto seconds{static_cast<double>(i) / 44100.0};
+				auto envelope{seconds < 0.5 ? 0.0 : std::abs(std::cos(pi * seconds / 20.0))};
+				samples.push_back(16000.0 * envelope * std::sin(2.0 * pi * 440.0 * seconds));
+			}
+
+			return AudioData{samples};
+		}
+
+	private:
+		std::size_t sampleCount_;
+		std::size_t channels_;
+};
+
+// Discards its audio, counting it and noting the resident set size as it goes
+class CountingAudioOutput : public AudioOutput
+{
+	public:
+		void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) override
+		{
+			samplesWritten_ += audioData.size();
+			if(samplesWritten_ >= nextCheck_)
+			{
+				auto residentSetSize{GetResidentSetSize()};
+				if(samplesWritten_ <= warmUpSamples_)
+				{
+					warmUpResidentSetSize_ = std::max(warmUpResidentSetSize_, residentSetSize);
+				}
+
+				maxResidentSetSize_ = std::max(maxResidentSetSize_, residentSetSize);
+				nextCheck_ += checkInterval_;
+			}
+		}
+
+		std::size_t GetMaxBufferedSamples() override { return 0; }
+
+		// In bytes.  Zero where it can't be found.
+		static std::size_t GetResidentSetSize()
+		{
+			std::size_t residentPages{0};
+			std::ifstream statm{"/proc/self/statm"};
+			statm >> residentPages >> residentPages;
+			return residentPages * 4096;
+		}
+
+		std::size_t samplesWritten_{0};
+		std::size_t warmUpSamples_{0};
+		std::size_t warmUpResidentSetSize_{0};
+		std::size_t maxResidentSetSize_{0};
+
+	private:
+		const std::size_t checkInterval_{44100 * 10};
+		std::size_t nextCheck_{0};
+};
+
+std::shared_ptr<CountingAudioOutput> StretchSyntheticInput(std::size_t sampleCount, double stretchFactor, std::size_t maxMemory, 
+															std::size_t& maxSectionLength, std::size_t& sectionsRendered)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactor(stretchFactor);
+	phaseVocoderSettings.SetMaxMemory(maxMemory);
+
+	auto audioOutput{std::make_shared<CountingAudioOutput>()};
+	audioOutput->warmUpSamples_ = static_cast<std::size_t>(44100 * 3600 * stretchFactor);
+
+	PhaseVocoderMediator phaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(sampleCount), 
+												std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+	phaseVocoderMediator.Process();
+
+	maxSectionLength = phaseVocoderMediator.GetMaxSectionLength();
+	sectionsRendered = phaseVocoderMediator.GetSectionsRendered();
+
+	return audioOutput;
+}
+
+TEST(PhaseVocoderMediator, MemoryBudgetTooSmall)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactors(std::vector<double>{8.0, 9.0, 10.0});
+	phaseVocoderSettings.SetMaxMemory(1);
+
+	EXPECT_THROW(PhaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(44100), 
+										std::vector<std::shared_ptr<AudioOutput>>(3)), Utilities::Exception);
+}
+
+#ifndef _DEBUG
+// A minute with a single attack is one long section, which a 32MB budget has split into several
+TEST(PhaseVocoderMediator, MemoryBudgetSplitsSections)
+{
+	std::size_t sampleCount{44100 * 60};
+	std::size_t maxSectionLength{0};
+	std::size_t sectionsRendered{0};
+
+	auto audioOutput{PhaseVocoderMediatorUT::StretchSyntheticInput(sampleCount, 1.1, 32, maxSectionLength, sectionsRendered)};
+
+	EXPECT_LT(0, maxSectionLength);
+	EXPECT_LE((sampleCount - 22050) / maxSectionLength, sectionsRendered);
+	EXPECT_NEAR(sampleCount * 1.1, static_cast<double>(audioOutput->samplesWritten_), 44100.0);
+}
+#endif
+
+#ifndef _DEBUG
+// The callback is called along the way and once more at the end, when all the input has been consumed
+TEST(PhaseVocoderMediator, ProgressCallback)
+{
+	std::size_t sampleCount{44100 * 30};
+
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactor(1.5);
+	phaseVocoderSettings.SetMaxMemory(32);
+
+	auto audioOutput{std::make_shared<CountingAudioOutput>()};
+	PhaseVocoderMediator phaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(sampleCount), 
+												std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+
+	std::vector<Progress> reports;
+	phaseVocoderMediator.SetProgressCallback([&](const Progress& progress) { reports.push_back(progress); }, 0.0);
+	phaseVocoderMediator.Process();
+
+	ASSERT_LT(2, reports.size());
+	for(std::size_t i{1}; i < reports.size(); ++i)
+	{
+		EXPECT_LE(reports[i - 1].streams_[0].samplesConsumed_, reports[i].streams_[0].samplesConsumed_);
+		EXPECT_LE(reports[i - 1].GetFractionComplete(), reports[i].GetFractionComplete());
+	}
+
+	const auto& lastReport{reports.back()};
+	EXPECT_TRUE(lastReport.finished_);
+	EXPECT_TRUE(lastReport.streams_[0].finished_);
+	EXPECT_EQ(sampleCount, lastReport.streams_[0].samplesToConsume_);
+	EXPECT_EQ(sampleCount, lastReport.streams_[0].samplesConsumed_);
+	EXPECT_EQ(audioOutput->samplesWritten_, lastReport.streams_[0].samplesProduced_);
+	EXPECT_EQ(phaseVocoderMediator.GetSectionsRendered(), lastReport.streams_[0].sectionCount_);
+	EXPECT_EQ(lastReport.streams_[0].sectionCount_, lastReport.streams_[0].currentSection_);
+	EXPECT_DOUBLE_EQ(1.0, lastReport.GetFractionComplete());
+}
+#endif
+
+// Short 1kHz bursts every 40ms, each an attack of its own
+class ClickTrackAudioInput : public AudioInput
+{
+	public:
+		ClickTrackAudioInput(std::size_t sampleCount) : sampleCount_{sampleCount} { }
+
+		std::size_t GetSampleRate() override { return 44100; }
+		std::size_t GetChannels() override { return 1; }
+		std::size_t GetBitsPerSample() override { return 16; }
+		std::size_t GetSampleCount() override { return sampleCount_; }
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override
+		{
+			const double pi{3.14159265358979};
+			const std::size_t clickInterval{1764};
+			const std::size_t clickLength{441};
+			auto endSample{std::min(startSample + sampleCount, sampleCount_)};
+
+			std::vector<double> samples;
+			for(auto i{startSample}; i < endSample; ++i)
+			{
+				auto clickPosition{i % clickInterval};
+				auto envelope{clickPosition < clickLength ? 1.0 - static_cast<double>(clickPosition) / clickLength : 0.0};
+				samples.push_back(16000.0 * envelope * std::sin(2.0 * pi * 1000.0 * static_cast<double>(i) / 44100.0));
+			}
+
+			return AudioData{samples};
+		}
+
+	private:
+		std::size_t sampleCount_;
+};
+
+std::unique_ptr<PhaseVocoderMediator> StretchClickTrack(PhaseVocoderSettings phaseVocoderSettings)
+{
+	phaseVocoderSettings.SetStretchFactor(1.2);
+
+	auto phaseVocoderMediator{std::make_unique<PhaseVocoderMediator>(phaseVocoderSettings, std::make_shared<ClickTrackAudioInput>(44100 * 5), 
+																		std::vector<std::shared_ptr<AudioOutput>>{std::make_shared<CountingAudioOutput>()})};
+	phaseVocoderMediator->Process();
+
+	return phaseVocoderMediator;
+}
+
+#ifndef _DEBUG
+// Every merged section is one fewer rendered, and none are merged unless asked for
+TEST(PhaseVocoderMediator, MinSectionLengthMergesSections)
+{
+	auto unmerged{PhaseVocoderMediatorUT::StretchClickTrack(PhaseVocoderSettings{})};
+	EXPECT_EQ(0, unmerged->GetSectionsMerged());
+	EXPECT_DOUBLE_EQ(0.0, unmerged->GetMergeTimeSaved());
+
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetMinSectionLength(100);
+	auto merged{PhaseVocoderMediatorUT::StretchClickTrack(phaseVocoderSettings)};
+
+	EXPECT_LT(0, merged->GetSectionsMerged());
+	EXPECT_LT(merged->GetSectionsRendered(), unmerged->GetSectionsRendered());
+	EXPECT_EQ(unmerged->GetSectionsRendered(), merged->GetSectionsRendered() + merged->GetSectionsMerged());
+	EXPECT_LE(0.0, merged->GetMergeTimeSaved());
+}
+#endif
+
+void WriteTransientConfigFile(const std::string& filename, const std::vector<std::size_t>& transients)
+{
+	std::ofstream transientConfigFile{filename};
+	transientConfigFile << "transients : [";
+	for(std::size_t i{0}; i < transients.size(); ++i)
+	{
+		transientConfigFile << (i ? ", " : "") << transients[i];
+	}
+	transientConfigFile << "]" << std::endl;
+}
+
+PhaseVocoderSettings IncrementalRenderSettings(const std::string& outputFile, bool incremental)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetInputWaveFile("BuiltToSpillBeatAbbrev.wav");
+	phaseVocoderSettings.SetOutputWaveFile(outputFile);
+	phaseVocoderSettings.SetStretchFactor(1.25);
+	phaseVocoderSettings.SetTransientConfigFilename("IncrementalRenderTransients.yaml");
+	if(incremental)
+	{
+		phaseVocoderSettings.SetIncrementalRender();
+	}
+
+	return phaseVocoderSettings;
+}
+
+#ifndef _DEBUG
+// Moving one transient re-renders the sections either side of it and the one after those (its predecessor 
+// changed).  The rest are copied from the previous render and the result matches a full render.
+TEST(PhaseVocoderMediator, IncrementalRenderMatchesFullRender)
+{
+	const std::string outputFile{"BuiltToSpillBeatAbbrevCurrentIncremental.wav"};
+	std::remove(outputFile.c_str());
+	std::remove(PhaseVocoderMediator::GetRenderManifestFilename(outputFile).c_str());
+
+	PhaseVocoderMediatorUT::WriteTransientConfigFile("IncrementalRenderTransients.yaml", std::vector<std::size_t>{8000, 20000, 32000, 44000, 56000});
+	{
+		PhaseVocoderMediator phaseVocoderMediator(PhaseVocoderMediatorUT::IncrementalRenderSettings(outputFile, true));
+		phaseVocoderMediator.Process();
+		EXPECT_EQ(5, phaseVocoderMediator.GetSectionsRendered());
+		EXPECT_EQ(0, phaseVocoderMediator.GetSectionsReused());
+	}
+
+	PhaseVocoderMediatorUT::WriteTransientConfigFile("IncrementalRenderTransients.yaml", std::vector<std::size_t>{8000, 20000, 30000, 44000, 56000});
+	{
+		PhaseVocoderMediator phaseVocoderMediator(PhaseVocoderMediatorUT::IncrementalRenderSettings(outputFile, true));
+		phaseVocoderMediator.Process();
+		EXPECT_EQ(3, phaseVocoderMediator.GetSectionsRendered());
+		EXPECT_EQ(2, phaseVocoderMediator.GetSectionsReused());
+	}
+
+	PhaseVocoderMediator(PhaseVocoderMediatorUT::IncrementalRenderSettings("BuiltToSpillBeatAbbrevCurrentFull.wav", false)).Process();
+
+	EXPECT_TRUE(Utilities::File::CheckIfFilesMatch("BuiltToSpillBeatAbbrevCurrentFull.wav", outputFile));
+	EXPECT_FALSE(std::ifstream(outputFile + ".partial").good());
+}
+
+// A render that doesn't finish leaves the previous output and manifest as they were
+TEST(PhaseVocoderMediator, UnfinishedIncrementalRenderKeepsPreviousOutput)
+{
+	const std::string outputFile{"BuiltToSpillBeatAbbrevCurrentUnfinished.wav"};
+	const std::string previousOutputFile{"BuiltToSpillBeatAbbrevCurrentUnfinishedPrevious.wav"};
+	std::remove(outputFile.c_str());
+	std::remove(PhaseVocoderMediator::GetRenderManifestFilename(outputFile).c_str());
+
+	PhaseVocoderMediatorUT::WriteTransientConfigFile("IncrementalRenderTransients.yaml", std::vector<std::size_t>{8000, 20000, 32000, 44000, 56000});
+	PhaseVocoderMediator(PhaseVocoderMediatorUT::IncrementalRenderSettings(outputFile, true)).Process();
+	PhaseVocoderMediator(PhaseVocoderMediatorUT::IncrementalRenderSettings(previousOutputFile, false)).Process();
+
+	PhaseVocoderMediatorUT::WriteTransientConfigFile("IncrementalRenderTransients.yaml", std::vector<std::size_t>{8000, 20000, 30000, 44000, 56000});
+	{
+		PhaseVocoderMediator phaseVocoderMediator(PhaseVocoderMediatorUT::IncrementalRenderSettings(outputFile, true));
+	}
+
+	EXPECT_TRUE(Utilities::File::CheckIfFilesMatch(previousOutputFile, outputFile));
+	EXPECT_TRUE(std::ifstream(PhaseVocoderMediator::GetRenderManifestFilename(outputFile)).good());
+	EXPECT_FALSE(std::ifstream(outputFile + ".partial").good());
+}
+#endif
+
+// Keeps everything written to the first stream
+class CollectingAudioOutput : public AudioOutput
+{
+	public:
+		void WriteAudioStream(std::size_t streamID, const std::vector<double>& audioData) override
+		{
+			if(streamID == 0)
+			{
+				samples_.insert(samples_.end(), audioData.begin(), audioData.end());
+			}
+		}
+
+		std::size_t GetMaxBufferedSamples() override { return 0; }
+
+		std::vector<double> samples_;
+};
+
+TEST(PhaseVocoderProcessor, RenderRangeStartPastEndOfInput)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactor(1.2);
+	phaseVocoderSettings.SetRangeStart(44100 * 2, false);
+
+	PhaseVocoderProcessor processor(0, phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(44100), 
+									std::make_shared<CountingAudioOutput>());
+	EXPECT_THROW(processor.Process(), Utilities::Exception);
+}
+
+// The start is in seconds and the end in samples, so only the input can tell they're the wrong way 
+// around.  It's caught before the channel threads start.
+TEST(PhaseVocoderMediator, RenderRangeStartAfterEnd)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactor(1.2);
+	phaseVocoderSettings.SetRangeStart(0.5, true);
+	phaseVocoderSettings.SetRangeEnd(11025, false);
+
+	auto audioOutput{std::make_shared<CountingAudioOutput>()};
+	PhaseVocoderMediator phaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(44100, 2), 
+												std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+	EXPECT_THROW(phaseVocoderMediator.Process(), Utilities::Exception);
+	EXPECT_EQ(0, audioOutput->samplesWritten_);
+}
+
+#ifndef _DEBUG
+// The range from 0.25 to 1.25 seconds, stretched by 1.2, is 1.2 seconds long.  The tone starts at half a 
+// second so the first 0.3 seconds of the output is silent and the tone follows.
+TEST(PhaseVocoderMediator, RenderRangeOutputsExactlyTheStretchedRegion)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactor(1.2);
+	phaseVocoderSettings.SetRangeStart(0.25, true);
+	phaseVocoderSettings.SetRangeEnd(55125, false);
+
+	auto audioOutput{std::make_shared<CollectingAudioOutput>()};
+	PhaseVocoderMediator phaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(44100 * 3), 
+												std::vector<std::shared_ptr<AudioOutput>>{audioOutput});
+	phaseVocoderMediator.Process();
+
+	const auto& samples{audioOutput->samples_};
+	ASSERT_EQ(52920, samples.size());
+
+	// A window's worth of slack either side of where the tone comes in
+	const std::size_t toneStart{13230};
+	const std::size_t slack{1024};
+	auto largest{[&](std::size_t begin, std::size_t end)
+	{
+		double largestSample{0.0};
+		for(auto i{begin}; i < end; ++i)
+		{
+			largestSample = std::max(largestSample, std::abs(samples[i]));
+		}
+		return largestSample;
+	}};
+
+	EXPECT_GT(1.0, largest(0, toneStart - slack));
+	EXPECT_LT(1000.0, largest(toneStart + slack, toneStart + 2 * slack));
+	EXPECT_LT(1000.0, largest(samples.size() - slack, samples.size()));
+}
+#endif
+
+#ifndef _DEBUG
+// The extra outputs are rendered on their own worker threads, which must give exactly what rendering each 
+// stretch factor on its own does
+TEST(PhaseVocoderMediator, MultipleStretchFactorsMatchSeparateRenders)
+{
+	const std::vector<double> stretchFactors{0.8, 1.3, 1.7};
+
+	auto render{[](const std::vector<double>& stretchFactors)
+	{
+		PhaseVocoderSettings phaseVocoderSettings;
+		phaseVocoderSettings.SetStretchFactors(stretchFactors);
+
+		std::vector<std::shared_ptr<CollectingAudioOutput>> audioOutputs;
+		for(std::size_t i{0}; i < stretchFactors.size(); ++i)
+		{
+			audioOutputs.push_back(std::make_shared<CollectingAudioOutput>());
+		}
+
+		PhaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(44100 * 3), 
+								std::vector<std::shared_ptr<AudioOutput>>(audioOutputs.begin(), audioOutputs.end())).Process();
+
+		std::vector<std::vector<double>> renders;
+		for(const auto& audioOutput : audioOutputs)
+		{
+			renders.push_back(audioOutput->samples_);
+		}
+
+		return renders;
+	}};
+
+	auto together{render(stretchFactors)};
+	ASSERT_EQ(stretchFactors.size(), together.size());
+	for(std::size_t i{0}; i < stretchFactors.size(); ++i)
+	{
+		auto alone{render({stretchFactors[i]})};
+		EXPECT_FALSE(together[i].empty());
+		EXPECT_EQ(alone[0], together[i]);
+	}
+}
+#endif
+
+std::vector<double> StretchWithQualityPreset(PhaseVocoderSettings::QualityPreset qualityPreset)
+{
+	PhaseVocoderSettings phaseVocoderSettings;
+	phaseVocoderSettings.SetStretchFactor(1.5);
+	phaseVocoderSettings.SetQualityPreset(qualityPreset);
+
+	auto audioOutput{std::make_shared<CollectingAudioOutput>()};
+	PhaseVocoderMediator(phaseVocoderSettings, std::make_shared<SyntheticAudioInput>(44100 * 3), 
+							std::vector<std::shared_ptr<AudioOutput>>{audioOutput}).Process();
+
+	return audioOutput->samples_;
+}
+
+double RootMeanSquare(const std::vector<double>& samples)
+{
+	double sumOfSquares{0.0};
+	for(auto sample : samples)
+	{
+		sumOfSquares += sample * sample;
+	}
+
+	return std::sqrt(sumOfSquares / samples.size());
+}
+
+std::size_t CountZeroCrossings(const std::vector<double>& samples)
+{
+	std::size_t zeroCrossings{0};
+	for(std::size_t i{1}; i < samples.size(); ++i)
+	{
+		if(samples[i - 1] * samples[i] < 0.0)
+		{
+			++zeroCrossings;
+		}
+	}
+
+	return zeroCrossings;
+}
+
+// The lower presets lose bandwidth, but the 440 Hz tone is well within what they keep, so their output 
+// should be about as long, as loud and at the same pitch as the high quality render.  The length may be 
+// off by a window at the draft preset's rate once brought back up to the output rate.
+void CheckQualityPresetAgainstHighQuality(PhaseVocoderSettings::QualityPreset qualityPreset)
+{
+	auto highQuality{StretchWithQualityPreset(PhaseVocoderSettings::QualityPreset::HIGH)};
+	auto lowerQuality{StretchWithQualityPreset(qualityPreset)};
+
+	ASSERT_FALSE(highQuality.empty());
+	EXPECT_NEAR(static_cast<double>(highQuality.size()), static_cast<double>(lowerQuality.size()), 4096.0);
+	EXPECT_NEAR(RootMeanSquare(highQuality), RootMeanSquare(lowerQuality), RootMeanSquare(highQuality) * 0.25);
+	EXPECT_NEAR(static_cast<double>(CountZeroCrossings(highQuality)), static_cast<double>(CountZeroCrossings(lowerQuality)), 
+				CountZeroCrossings(highQuality) * 0.05);
+}
+
+#ifndef _DEBUG
+TEST(PhaseVocoderMediator, MediumQualityPreset)
+{
+	CheckQualityPresetAgainstHighQuality(PhaseVocoderSettings::QualityPreset::MEDIUM);
+}
+
+TEST(PhaseVocoderMediator, DraftQualityPreset)
+{
+	CheckQualityPresetAgainstHighQuality(PhaseVocoderSettings::QualityPreset::DRAFT);
+}
+#endif
+
+// Soak test.  Stretches six hours of audio within a 256MB budget and checks memory use after the first 
+// hour stays flat.  Takes a long time so it only runs when disabled tests are asked for 
+// (--gtest_also_run_disabled_tests).
+TEST(PhaseVocoderMediator, DISABLED_MemoryBudgetSoak)
+{
+	std::size_t sampleCount{44100ull * 3600 * 6};
+	std::size_t maxSectionLength{0};
+	std::size_t sectionsRendered{0};
+
+	auto audioOutput{PhaseVocoderMediatorUT::StretchSyntheticInput(sampleCount, 1.1, 256, maxSectionLength, sectionsRendered)};
+
+	EXPECT_NEAR(sampleCount * 1.1, static_cast<double>(audioOutput->samplesWritten_), 44100.0);
+
+	// 16MB of slack for allocator fragmentation
+	EXPECT_LE(audioOutput->maxResidentSetSize_, audioOutput->warmUpResidentSetSize_ + 16 * 1024 * 1024);
+}
+
 }
@@ -0,0 +1,160 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <Application/PrefetchingAudioInput.h>
+#include <Utilities/Exception.h>
+
+namespace PrefetchingAudioInputUT {
+
+std::shared_ptr<AudioBufferInput> CreateAudioInput(std::size_t sampleCount)
+{
+	std::vector<double> left;
+	std::vector<double> right;
+	for(std::size_t i{0}; i < sampleCount; ++i)
+	{
+		left.push_back(static_cast<double>(i));
+		right.push_back(-static_cast<double>(i));
+	}
+
+	return std::make_shared<AudioBufferInput>(std::vector<std::vector<double>>{left, right}, 44100, 16);
+}
+
+// Fails every read reaching past the given sample, like a file on a disk that's gone away
+class FailingAudioInput : public AudioBufferInput
+{
+	public:
+		FailingAudioInput(const std::vector<std::vector<double>>& channels, std::size_t failingSample) : 
+			AudioBufferInput{channels, 44100, 16}, failingSample_{failingSample} { }
+
+		AudioData ReadAudioStream(std::size_t streamID, std::size_t startSample, std::size_t sampleCount) override
+		{
+			if(startSample + sampleCount > failingSample_)
+			{
+				Utilities::ThrowException("Read failed", startSample);
+			}
+
+			return AudioBufferInput::ReadAudioStream(streamID, startSample, sampleCount);
+		}
+
+	private:
+		std::size_t failingSample_;
+};
+
+// Reads the whole stream in chunks of the given size, checking every sample
+void VerifySequentialRead(PrefetchingAudioInput& audioInput, std::size_t streamID, std::size_t chunkSize)
+{
+	auto sign{streamID == 0 ? 1.0 : -1.0};
+
+	std::size_t position{0};
+	while(position < audioInput.GetSampleCount())
+	{
+		auto audioData{audioInput.ReadAudioStream(streamID, position, chunkSize)};
+		ASSERT_EQ(std::min(chunkSize, audioInput.GetSampleCount() - position), audioData.GetSize());
+
+		for(std::size_t i{0}; i < audioData.GetSize(); ++i)
+		{
+			ASSERT_EQ(sign * static_cast<double>(position + i), audioData.GetData()[i]);
+		}
+
+		position += audioData.GetSize();
+	}
+}
+
+}
+
+TEST(PrefetchingAudioInput, Properties)
+{
+	PrefetchingAudioInput audioInput(PrefetchingAudioInputUT::CreateAudioInput(1000), 4, 100);
+	EXPECT_EQ(44100, audioInput.GetSampleRate());
+	EXPECT_EQ(2, audioInput.GetChannels());
+	EXPECT_EQ(16, audioInput.GetBitsPerSample());
+	EXPECT_EQ(1000, audioInput.GetSampleCount());
+}
+
+TEST(PrefetchingAudioInput, ReadsMatchAcrossBlockBoundaries)
+{
+	PrefetchingAudioInput audioInput(PrefetchingAudioInputUT::CreateAudioInput(10007), 4, 256);
+	PrefetchingAudioInputUT::VerifySequentialRead(audioInput, 0, 100);
+	PrefetchingAudioInputUT::VerifySequentialRead(audioInput, 0, 1000);  // A second pass from the start
+	PrefetchingAudioInputUT::VerifySequentialRead(audioInput, 1, 333);
+}
+
+TEST(PrefetchingAudioInput, ReadsPastEnd)
+{
+	PrefetchingAudioInput audioInput(PrefetchingAudioInputUT::CreateAudioInput(1000), 4, 256);
+	EXPECT_EQ(100, audioInput.ReadAudioStream(0, 900, 500).GetSize());
+	EXPECT_EQ(0, audioInput.ReadAudioStream(0, 1000, 500).GetSize());
+	EXPECT_THROW(audioInput.ReadAudioStream(2, 0, 100), Utilities::Exception);
+}
+
+TEST(PrefetchingAudioInput, ConcurrentStreams)
+{
+	PrefetchingAudioInput audioInput(PrefetchingAudioInputUT::CreateAudioInput(100000), 8, 512);
+
+	std::thread leftThread([&]{ PrefetchingAudioInputUT::VerifySequentialRead(audioInput, 0, 700); });
+	std::thread rightThread([&]{ PrefetchingAudioInputUT::VerifySequentialRead(audioInput, 1, 900); });
+
+	leftThread.join();
+	rightThread.join();
+}
+
+// Going back to the start for a second pass drops the blocks read ahead of where the stream was, 
+// leaving only those read ahead of the start
+TEST(PrefetchingAudioInput, ReadAheadDroppedOnSecondPass)
+{
+	auto memoryAccounting{std::make_shared<MemoryAccounting>()};
+	PrefetchingAudioInput audioInput(PrefetchingAudioInputUT::CreateAudioInput(1000), 4, 100);
+	audioInput.SetMemoryAccounting(memoryAccounting);
+
+	audioInput.ReadAudioStream(0, 500, 100);
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_EQ(400 * sizeof(double), memoryAccounting->GetUsage(MemoryAccounting::Stage::READER, 0).current_);
+
+	audioInput.ReadAudioStream(0, 0, 100);
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_EQ(400 * sizeof(double), memoryAccounting->GetUsage(MemoryAccounting::Stage::READER, 0).current_);
+
+	PrefetchingAudioInputUT::VerifySequentialRead(audioInput, 0, 100);
+}
+
+// The third block fails to read.  It's given time to fail on the read ahead thread, and the failure 
+// comes out of the read reaching it.
+TEST(PrefetchingAudioInput, ReadAheadFailureRethrown)
+{
+	auto failingAudioInput{std::make_shared<PrefetchingAudioInputUT::FailingAudioInput>(std::vector<std::vector<double>>{std::vector<double>(1000)}, 512)};
+	PrefetchingAudioInput audioInput(failingAudioInput, 4, 256);
+
+	EXPECT_EQ(256, audioInput.ReadAudioStream(0, 0, 256).GetSize());
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	EXPECT_EQ(256, audioInput.ReadAudioStream(0, 256, 256).GetSize());
+	EXPECT_THROW(audioInput.ReadAudioStream(0, 512, 256), Utilities::Exception);
+}
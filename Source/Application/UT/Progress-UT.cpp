@@ -0,0 +1,109 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Application/Progress.h>
+
+namespace ProgressUT {
+
+TEST(Progress, ReportsConsumedAndProduced)
+{
+	std::vector<Progress> reports;
+	ProgressTracker progressTracker(2, 44100, [&](const Progress& progress) { reports.push_back(progress); }, 0.0);
+
+	progressTracker.SetSamplesToConsume(0, 1000, 4);
+	progressTracker.SetSamplesToConsume(1, 1000, 2);
+	progressTracker.SectionStarted(0, 2);
+	progressTracker.SamplesConsumed(0, 500);
+	progressTracker.SamplesProduced(0, 750);
+	progressTracker.SamplesConsumed(1, 250);
+
+	ASSERT_EQ(4, reports.size());
+	const auto& progress{reports.back()};
+	EXPECT_EQ(3, progress.streams_[0].currentSection_);
+	EXPECT_EQ(4, progress.streams_[0].sectionCount_);
+	EXPECT_EQ(500, progress.streams_[0].samplesConsumed_);
+	EXPECT_EQ(750, progress.streams_[0].samplesProduced_);
+	EXPECT_EQ(250, progress.streams_[1].samplesConsumed_);
+	EXPECT_DOUBLE_EQ(0.375, progress.GetFractionComplete());
+	EXPECT_FALSE(progress.finished_);
+}
+
+TEST(Progress, ReportInterval)
+{
+	std::size_t reportCount{0};
+	ProgressTracker progressTracker(1, 44100, [&](const Progress&) { ++reportCount; }, 3600.0);
+
+	progressTracker.SetSamplesToConsume(0, 1000, 1);
+	for(std::size_t i{0}; i < 10; ++i)
+	{
+		progressTracker.SamplesConsumed(0, 100);
+	}
+
+	EXPECT_EQ(0, reportCount);
+
+	// Finishing always reports
+	progressTracker.Finish();
+	EXPECT_EQ(1, reportCount);
+	EXPECT_TRUE(progressTracker.GetProgress().finished_);
+	EXPECT_DOUBLE_EQ(1.0, progressTracker.GetProgress().GetFractionComplete());
+}
+
+TEST(Progress, EstimatedSecondsRemaining)
+{
+	Progress progress;
+	progress.streams_.resize(1);
+	progress.streams_[0].samplesToConsume_ = 1000;
+	progress.streams_[0].samplesConsumed_ = 250;
+	progress.elapsedSeconds_ = 10.0;
+
+	EXPECT_DOUBLE_EQ(30.0, progress.GetEstimatedSecondsRemaining());
+}
+
+TEST(Progress, WriteStatus)
+{
+	Progress progress;
+	progress.streams_.resize(1);
+	progress.streams_[0].samplesToConsume_ = 1000;
+	progress.streams_[0].samplesConsumed_ = 500;
+	progress.streams_[0].samplesProduced_ = 600;
+	progress.streams_[0].currentSection_ = 2;
+	progress.streams_[0].sectionCount_ = 3;
+	progress.elapsedSeconds_ = 4;
+	progress.realtimeFactor_ = 5;
+
+	std::ostringstream status;
+	progress.WriteStatus(status);
+
+	EXPECT_STREQ("{\"state\": \"running\", \"elapsedSeconds\": 4, \"fractionComplete\": 0.5, \"realtimeFactor\": 5, \"secondsRemaining\": 4, "
+					"\"streams\": [{\"stream\": 0, \"samplesToConsume\": 1000, \"samplesConsumed\": 500, \"samplesProduced\": 600, "
+					"\"section\": 2, \"sectionCount\": 3, \"finished\": false}]}\n", status.str().c_str());
+}
+
+}
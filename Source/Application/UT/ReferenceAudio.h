@@ -0,0 +1,86 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <Application/AudioInput.h>
+#include <Utilities/File.h>
+
+namespace ReferenceAudio {
+
+// The largest difference, in 16 bit sample values, allowed from a reference file in FAST_MATH builds.  16 
+// in 32768 keeps the error of fast math more than 66 dB below full scale.  It's a requirement on the 
+// build rather than a measured figure, so a FAST_MATH build that drifts further fails the UT.
+const double fastMathTolerance{16.0};
+
+// Compares the output of a test against the reference file it should match.  Normal builds must match 
+// it bit for bit.  FAST_MATH builds compile AudioLib's Signal library with fast math so they can't, and 
+// instead the samples must stay within fastMathTolerance of the reference.  The largest difference goes 
+// in the failure message, and is recorded as a test property (see --gtest_output=xml) when it passes.
+inline ::testing::AssertionResult MatchesReference(const std::string& referenceFile, const std::string& resultFile)
+{
+#ifndef FAST_MATH
+	if(!Utilities::File::CheckIfFilesMatch(referenceFile, resultFile))
+	{
+		return ::testing::AssertionFailure() << resultFile << " doesn't match " << referenceFile;
+	}
+
+	return ::testing::AssertionSuccess();
+#else
+	WaveFileInput reference{referenceFile};
+	WaveFileInput result{resultFile};
+	if(reference.GetChannels() != result.GetChannels() || reference.GetSampleCount() != result.GetSampleCount())
+	{
+		return ::testing::AssertionFailure() << resultFile << " doesn't have the channels and length of " << referenceFile;
+	}
+
+	double largestDifference{0.0};
+	for(std::size_t channel{0}; channel < reference.GetChannels(); ++channel)
+	{
+		auto referenceAudio{reference.ReadAudioStream(channel, 0, reference.GetSampleCount())};
+		auto resultAudio{result.ReadAudioStream(channel, 0, result.GetSampleCount())};
+		for(std::size_t i{0}; i < referenceAudio.GetSize(); ++i)
+		{
+			largestDifference = std::max(largestDifference, std::abs(referenceAudio.GetData()[i] - resultAudio.GetData()[i]));
+		}
+	}
+
+	if(largestDifference > fastMathTolerance)
+	{
+		return ::testing::AssertionFailure() << resultFile << " differs from " << referenceFile << " by up to " 
+			<< largestDifference << ", more than the tolerance of " << fastMathTolerance;
+	}
+
+	::testing::Test::RecordProperty("LargestDifferenceFrom" + referenceFile, std::to_string(largestDifference));
+	return ::testing::AssertionSuccess();
+#endif
+}
+
+}
@@ -0,0 +1,116 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <Application/RenderManifest.h>
+#include <Utilities/Exception.h>
+
+namespace RenderManifestUT {
+
+RenderManifest::Section CreateSection(std::size_t start, std::size_t end, std::size_t outputOffset, std::size_t outputLength)
+{
+	RenderManifest::Section section;
+	section.start_ = start;
+	section.end_ = end;
+	section.outputOffset_ = outputOffset;
+	section.outputLength_ = outputLength;
+	section.crossfadeTail_ = std::vector<double>{0.1, -0.25, 1.0 / 3.0};
+
+	return section;
+}
+
+RenderManifest CreateManifest()
+{
+	RenderManifest renderManifest(2, RenderManifest::HashString("Settings"));
+
+	renderManifest.AddSection(0, CreateSection(0, 100, 0, 125));
+	renderManifest.AddSection(0, CreateSection(100, 300, 125, 250));
+	renderManifest.AddSection(0, CreateSection(300, 400, 375, 125));
+	renderManifest.AddSection(1, CreateSection(50, 400, 62, 438));
+
+	return renderManifest;
+}
+
+TEST(RenderManifest, TestNonExistantFile)
+{
+	EXPECT_THROW(RenderManifest("InvalidFilename"), Utilities::Exception);
+}
+
+TEST(RenderManifest, TestSaveAndLoad)
+{
+	CreateManifest().Save("RenderManifest.manifest");
+
+	RenderManifest renderManifest("RenderManifest.manifest");
+	EXPECT_EQ(RenderManifest::HashString("Settings"), renderManifest.GetSettingsHash());
+	EXPECT_EQ(2, renderManifest.GetStreamCount());
+	EXPECT_EQ(3, renderManifest.GetSections(0).size());
+	EXPECT_EQ(1, renderManifest.GetSections(1).size());
+
+	if(renderManifest.GetSections(0).size() == 3)
+	{
+		const auto& section{renderManifest.GetSections(0)[1]};
+		EXPECT_EQ(100, section.start_);
+		EXPECT_EQ(300, section.end_);
+		EXPECT_EQ(125, section.outputOffset_);
+		EXPECT_EQ(250, section.outputLength_);
+
+		// The crossfade tail must round trip exactly
+		EXPECT_EQ(std::vector<double>({0.1, -0.25, 1.0 / 3.0}), section.crossfadeTail_);
+	}
+}
+
+TEST(RenderManifest, TestFindReusableSection)
+{
+	auto renderManifest{CreateManifest()};
+
+	auto section{renderManifest.FindReusableSection(0, 100, 300, true, 0)};
+	ASSERT_NE(nullptr, section);
+	EXPECT_EQ(125, section->outputOffset_);
+
+	EXPECT_NE(nullptr, renderManifest.FindReusableSection(0, 0, 100, false, 0));
+	EXPECT_NE(nullptr, renderManifest.FindReusableSection(1, 50, 400, false, 0));
+}
+
+TEST(RenderManifest, TestChangedSectionsNotReusable)
+{
+	auto renderManifest{CreateManifest()};
+
+	// Different bounds
+	EXPECT_EQ(nullptr, renderManifest.FindReusableSection(0, 100, 250, true, 0));
+	EXPECT_EQ(nullptr, renderManifest.FindReusableSection(0, 150, 300, true, 100));
+
+	// Same bounds, but the preceding section changed so its crossfade tail would differ
+	EXPECT_EQ(nullptr, renderManifest.FindReusableSection(0, 300, 400, true, 200));
+	EXPECT_EQ(nullptr, renderManifest.FindReusableSection(0, 0, 100, true, 0));
+	EXPECT_EQ(nullptr, renderManifest.FindReusableSection(0, 100, 300, false, 0));
+
+	// Unknown stream
+	EXPECT_EQ(nullptr, renderManifest.FindReusableSection(2, 0, 100, false, 0));
+}
+
+}
@@ -0,0 +1,124 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <Application/Trace.h>
+
+namespace TraceUT {
+
+std::string ReadTrace(const std::string& filename)
+{
+	std::ifstream traceFile{filename};
+	std::stringstream contents;
+	contents << traceFile.rdbuf();
+	std::remove(filename.c_str());
+
+	return contents.str();
+}
+
+std::size_t CountOccurrences(const std::string& text, const std::string& pattern)
+{
+	std::size_t count{0};
+	for(auto position{text.find(pattern)}; position != std::string::npos; position = text.find(pattern, position + 1))
+	{
+		++count;
+	}
+
+	return count;
+}
+
+TEST(Trace, NothingRecordedWhenStopped)
+{
+	Trace::Start();
+	Trace::Stop();
+
+	{
+		TraceSpan span{"NotRecorded", "test", 0};
+	}
+
+	Trace::Write("TraceStopped.json");
+	auto trace{ReadTrace("TraceStopped.json")};
+
+	EXPECT_EQ(0, CountOccurrences(trace, "NotRecorded"));
+}
+
+TEST(Trace, SpansFromEachThread)
+{
+	Trace::Start();
+
+	{
+		TraceSpan span{"MainSpan", "test", 0, "startSample", 44100};
+	}
+
+	std::thread thread([]
+	{
+		Trace::SetThreadName("Worker Thread");
+		TraceSpan span{"WorkerSpan", "test", 1};
+	});
+	thread.join();
+
+	Trace::Stop();
+	Trace::Write("TraceThreads.json");
+	auto trace{ReadTrace("TraceThreads.json")};
+
+	EXPECT_EQ(1, CountOccurrences(trace, "\"name\": \"MainSpan\""));
+	EXPECT_EQ(1, CountOccurrences(trace, "\"name\": \"WorkerSpan\""));
+	EXPECT_EQ(1, CountOccurrences(trace, "\"stream\": 0, \"startSample\": 44100"));
+	EXPECT_EQ(1, CountOccurrences(trace, "\"stream\": 1}"));
+	EXPECT_EQ(1, CountOccurrences(trace, "\"name\": \"Worker Thread\""));
+
+	// The worker's events are on a track of its own
+	auto mainThread{trace.substr(trace.find("\"tid\"", trace.find("MainSpan")), 10)};
+	auto workerThread{trace.substr(trace.find("\"tid\"", trace.find("WorkerSpan")), 10)};
+	EXPECT_NE(mainThread, workerThread);
+}
+
+TEST(Trace, StartClearsPreviousEvents)
+{
+	Trace::Start();
+	{
+		TraceSpan span{"FirstRun", "test"};
+	}
+
+	Trace::Start();
+	{
+		TraceSpan span{"SecondRun", "test"};
+	}
+	Trace::Stop();
+
+	Trace::Write("TraceRestarted.json");
+	auto trace{ReadTrace("TraceRestarted.json")};
+
+	EXPECT_EQ(0, CountOccurrences(trace, "FirstRun"));
+	EXPECT_EQ(1, CountOccurrences(trace, "SecondRun"));
+}
+
+}
@@ -0,0 +1,158 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <Application/TransientCache.h>
+#include <Utilities/Exception.h>
+
+// Entries are written to the working directory, so every test removes the ones it made
+void RemoveEntry(const TransientCache& transientCache, std::size_t streamID, double valleyToPeakRatio)
+{
+	std::remove(transientCache.GetEntryFilename(streamID, valleyToPeakRatio).c_str());
+}
+
+TEST(TransientCache, TestNonExistantInputFile)
+{
+	EXPECT_THROW(TransientCache(".", "InvalidFilename"), Utilities::Exception);
+}
+
+TEST(TransientCache, TestSameContentSameHash)
+{
+	EXPECT_EQ(TransientCache::HashFile("TransientConfigFile.yaml"), TransientCache::HashFile("TransientConfigFile.yaml"));
+	EXPECT_NE(TransientCache::HashFile("TransientConfigFile.yaml"), TransientCache::HashFile("ChannelSpecificTransientConfigFile.yaml"));
+}
+
+// Files whose length isn't a whole number of words, differing only in the last byte or a high bit
+TEST(TransientCache, TestHashCoversEveryByte)
+{
+	auto WriteFile = [](const std::string& filename, const std::string& content)
+	{
+		std::ofstream(filename, std::ios::binary) << content;
+		return TransientCache::HashFile(filename);
+	};
+
+	auto hash{WriteFile("HashTest.bin", "0123456789abc")};
+	EXPECT_NE(hash, WriteFile("HashTest.bin", "0123456789abd"));
+	EXPECT_NE(hash, WriteFile("HashTest.bin", "0123456\xb7" "89abc"));
+	EXPECT_NE(hash, WriteFile("HashTest.bin", "0123456789ab"));
+	EXPECT_EQ(hash, WriteFile("HashTest.bin", "0123456789abc"));
+
+	std::remove("HashTest.bin");
+}
+
+// A hash taken once can be shared, so the file isn't read again
+TEST(TransientCache, TestGivenHash)
+{
+	TransientCache transientCache(".", "TransientConfigFile.yaml");
+	TransientCache givenHashTransientCache(".", TransientCache::HashFile("TransientConfigFile.yaml"));
+	EXPECT_EQ(transientCache.GetInputHash(), givenHashTransientCache.GetInputHash());
+	EXPECT_EQ(transientCache.GetEntryFilename(1, 1.5), givenHashTransientCache.GetEntryFilename(1, 1.5));
+}
+
+TEST(TransientCache, TestStoreAndLoad)
+{
+	TransientCache transientCache(".", "TransientConfigFile.yaml");
+
+	std::vector<std::size_t> transientsToStore{0, 28288, 56416, 84032};
+	transientCache.Store(0, 1.5, transientsToStore);
+
+	std::vector<std::size_t> loadedTransients;
+	EXPECT_TRUE(transientCache.Load(0, 1.5, loadedTransients));
+	EXPECT_EQ(transientsToStore, loadedTransients);
+
+	RemoveEntry(transientCache, 0, 1.5);
+}
+
+TEST(TransientCache, TestNoTransientsStoreAndLoad)
+{
+	TransientCache transientCache(".", "TransientConfigFile.yaml");
+
+	transientCache.Store(0, 1.25, std::vector<std::size_t>{});
+
+	std::vector<std::size_t> loadedTransients{1, 2, 3};
+	EXPECT_TRUE(transientCache.Load(0, 1.25, loadedTransients));
+	EXPECT_EQ(0, loadedTransients.size());
+
+	RemoveEntry(transientCache, 0, 1.25);
+}
+
+TEST(TransientCache, TestDifferentParametersMiss)
+{
+	TransientCache transientCache(".", "TransientConfigFile.yaml");
+	transientCache.Store(0, 1.5, std::vector<std::size_t>{0, 100, 200});
+
+	std::vector<std::size_t> loadedTransients;
+	EXPECT_FALSE(transientCache.Load(1, 1.5, loadedTransients));
+	EXPECT_FALSE(transientCache.Load(0, 1.75, loadedTransients));
+
+	TransientCache otherInputTransientCache(".", "ChannelSpecificTransientConfigFile.yaml");
+	EXPECT_FALSE(otherInputTransientCache.Load(0, 1.5, loadedTransients));
+
+	RemoveEntry(transientCache, 0, 1.5);
+}
+
+// Cutting the entry short drops the last position, and a count no file could hold is never allocated
+TEST(TransientCache, TestCorruptEntryMisses)
+{
+	TransientCache transientCache(".", "TransientConfigFile.yaml");
+	auto entryFilename{transientCache.GetEntryFilename(0, 1.5)};
+
+	transientCache.Store(0, 1.5, std::vector<std::size_t>{0, 100, 200});
+	std::string entry;
+	{
+		std::ifstream file(entryFilename, std::ios::binary);
+		entry.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	std::vector<std::size_t> loadedTransients;
+
+	{
+		std::ofstream file(entryFilename, std::ios::binary | std::ios::trunc);
+		file.write(entry.data(), static_cast<std::streamsize>(entry.size() - sizeof(uint64_t)));
+	}
+	EXPECT_FALSE(transientCache.Load(0, 1.5, loadedTransients));
+
+	{
+		std::string corruptEntry{entry};
+		uint64_t hugeCount{0x0FFFFFFFFFFFFFFFULL};
+		corruptEntry.replace(2 * sizeof(uint32_t), sizeof(hugeCount), reinterpret_cast<const char*>(&hugeCount), sizeof(hugeCount));
+
+		std::ofstream file(entryFilename, std::ios::binary | std::ios::trunc);
+		file.write(corruptEntry.data(), static_cast<std::streamsize>(corruptEntry.size()));
+	}
+	EXPECT_FALSE(transientCache.Load(0, 1.5, loadedTransients));
+
+	transientCache.Store(0, 1.5, std::vector<std::size_t>{0, 100, 200});
+	EXPECT_TRUE(transientCache.Load(0, 1.5, loadedTransients));
+	EXPECT_EQ((std::vector<std::size_t>{0, 100, 200}), loadedTransients);
+
+	RemoveEntry(transientCache, 0, 1.5);
+}
@@ -0,0 +1,331 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <Application/AudioInput.h>
+#include <Application/AudioOutput.h>
+#include <Application/WaveFormat.h>
+#include <Utilities/Exception.h>
+
+namespace WaveFileUT {
+
+const std::string testFilename{"WaveFileUT.wav"};
+
+// Values every format can hold exactly: 24 bit keeps 8 fractional bits, 32 bit 16 and floats more
+std::vector<std::vector<double>> CreateChannels(std::size_t channelCount, std::size_t sampleCount)
+{
+	std::vector<std::vector<double>> channels(channelCount);
+	for(std::size_t channel{0}; channel < channelCount; ++channel)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i)
+		{
+			auto value{static_cast<double>((i * 37 + channel * 1001) % 65536) - 32768.0};
+			channels[channel].push_back(value);
+		}
+	}
+
+	return channels;
+}
+
+void WriteWaveFile(const std::vector<std::vector<double>>& channels, std::size_t bitsPerSample, 
+					WaveFormat::SampleFormat sampleFormat, bool alwaysRF64 = false)
+{
+	WaveFileOutput waveFileOutput{testFilename, channels.size(), 48000, bitsPerSample, sampleFormat, alwaysRF64};
+	for(std::size_t streamID{0}; streamID < channels.size(); ++streamID)
+	{
+		waveFileOutput.WriteAudioStream(streamID, channels[streamID]);
+	}
+}
+
+void VerifyRoundTrip(std::size_t channelCount, std::size_t bitsPerSample, WaveFormat::SampleFormat sampleFormat, bool alwaysRF64 = false)
+{
+	auto channels{CreateChannels(channelCount, 1001)};
+	WriteWaveFile(channels, bitsPerSample, sampleFormat, alwaysRF64);
+
+	auto waveFormat{WaveFormat::Read(testFilename)};
+	EXPECT_EQ(sampleFormat, waveFormat.sampleFormat_);
+	EXPECT_EQ(channelCount, waveFormat.channels_);
+	EXPECT_EQ(48000, waveFormat.sampleRate_);
+	EXPECT_EQ(bitsPerSample, waveFormat.bitsPerSample_);
+	EXPECT_EQ(alwaysRF64, waveFormat.rf64_);
+
+	WaveFileInput waveFileInput{testFilename};
+	ASSERT_EQ(channelCount, waveFileInput.GetChannels());
+	ASSERT_EQ(1001, waveFileInput.GetSampleCount());
+
+	auto audioData{waveFileInput.ReadAudio(0, 1001)};
+	for(std::size_t streamID{0}; streamID < channelCount; ++streamID)
+	{
+		EXPECT_EQ(channels[streamID], audioData[streamID].GetData());
+		EXPECT_EQ(std::vector<double>(channels[streamID].begin() + 500, channels[streamID].begin() + 600), 
+					waveFileInput.ReadAudioStream(streamID, 500, 100).GetData());
+	}
+
+	std::remove(testFilename.c_str());
+}
+
+TEST(WaveFileTests, RoundTrip16Bit)
+{
+	VerifyRoundTrip(2, 16, WaveFormat::SampleFormat::INTEGER);
+}
+
+TEST(WaveFileTests, RoundTrip24Bit)
+{
+	VerifyRoundTrip(1, 24, WaveFormat::SampleFormat::INTEGER);
+	VerifyRoundTrip(2, 24, WaveFormat::SampleFormat::INTEGER);
+}
+
+TEST(WaveFileTests, RoundTrip32Bit)
+{
+	VerifyRoundTrip(2, 32, WaveFormat::SampleFormat::INTEGER);
+}
+
+TEST(WaveFileTests, RoundTripFloat)
+{
+	VerifyRoundTrip(2, 32, WaveFormat::SampleFormat::FLOATING_POINT);
+	VerifyRoundTrip(2, 64, WaveFormat::SampleFormat::FLOATING_POINT);
+}
+
+TEST(WaveFileTests, RoundTripMultichannel)
+{
+	VerifyRoundTrip(6, 24, WaveFormat::SampleFormat::INTEGER);
+}
+
+TEST(WaveFileTests, RoundTripRF64)
+{
+	VerifyRoundTrip(2, 24, WaveFormat::SampleFormat::INTEGER, true);
+}
+
+TEST(WaveFileTests, HigherResolutionKept)
+{
+	std::vector<std::vector<double>> channels{{0.5, -0.25, 100.75, -32768.0, 32767.0}};
+	WriteWaveFile(channels, 24, WaveFormat::SampleFormat::INTEGER);
+
+	WaveFileInput waveFileInput{testFilename};
+	EXPECT_EQ(channels[0], waveFileInput.ReadAudioStream(0, 0, 5).GetData());
+
+	std::remove(testFilename.c_str());
+}
+
+TEST(WaveFileTests, IntegerSamplesClamped)
+{
+	std::vector<std::vector<double>> channels{{40000.0, -40000.0, 1.4, -1.5}};
+	WriteWaveFile(channels, 16, WaveFormat::SampleFormat::INTEGER);
+
+	WaveFileInput waveFileInput{testFilename};
+	EXPECT_EQ((std::vector<double>{32767.0, -32768.0, 1.0, -2.0}), waveFileInput.ReadAudioStream(0, 0, 4).GetData());
+
+	std::remove(testFilename.c_str());
+}
+
+// All of one stream arrives before the other, so it's all buffered until the other stream catches up
+TEST(WaveFileTests, StreamsWrittenOutOfOrder)
+{
+	auto channels{CreateChannels(2, 1000)};
+
+	{
+		WaveFileOutput waveFileOutput{testFilename, 2, 48000, 24, WaveFormat::SampleFormat::INTEGER};
+		waveFileOutput.WriteAudioStream(1, channels[1]);
+		for(std::size_t i{0}; i < 1000; i += 100)
+		{
+			waveFileOutput.WriteAudioStream(0, std::vector<double>(channels[0].begin() + i, channels[0].begin() + i + 100));
+		}
+
+		EXPECT_EQ(1000, waveFileOutput.GetMaxBufferedSamples());
+	}
+
+	WaveFileInput waveFileInput{testFilename};
+	auto audioData{waveFileInput.ReadAudio(0, 1000)};
+	EXPECT_EQ(channels[0], audioData[0].GetData());
+	EXPECT_EQ(channels[1], audioData[1].GetData());
+
+	std::remove(testFilename.c_str());
+}
+
+// The stream ahead is written out a few frames at a time as the other catches up, then the rest of it is 
+// written against silence when the file is finished
+TEST(WaveFileTests, StreamAheadWrittenInSmallSteps)
+{
+	auto channels{CreateChannels(2, 1000)};
+
+	{
+		WaveFileOutput waveFileOutput{testFilename, 2, 48000, 24, WaveFormat::SampleFormat::INTEGER};
+		waveFileOutput.WriteAudioStream(0, channels[0]);
+		for(std::size_t i{0}; i < 301; i += 7)
+		{
+			waveFileOutput.WriteAudioStream(1, std::vector<double>(channels[1].begin() + i, channels[1].begin() + i + 7));
+		}
+	}
+
+	auto expectedSecondStream{std::vector<double>(channels[1].begin(), channels[1].begin() + 301)};
+	expectedSecondStream.resize(1000, 0.0);
+
+	WaveFileInput waveFileInput{testFilename};
+	ASSERT_EQ(1000, waveFileInput.GetSampleCount());
+	auto audioData{waveFileInput.ReadAudio(0, 1000)};
+	EXPECT_EQ(channels[0], audioData[0].GetData());
+	EXPECT_EQ(expectedSecondStream, audioData[1].GetData());
+
+	std::remove(testFilename.c_str());
+}
+
+// A stream too far ahead of the other waits for it, until the other stream finishes
+TEST(WaveFileTests, BufferLimit)
+{
+	{
+		WaveFileOutput waveFileOutput{testFilename, 2, 48000, 16, WaveFormat::SampleFormat::INTEGER};
+		waveFileOutput.SetBufferLimit(1000);
+
+		std::atomic<std::size_t> writesDone{0};
+		std::thread aheadStream([&]
+		{
+			for(std::size_t i{0}; i < 4; ++i)
+			{
+				waveFileOutput.WriteAudioStream(0, std::vector<double>(600, 1.0));
+				++writesDone;
+			}
+		});
+
+		// The second write leaves 1200 samples buffered, so it can't return yet
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		EXPECT_EQ(1, writesDone);
+
+		waveFileOutput.WriteAudioStream(1, std::vector<double>(1200, 2.0));
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		EXPECT_EQ(3, writesDone);
+
+		waveFileOutput.FinishStream(1);
+		aheadStream.join();
+
+		EXPECT_EQ(4, writesDone);
+		EXPECT_EQ(1200, waveFileOutput.GetMaxBufferedSamples());
+	}
+
+	WaveFileInput waveFileInput{testFilename};
+	EXPECT_EQ(2400, waveFileInput.GetSampleCount());
+
+	std::remove(testFilename.c_str());
+}
+
+TEST(WaveFileTests, ShortStreamPaddedWithSilence)
+{
+	WriteWaveFile({{1.0, 2.0, 3.0}, {4.0}}, 24, WaveFormat::SampleFormat::INTEGER);
+
+	WaveFileInput waveFileInput{testFilename};
+	ASSERT_EQ(3, waveFileInput.GetSampleCount());
+	EXPECT_EQ((std::vector<double>{4.0, 0.0, 0.0}), waveFileInput.ReadAudioStream(1, 0, 3).GetData());
+
+	std::remove(testFilename.c_str());
+}
+
+TEST(WaveFileTests, ReadPastEnd)
+{
+	WriteWaveFile(CreateChannels(2, 100), 32, WaveFormat::SampleFormat::FLOATING_POINT);
+
+	WaveFileInput waveFileInput{testFilename};
+	EXPECT_EQ(50, waveFileInput.ReadAudioStream(0, 50, 100).GetSize());
+	EXPECT_EQ(0, waveFileInput.ReadAudioStream(0, 200, 100).GetSize());
+
+	std::remove(testFilename.c_str());
+}
+
+// Rewrites the test file as its first byteCount bytes with the data chunk size set to dataSize
+void RewriteTestFile(std::size_t byteCount, uint32_t dataSize)
+{
+	auto dataOffset{WaveFormat::Read(testFilename).dataOffset_};
+
+	std::string contents;
+	{
+		std::ifstream file{testFilename, std::ios::binary};
+		contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	for(std::size_t i{0}; i < 4; ++i)
+	{
+		contents[static_cast<std::size_t>(dataOffset) - 4 + i] = static_cast<char>((dataSize >> (8 * i)) & 0xFF);
+	}
+
+	std::ofstream file{testFilename, std::ios::binary | std::ios::trunc};
+	file.write(contents.data(), static_cast<std::streamsize>(std::min(byteCount, contents.size())));
+}
+
+// A file cut off part way through its data gives just the whole frames it holds
+TEST(WaveFileTests, TruncatedFile)
+{
+	auto channels{CreateChannels(2, 1000)};
+	WriteWaveFile(channels, 16, WaveFormat::SampleFormat::INTEGER);
+	RewriteTestFile(static_cast<std::size_t>(WaveFormat::Read(testFilename).dataOffset_) + 400 * 4 + 2, 1000 * 4);
+
+	WaveFileInput waveFileInput{testFilename};
+	ASSERT_EQ(400, waveFileInput.GetSampleCount());
+	EXPECT_EQ(std::vector<double>(channels[1].begin(), channels[1].begin() + 400), waveFileInput.ReadAudioStream(1, 0, 1000).GetData());
+
+	std::remove(testFilename.c_str());
+}
+
+// Streaming writers leave the data size at 0 or 0xFFFFFFFF.  Either way the data runs to the end of the file.
+TEST(WaveFileTests, DataSizePlaceholders)
+{
+	WriteWaveFile(CreateChannels(2, 1000), 24, WaveFormat::SampleFormat::INTEGER);
+	RewriteTestFile(std::string::npos, 0);
+	EXPECT_EQ(1000, WaveFileInput{testFilename}.GetSampleCount());
+
+	RewriteTestFile(std::string::npos, 0xFFFFFFFF);
+	EXPECT_EQ(1000, WaveFileInput{testFilename}.GetSampleCount());
+
+	std::remove(testFilename.c_str());
+}
+
+TEST(WaveFileTests, NotAWaveFile)
+{
+	{
+		std::ofstream file{testFilename};
+		file << "This is not a wave file";
+	}
+
+	EXPECT_THROW(WaveFormat::Read(testFilename), Utilities::Exception);
+	EXPECT_THROW(WaveFileInput{testFilename}, Utilities::Exception);
+
+	std::remove(testFilename.c_str());
+}
+
+TEST(WaveFileTests, UnsupportedBitsPerSample)
+{
+	EXPECT_THROW(WaveFileOutput(testFilename, 2, 48000, 8, WaveFormat::SampleFormat::INTEGER), Utilities::Exception);
+	EXPECT_THROW(WaveFileOutput(testFilename, 2, 48000, 16, WaveFormat::SampleFormat::FLOATING_POINT), Utilities::Exception);
+	std::remove(testFilename.c_str());
+}
+
+}
@@ -53,18 +53,34 @@ void DisplaySimpleUsage()
 	std::cout << "   --version         (-v): Show version info" << std::endl;
 	std::cout << "   --input           (-i): The input wave file you want to process" << std::endl;
 	std::cout << "   --output          (-o): The resulting output wave filename" << std::endl;
-	std::cout << "   --stretch         (-s): The stretch/compress ratio" << std::endl;
+	std::cout << "   --stretch         (-s): The stretch/compress ratio (or a comma separated list)" << std::endl;
 	std::cout << "   --pitch           (-p): Pitch adjustment in semitones" << std::endl;
 	std::cout << "   --resample        (-r): Set the sample rate of the output" << std::endl;
+	std::cout << "   --start           (-b): Start of the range to render (samples, or seconds with s)" << std::endl;
+	std::cout << "   --end             (-e): End of the range to render (samples, or seconds with s)" << std::endl;
+	std::cout << "   --quality         (-q): Quality preset: high (default), medium or draft" << std::endl;
 	std::cout << "   --peakvalleyratio (-a): Specific transient valley-to-peak ratio" << std::endl;
 	std::cout << "   --transientconfig (-c): Use a config file for input parameters" << std::endl;
+	std::cout << "   --transientcache  (-d): Directory to cache detected transients in" << std::endl;
+	std::cout << "   --incremental     (-n): Only re-render sections changed since the last render" << std::endl;
+	std::cout << "   --prefetch        (-f): Blocks of input to read ahead on a background thread" << std::endl;
+	std::cout << "   --maxmemory       (-m): Memory budget in MB, splitting long sections to stay within it" << std::endl;
+	std::cout << "   --minsection      (-y): Minimum section length in ms.  Transients closer together are merged." << std::endl;
+	std::cout << "   --memoryreport    (-u): Write current and peak memory per stage and channel to a JSON file" << std::endl;
+	std::cout << "   --progress        (-k): Display a progress line with the current section, realtime factor and time remaining" << std::endl;
+	std::cout << "   --status          (-z): Write a line of JSON status to stderr every given number of seconds, for schedulers" << std::endl;
+	std::cout << "   --cputier         (-j): Use the baseline, avx2 or avx512 conversion kernels rather than the best the CPU supports" << std::endl;
+	std::cout << "   --hugepages       (-H): Back large sample buffers with transparent huge pages (Linux only)" << std::endl;
+	std::cout << "   --trace           (-g): Write a timeline of sections, stages and threads in Chrome trace event format" << std::endl;
 	std::cout << "   --showtransients  (-t): Display transient sample positions" << std::endl;
+	std::cout << "   --server          (-x): Run as a job server listening on the given socket" << std::endl;
+	std::cout << "   --workers         (-w): Number of job server worker threads (default 2)" << std::endl;
 	std::cout << "Usage Example: -i inputfile.wav -o outputfile.wav --stretch 1.25" << std::endl;
 }
 
 void DisplayLimitations()
 {
-	std::cout << "Limitations: Supports 16 bit uncompressed wave files only." << std::endl;
+	std::cout << "Limitations: Supports uncompressed (16/24/32 bit integer or 32/64 bit float) wave files only." << std::endl;
 }
 
 void DisplayCopyrightInfo()
@@ -103,6 +119,11 @@ void DisplayExamples()
 	std::cout << "    Change the sample rate to 88,200 Hz:" << std::endl;
 	std::cout << "    -i in.wav -o out.wav -s -r 88200" << std::endl;
 	std::cout << std::endl;
+	std::cout << "Multiple Stretch Factors Example:" << std::endl;
+	std::cout << "    Render four stretched versions of in.wav from a single pass over the input." << std::endl;
+	std::cout << "    The %s in the output filename is replaced by each stretch factor:" << std::endl;
+	std::cout << "    -i in.wav -o out_%s.wav -s 0.9,0.95,1.05,1.1" << std::endl;
+	std::cout << std::endl;
 	std::cout << "Displaying Transient Positions:" << std::endl;
 	std::cout << "    Stretch in.wav by twenty-five percent and also display the sample positions " << std::endl;
 	std::cout << "    of detected transients:" << std::endl;
@@ -112,6 +133,31 @@ void DisplayExamples()
 	std::cout << "    Stretch in.wav by ten percent using a config file of specific transient " << std::endl;
 	std::cout << "    positions:" << std::endl;
 	std::cout << "    -input in.wav -output out.wav -stretch 1.10 -transientconfig transients.cfg" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Rendering a Range of the Input:" << std::endl;
+	std::cout << "    Stretch only the audio from 60 to 90 seconds into in.wav.  Only the transient " << std::endl;
+	std::cout << "    sections overlapping the range are processed:" << std::endl;
+	std::cout << "    -input in.wav -output out.wav -stretch 1.10 -start 60s -end 90s" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Draft Quality Example:" << std::endl;
+	std::cout << "    Quickly audition a stretch of in.wav.  The medium and draft presets run the " << std::endl;
+	std::cout << "    phase vocoder at one half and one quarter of the input's sample rate:" << std::endl;
+	std::cout << "    -input in.wav -output out.wav -stretch 1.10 -quality draft" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Incremental Rendering:" << std::endl;
+	std::cout << "    Keep a manifest of rendered sections next to out.wav.  When re-run after   " << std::endl;
+	std::cout << "    editing transients.cfg, only sections whose bounds changed are re-rendered:" << std::endl;
+	std::cout << "    -input in.wav -output out.wav -stretch 1.10 -transientconfig transients.cfg -incremental" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Caching Detected Transients:" << std::endl;
+	std::cout << "    Transients detected in in.wav are saved to (and on later runs loaded from)" << std::endl;
+	std::cout << "    the given directory so re-rendering the same input skips detection:" << std::endl;
+	std::cout << "    -input in.wav -output out.wav -stretch 1.10 -transientcache /tmp/pvcache" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Job Server:" << std::endl;
+	std::cout << "    Accept jobs over a Unix domain socket rather than starting a new process for " << std::endl;
+	std::cout << "    each one.  Jobs are queued and run by four worker threads:" << std::endl;
+	std::cout << "    -server /tmp/phasevocoder.sock -workers 4" << std::endl;
 }
 
 void DisplayTransientConfigExample()
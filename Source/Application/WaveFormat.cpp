@@ -0,0 +1,315 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Application/WaveFormat.h>
+#include <Utilities/Exception.h>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+	const uint16_t formatPCM{1};
+	const uint16_t formatFloat{3};
+	const uint16_t formatExtensible{0xFFFE};
+
+	uint16_t ReadUInt16(const uint8_t* data)
+	{
+		return static_cast<uint16_t>(data[0] | (data[1] << 8));
+	}
+
+	uint32_t ReadUInt32(const uint8_t* data)
+	{
+		return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) | (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	uint64_t ReadUInt64(const uint8_t* data)
+	{
+		return static_cast<uint64_t>(ReadUInt32(data)) | (static_cast<uint64_t>(ReadUInt32(data + 4)) << 32);
+	}
+
+	// Streaming writers leave the data size at 0 or 0xFFFFFFFF and files get truncated, so the data is 
+	// limited to what's actually in the file.  A size of 0 is taken to mean the data runs to the end.
+	uint64_t ClampDataSize(std::istream& stream, uint64_t dataOffset, uint64_t dataSize)
+	{
+		stream.seekg(0, std::ios::end);
+		auto streamSize{static_cast<std::streamoff>(stream.tellg())};
+		if(streamSize < 0)
+		{
+			stream.clear();
+			return dataSize;
+		}
+
+		auto bytesAvailable{static_cast<uint64_t>(streamSize) > dataOffset ? static_cast<uint64_t>(streamSize) - dataOffset : 0};
+		if(dataSize == 0 || dataSize > bytesAvailable)
+		{
+			return bytesAvailable;
+		}
+
+		return dataSize;
+	}
+
+	double RoundAndClamp(double sample, double minimum, double maximum)
+	{
+		return std::max(minimum, std::min(maximum, std::round(sample)));
+	}
+}
+
+std::size_t WaveFormat::GetBytesPerSample() const
+{
+	return bitsPerSample_ / 8;
+}
+
+std::size_t WaveFormat::GetBytesPerFrame() const
+{
+	return GetBytesPerSample() * channels_;
+}
+
+uint64_t WaveFormat::GetFrameCount() const
+{
+	return GetBytesPerFrame() ? dataSize_ / GetBytesPerFrame() : 0;
+}
+
+bool WaveFormat::IsPlain16Bit() const
+{
+	return sampleFormat_ == SampleFormat::INTEGER && bitsPerSample_ == 16 && channels_ <= 2 && !rf64_;
+}
+
+void WaveFormat::CheckSupported(SampleFormat sampleFormat, std::size_t bitsPerSample)
+{
+	if(sampleFormat == SampleFormat::INTEGER && bitsPerSample != 16 && bitsPerSample != 24 && bitsPerSample != 32)
+	{
+		Utilities::ThrowException("Only 16, 24 and 32 bit integer wave files are supported", bitsPerSample);
+	}
+
+	if(sampleFormat == SampleFormat::FLOATING_POINT && bitsPerSample != 32 && bitsPerSample != 64)
+	{
+		Utilities::ThrowException("Only 32 and 64 bit floating point wave files are supported", bitsPerSample);
+	}
+}
+
+WaveFormat WaveFormat::Read(const std::string& filename)
+{
+	std::ifstream stream(filename, std::ios::binary);
+	if(!stream)
+	{
+		Utilities::ThrowException("Unable to open wave file", filename);
+	}
+
+	return Read(stream);
+}
+
+// Walks the chunks up to the data chunk.  For RF64 files the sizes in the RIFF and data chunk headers 
+// are placeholders, the real ones are in the ds64 chunk.
+WaveFormat WaveFormat::Read(std::istream& stream)
+{
+	uint8_t header[12];
+	if(!stream.read(reinterpret_cast<char*>(header), sizeof(header)) || 
+		(std::memcmp(header, "RIFF", 4) != 0 && std::memcmp(header, "RF64", 4) != 0) || std::memcmp(header + 8, "WAVE", 4) != 0)
+	{
+		Utilities::ThrowException("Not a wave file");
+	}
+
+	WaveFormat waveFormat;
+	waveFormat.rf64_ = std::memcmp(header, "RF64", 4) == 0;
+
+	bool formatFound{false};
+	uint64_t rf64DataSize{0};
+	uint64_t position{sizeof(header)};
+
+	while(true)
+	{
+		uint8_t chunkHeader[8];
+		if(!stream.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader)))
+		{
+			Utilities::ThrowException("Wave file has no data chunk");
+		}
+
+		uint64_t chunkSize{ReadUInt32(chunkHeader + 4)};
+		position += sizeof(chunkHeader);
+
+		if(std::memcmp(chunkHeader, "data", 4) == 0)
+		{
+			if(!formatFound)
+			{
+				Utilities::ThrowException("Wave file has no fmt chunk before its data");
+			}
+
+			waveFormat.dataOffset_ = position;
+			waveFormat.dataSize_ = (waveFormat.rf64_ && chunkSize == 0xFFFFFFFF) ? rf64DataSize : chunkSize;
+			waveFormat.dataSize_ = ClampDataSize(stream, waveFormat.dataOffset_, waveFormat.dataSize_);
+			break;
+		}
+
+		std::string chunk(static_cast<std::size_t>(std::min<uint64_t>(chunkSize, 64)), '\0');
+		if(!stream.read(&chunk[0], chunk.size()))
+		{
+			Utilities::ThrowException("Wave file is truncated");
+		}
+
+		auto chunkData{reinterpret_cast<const uint8_t*>(chunk.data())};
+
+		if(std::memcmp(chunkHeader, "fmt ", 4) == 0 && chunk.size() >= 16)
+		{
+			auto formatTag{ReadUInt16(chunkData)};
+			if(formatTag == formatExtensible && chunk.size() >= 26)
+			{
+				formatTag = ReadUInt16(chunkData + 24);  // The first two bytes of the sub-format GUID
+			}
+
+			if(formatTag != formatPCM && formatTag != formatFloat)
+			{
+				Utilities::ThrowException("Only PCM and floating point wave files are supported", formatTag);
+			}
+
+			waveFormat.sampleFormat_ = (formatTag == formatFloat) ? SampleFormat::FLOATING_POINT : SampleFormat::INTEGER;
+			waveFormat.channels_ = ReadUInt16(chunkData + 2);
+			waveFormat.sampleRate_ = ReadUInt32(chunkData + 4);
+			waveFormat.bitsPerSample_ = ReadUInt16(chunkData + 14);
+
+			CheckSupported(waveFormat.sampleFormat_, waveFormat.bitsPerSample_);
+			if(waveFormat.channels_ == 0)
+			{
+				Utilities::ThrowException("Wave file has no channels");
+			}
+
+			formatFound = true;
+		}
+		else if(std::memcmp(chunkHeader, "ds64", 4) == 0 && chunk.size() >= 16)
+		{
+			rf64DataSize = ReadUInt64(chunkData + 8);
+		}
+
+		// Chunks are padded to an even size
+		auto chunkEnd{position + chunkSize + (chunkSize & 1)};
+		stream.seekg(static_cast<std::streamoff>(chunkEnd));
+		position = chunkEnd;
+	}
+
+	return waveFormat;
+}
+
+void WaveFormat::DecodeSamples(const uint8_t* input, std::size_t sampleCount, std::size_t stride, double* output) const
+{
+	auto step{stride * GetBytesPerSample()};
+
+	if(sampleFormat_ == SampleFormat::FLOATING_POINT && bitsPerSample_ == 32)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, input += step)
+		{
+			float sample;
+			auto bits{ReadUInt32(input)};
+			std::memcpy(&sample, &bits, sizeof(sample));
+			output[i] = sample * 32768.0;
+		}
+	}
+	else if(sampleFormat_ == SampleFormat::FLOATING_POINT)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, input += step)
+		{
+			double sample;
+			auto bits{ReadUInt64(input)};
+			std::memcpy(&sample, &bits, sizeof(sample));
+			output[i] = sample * 32768.0;
+		}
+	}
+	else if(bitsPerSample_ == 16)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, input += step)
+		{
+			output[i] = static_cast<int16_t>(ReadUInt16(input));
+		}
+	}
+	else if(bitsPerSample_ == 24)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, input += step)
+		{
+			// Shifted up to the top of an int32 so the sign is extended
+			auto sample{static_cast<int32_t>((static_cast<uint32_t>(input[0]) << 8) | (static_cast<uint32_t>(input[1]) << 16) | (static_cast<uint32_t>(input[2]) << 24))};
+			output[i] = sample / 65536.0;
+		}
+	}
+	else
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, input += step)
+		{
+			output[i] = static_cast<int32_t>(ReadUInt32(input)) / 65536.0;
+		}
+	}
+}
+
+void WaveFormat::EncodeSamples(const double* input, std::size_t sampleCount, std::size_t stride, uint8_t* output) const
+{
+	auto step{stride * GetBytesPerSample()};
+
+	if(sampleFormat_ == SampleFormat::FLOATING_POINT && bitsPerSample_ == 32)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, output += step)
+		{
+			auto sample{static_cast<float>(input[i] / 32768.0)};
+			std::memcpy(output, &sample, sizeof(sample));
+		}
+	}
+	else if(sampleFormat_ == SampleFormat::FLOATING_POINT)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, output += step)
+		{
+			auto sample{input[i] / 32768.0};
+			std::memcpy(output, &sample, sizeof(sample));
+		}
+	}
+	else if(bitsPerSample_ == 16)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, output += step)
+		{
+			auto sample{static_cast<int32_t>(RoundAndClamp(input[i], -32768.0, 32767.0))};
+			output[0] = static_cast<uint8_t>(sample);
+			output[1] = static_cast<uint8_t>(sample >> 8);
+		}
+	}
+	else if(bitsPerSample_ == 24)
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, output += step)
+		{
+			auto sample{static_cast<int32_t>(RoundAndClamp(input[i] * 256.0, -8388608.0, 8388607.0))};
+			output[0] = static_cast<uint8_t>(sample);
+			output[1] = static_cast<uint8_t>(sample >> 8);
+			output[2] = static_cast<uint8_t>(sample >> 16);
+		}
+	}
+	else
+	{
+		for(std::size_t i{0}; i < sampleCount; ++i, output += step)
+		{
+			auto sample{static_cast<int64_t>(RoundAndClamp(input[i] * 65536.0, -2147483648.0, 2147483647.0))};
+			output[0] = static_cast<uint8_t>(sample);
+			output[1] = static_cast<uint8_t>(sample >> 8);
+			output[2] = static_cast<uint8_t>(sample >> 16);
+			output[3] = static_cast<uint8_t>(sample >> 24);
+		}
+	}
+}
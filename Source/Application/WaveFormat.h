@@ -0,0 +1,70 @@
+/*
+ * PhaseVocoder
+ *
+ * Copyright (c) 2017 - Terence M. Darwen - tmdarwen.com
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+
+// The format of a wave file's audio and where it lives in the file.  Handles RIFF and RF64 (for files 
+// over 4GB) wave files holding 16, 24 or 32 bit integer or 32 or 64 bit floating point samples.
+//
+// Samples are converted to and from doubles in the range of 16 bit samples (-32768.0 to 32767.0), the 
+// range the rest of the application works in, regardless of the file's sample format.  Samples with 
+// more resolution than 16 bits keep it as the fractional part.
+struct WaveFormat
+{
+	enum class SampleFormat { INTEGER, FLOATING_POINT };
+
+	SampleFormat sampleFormat_{SampleFormat::INTEGER};
+	std::size_t channels_{0};
+	std::size_t sampleRate_{0};
+	std::size_t bitsPerSample_{0};
+	bool rf64_{false};
+
+	uint64_t dataOffset_{0};  // Position of the audio data in the file
+	uint64_t dataSize_{0};    // In bytes
+
+	std::size_t GetBytesPerSample() const;
+	std::size_t GetBytesPerFrame() const;
+	uint64_t GetFrameCount() const;
+
+	// The plain 16 bit RIFF files AudioLib's ThreadSafeAudioFile reads and writes
+	bool IsPlain16Bit() const;
+
+	// Throws if the file isn't a wave file in one of the formats handled
+	static WaveFormat Read(const std::string& filename);
+	static WaveFormat Read(std::istream& stream);
+
+	static void CheckSupported(SampleFormat sampleFormat, std::size_t bitsPerSample);
+
+	// Convert between samples in the file and doubles.  Each works on a run of samples spaced "stride" 
+	// samples apart in the file data (i.e. one channel of interleaved frames).
+	void DecodeSamples(const uint8_t* input, std::size_t sampleCount, std::size_t stride, double* output) const;
+	void EncodeSamples(const double* input, std::size_t sampleCount, std::size_t stride, uint8_t* output) const;
+};